@@ -0,0 +1,119 @@
+//  Benchmark of adaptive_any_dispatcher over 16 candidate types, where the
+//  type added last is held by 9 values in 10. Compares the adaptive probe
+//  order with the order of addition (no reordering) and with a
+//  std::unordered_map from type_index to std::function.
+//
+//  Usage: adaptive_any_dispatcher [count]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/adaptive_any_dispatcher.hpp>
+#include <boost/functional/hash.hpp>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    template<int N>
+    struct tag
+    {
+        std::size_t value;
+    };
+
+    // Deterministic pseudo random numbers
+    std::size_t next(std::size_t & state)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    }
+
+    template<int... N>
+    struct candidates
+    {
+        static std::vector<boost::any> make_values(std::size_t count)
+        {
+            const boost::any all[] = { tag<N>{ static_cast<std::size_t>(N) }... };
+            const std::size_t last = sizeof...(N) - 1;
+            std::vector<boost::any> values;
+            values.reserve(count);
+            std::size_t state = 42;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::size_t n = next(state);
+                values.push_back(all[n % 10 ? last : n % last]);
+            }
+            return values;
+        }
+
+        static void add_all(boost::adaptive_any_dispatcher & dispatcher, std::size_t & sum)
+        {
+            const int added[] = { (dispatcher.add<tag<N> >([&sum](tag<N> & value) { sum += value.value; }), 0)... };
+            (void)added;
+        }
+
+        typedef std::unordered_map<
+            boost::typeindex::type_index, std::function<void(boost::any &)>, boost::hash<boost::typeindex::type_index>
+        > handler_map;
+
+        static void add_all(handler_map & handlers, std::size_t & sum)
+        {
+            const int added[] = { (handlers[boost::typeindex::type_id<tag<N> >()] = [&sum](boost::any & value) {
+                sum += boost::unsafe_any_cast<tag<N> >(&value)->value;
+            }, 0)... };
+            (void)added;
+        }
+    };
+
+    typedef candidates<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15> sixteen;
+
+    void run(const char * name, std::vector<boost::any> & values, std::size_t reorder_samples)
+    {
+        std::size_t sum = 0;
+        boost::adaptive_any_dispatcher dispatcher(16, reorder_samples);
+        sixteen::add_all(dispatcher, sum);
+        const timer t;
+        for (std::size_t i = 0; i < values.size(); ++i)
+            dispatcher.dispatch(values[i]);
+        report(name, t.seconds(), values.size(), "dispatches");
+        consume(sum);
+    }
+
+    void run_map(const char * name, std::vector<boost::any> & values)
+    {
+        std::size_t sum = 0;
+        sixteen::handler_map handlers;
+        sixteen::add_all(handlers, sum);
+        const timer t;
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            const sixteen::handler_map::iterator it = handlers.find(boost::typeindex::type_index(values[i].type()));
+            if (it != handlers.end())
+                it->second(values[i]);
+        }
+        report(name, t.seconds(), values.size(), "dispatches");
+        consume(sum);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 10000000);
+    std::printf("%u values\n", static_cast<unsigned>(count));
+
+    std::vector<boost::any> values = sixteen::make_values(count);
+    run_map("std::unordered_map of std::function", values);
+    run("order of addition", values, (std::numeric_limits<std::size_t>::max)());
+    run("adaptive order", values, 1024);
+    return 0;
+}
@@ -0,0 +1,124 @@
+//  Benchmark of the bulk algorithms of any_algorithms.hpp over a range of
+//  int, double and std::string values, against the loops they replace,
+//  with one thread and with the given number of threads.
+//
+//  Usage: any_algorithms [count] [threads]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/any_algorithms.hpp>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    // Deterministic pseudo random numbers
+    std::size_t next(std::size_t & state)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    }
+
+    std::vector<boost::any> make_values(std::size_t count)
+    {
+        std::vector<boost::any> values;
+        values.reserve(count);
+        std::size_t state = 42;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::size_t n = next(state);
+            switch (n % 3)
+            {
+            case 0: values.push_back(static_cast<int>(n % 1000000)); break;
+            case 1: values.push_back(static_cast<double>(n % 1000000) / 8); break;
+            default: values.push_back(std::to_string(n % 1000000)); break;
+            }
+        }
+        return values;
+    }
+
+    bool holds_int(const boost::any & value)
+    {
+        return boost::any_cast<int>(&value) != 0;
+    }
+
+    // What the algorithms are without any_algorithms.hpp
+    void run_loops(const std::vector<boost::any> & values, std::vector<boost::any> & copy)
+    {
+        {
+            const timer t;
+            std::map<boost::typeindex::type_index, std::size_t> counts;
+            for (std::size_t i = 0; i < values.size(); ++i)
+                ++counts[boost::typeindex::type_index(values[i].type())];
+            report("count loop", t.seconds(), values.size(), "values");
+            consume(counts.size());
+        }
+        {
+            const timer t;
+            std::vector<int> ints;
+            for (std::size_t i = 0; i < values.size(); ++i)
+                if (const int * value = boost::any_cast<int>(&values[i]))
+                    ints.push_back(*value);
+            report("extract loop", t.seconds(), values.size(), "values");
+            consume(ints.size());
+        }
+        {
+            const timer t;
+            const std::vector<boost::any>::iterator middle = std::partition(copy.begin(), copy.end(), holds_int);
+            report("std::partition", t.seconds(), values.size(), "values");
+            consume(static_cast<std::size_t>(middle - copy.begin()));
+        }
+    }
+
+    void run_algorithms(const std::vector<boost::any> & values, std::size_t threads, std::vector<boost::any> & copy)
+    {
+        std::printf("%u threads\n", static_cast<unsigned>(threads));
+        {
+            const timer t;
+            const std::size_t types = boost::anys::count_by_type(values.begin(), values.end(), threads).size();
+            report("  count_by_type", t.seconds(), values.size(), "values");
+            consume(types);
+        }
+        {
+            const timer t;
+            std::vector<int> ints;
+            boost::anys::extract<int>(values.begin(), values.end(), std::back_inserter(ints), threads);
+            report("  extract", t.seconds(), values.size(), "values");
+            consume(ints.size());
+        }
+        {
+            const timer t;
+            const std::vector<boost::any>::iterator middle
+                = boost::anys::partition_by_type<int>(copy.begin(), copy.end(), threads);
+            report("  partition_by_type", t.seconds(), values.size(), "values");
+            consume(static_cast<std::size_t>(middle - copy.begin()));
+        }
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 10000000);
+    const std::size_t threads = argument(argc, argv, 2, 4);
+    std::printf("%u values, %u hardware threads\n", static_cast<unsigned>(count), std::thread::hardware_concurrency());
+
+    // The copies to partition are made up front: destroying one would leave
+    // millions of freed holders for the next large allocation to merge.
+    const std::vector<boost::any> values = make_values(count);
+    std::vector<boost::any> copies[] = { values, values, values };
+    run_loops(values, copies[0]);
+    run_algorithms(values, 1, copies[1]);
+    run_algorithms(values, threads, copies[2]);
+    return 0;
+}
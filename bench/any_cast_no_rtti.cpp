@@ -0,0 +1,65 @@
+//  Benchmark of any_cast without RTTI, where comparing two types compares
+//  their compile time names. The held types are instances of one template,
+//  so that their names differ only in the last characters. Build with
+//  RTTI off and BOOST_NO_RTTI defined, as the build files do.
+//
+//  Usage: any_cast_no_rtti [count]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any.hpp>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    namespace a_namespace_with_a_rather_long_name
+    {
+        template<int N>
+        struct value_of_some_kind
+        {
+            std::size_t value;
+        };
+    }
+
+    using a_namespace_with_a_rather_long_name::value_of_some_kind;
+
+    template<int... N>
+    std::vector<boost::any> make_values(std::size_t count)
+    {
+        const boost::any all[] = { value_of_some_kind<N>()... };
+        std::vector<boost::any> values;
+        values.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            values.push_back(all[i % sizeof...(N)]);
+        return values;
+    }
+
+    void run(const char * name, const std::vector<boost::any> & values)
+    {
+        const timer t;
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < values.size(); ++i)
+            found += boost::any_cast<value_of_some_kind<0> >(&values[i]) != 0;
+        report(name, t.seconds(), values.size(), "casts");
+        consume(found);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 10000000);
+    std::printf("%u values\n", static_cast<unsigned>(count));
+
+    run("any_cast, every value matches", make_values<0>(count));
+    run("any_cast, 1 in 8 values matches", make_values<0, 1, 2, 3, 4, 5, 6, 7>(count));
+    return 0;
+}
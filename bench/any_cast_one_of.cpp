@@ -0,0 +1,88 @@
+//  Benchmark of any_cast_one_of against a ladder of any_cast calls, one per
+//  candidate type, over values that hold each candidate in turn. Lists of
+//  4 candidates are scanned linearly, lists of 16 use the hashed lookup.
+//
+//  Usage: any_cast_one_of [count]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/any_cast_one_of.hpp>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    template<int N>
+    struct tag
+    {
+        std::size_t value;
+    };
+
+    // What any_index_of is without any_cast_one_of
+    template<std::size_t I>
+    std::size_t ladder_index_of(const boost::any &)
+    {
+        return boost::any_npos;
+    }
+
+    template<std::size_t I, typename ValueType, typename... Rest>
+    std::size_t ladder_index_of(const boost::any & value)
+    {
+        return boost::any_cast<ValueType>(&value) ? I : ladder_index_of<I + 1, Rest...>(value);
+    }
+
+    template<int... N>
+    struct candidates
+    {
+        static std::vector<boost::any> make_values(std::size_t count)
+        {
+            const boost::any all[] = { tag<N>()... };
+            std::vector<boost::any> values;
+            values.reserve(count);
+            for (std::size_t i = 0; i < count; ++i)
+                values.push_back(all[i % sizeof...(N)]);
+            return values;
+        }
+
+        static void run(const char * ladder_name, const char * one_of_name, std::size_t count)
+        {
+            const std::vector<boost::any> values = make_values(count);
+            {
+                const timer t;
+                std::size_t sum = 0;
+                for (std::size_t i = 0; i < values.size(); ++i)
+                    sum += ladder_index_of<0, tag<N>...>(values[i]);
+                report(ladder_name, t.seconds(), count, "casts");
+                consume(sum);
+            }
+            {
+                const timer t;
+                std::size_t sum = 0;
+                for (std::size_t i = 0; i < values.size(); ++i)
+                    sum += boost::any_cast_one_of<tag<N>...>(&values[i]).index();
+                report(one_of_name, t.seconds(), count, "casts");
+                consume(sum);
+            }
+        }
+    };
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 10000000);
+    std::printf("%u values\n", static_cast<unsigned>(count));
+
+    candidates<0, 1, 2, 3>::run("4 types, any_cast ladder", "4 types, any_cast_one_of", count);
+    candidates<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15>::run(
+        "16 types, any_cast ladder", "16 types, any_cast_one_of", count
+    );
+    return 0;
+}
@@ -0,0 +1,98 @@
+//  Benchmark of any_convert<double> over values holding short, int, float,
+//  double and unsigned char, against a hand-written ladder of any_cast
+//  calls, from one thread and from several threads at once.
+//
+//  Usage: any_convert [count] [threads]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/any_convert.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    std::vector<boost::any> make_values(std::size_t count)
+    {
+        std::vector<boost::any> values;
+        values.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            switch (i % 5)
+            {
+            case 0: values.push_back(static_cast<short>(i % 1000)); break;
+            case 1: values.push_back(static_cast<int>(i)); break;
+            case 2: values.push_back(static_cast<float>(i % 1000)); break;
+            case 3: values.push_back(static_cast<double>(i)); break;
+            default: values.push_back(static_cast<unsigned char>(i)); break;
+            }
+        }
+        return values;
+    }
+
+    // What the conversion is without any_convert
+    double cast_ladder(const boost::any & value)
+    {
+        if (const double * d = boost::any_cast<double>(&value))
+            return *d;
+        if (const int * i = boost::any_cast<int>(&value))
+            return *i;
+        if (const short * s = boost::any_cast<short>(&value))
+            return *s;
+        if (const float * f = boost::any_cast<float>(&value))
+            return *f;
+        if (const unsigned char * c = boost::any_cast<unsigned char>(&value))
+            return *c;
+        boost::throw_exception(boost::bad_any_cast());
+    }
+
+    double convert(const boost::any & value)
+    {
+        return boost::any_convert<double>(value);
+    }
+
+    void run(const char * name, const std::vector<boost::any> & values, std::size_t thread_count,
+        double (*function)(const boost::any &))
+    {
+        std::atomic<std::size_t> total(0);
+        const timer t;
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            threads.push_back(std::thread([&values, &total, function]() {
+                double sum = 0;
+                for (std::size_t n = 0; n < values.size(); ++n)
+                    sum += function(values[n]);
+                total.fetch_add(static_cast<std::size_t>(sum), std::memory_order_relaxed);
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+        report(name, t.seconds(), values.size() * thread_count, "conversions");
+        consume(total.load());
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 10000000);
+    const std::size_t thread_count = argument(argc, argv, 2, 4);
+    std::printf("%u values, %u threads\n", static_cast<unsigned>(count), static_cast<unsigned>(thread_count));
+
+    const std::vector<boost::any> values = make_values(count);
+    run("any_cast ladder, 1 thread", values, 1, cast_ladder);
+    run("any_convert, 1 thread", values, 1, convert);
+    run("any_cast ladder, threads", values, thread_count, cast_ladder);
+    run("any_convert, threads", values, thread_count, convert);
+    return 0;
+}
@@ -0,0 +1,18 @@
+//  Compile time benchmark: a translation unit that uses nothing but
+//  boost/any.hpp.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any.hpp>
+
+int main()
+{
+    const boost::any value(42);
+    return boost::any_cast<int>(value) == 42 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+//  Benchmark of any_log: appends mixed records until the file reaches the
+//  requested size, then opens it, scans the records as views of the
+//  mapping, scans them again decoding each into a boost::any, and reads
+//  records at random positions. Drop the page cache between writing and
+//  reading to measure reads from the disk rather than from memory.
+//
+//  Usage: any_log_throughput [megabytes] [path]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/any_log.hpp>
+#include <cstdio>
+#include <string>
+
+#include "bench.hpp"
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t megabytes = argument(argc, argv, 1, 4096);
+    const std::string path = argc > 2 ? argv[2] : "any_log_throughput.log";
+    const std::size_t bytes = megabytes << 20;
+    std::printf("%u MB in %s\n", static_cast<unsigned>(megabytes), path.c_str());
+    std::remove(path.c_str());
+
+    std::size_t records = 0;
+    {
+        const std::string text(100, 'x');
+        const timer t;
+        boost::any_log_writer writer(path);
+        for (std::size_t written = 0; written < bytes; ++records)
+        {
+            switch (records % 3)
+            {
+            case 0: writer.append(static_cast<int>(records)); written += 16; break;
+            case 1: writer.append(static_cast<double>(records)); written += 16; break;
+            default: writer.append(text); written += 8 + 104; break;
+            }
+        }
+        writer.flush();
+        report("append", t.seconds(), megabytes, "MB");
+    }
+    {
+        const timer t;
+        const boost::any_log_reader reader(path);
+        report("open and index", t.seconds(), megabytes, "MB");
+
+        const timer views;
+        std::size_t payload = 0;
+        for (boost::any_log_reader::const_iterator it = reader.begin(); it != reader.end(); ++it)
+            payload += (*it).size();
+        report("scan views", views.seconds(), megabytes, "MB");
+        consume(payload);
+
+        const timer decoded;
+        std::size_t nonempty = 0;
+        for (boost::any_log_reader::const_iterator it = reader.begin(); it != reader.end(); ++it)
+            nonempty += !(*it).to_any().empty();
+        report("scan into boost::any", decoded.seconds(), megabytes, "MB");
+        consume(nonempty);
+
+        const std::size_t lookups = 1000000;
+        const timer random;
+        std::size_t state = 42;
+        for (std::size_t i = 0; i < lookups; ++i)
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            payload += reader[(state >> 33) % reader.size()].size();
+        }
+        report("random access", random.seconds(), lookups, "records");
+        consume(payload);
+    }
+    std::printf("%u records\n", static_cast<unsigned>(records));
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,153 @@
+//  Benchmark of any_property_map against a std::map from std::string to
+//  boost::any: builds records of eight int, double and std::string fields,
+//  copies them, and reads their fields by name, by interned property_key
+//  and, from several threads, by name again.
+//
+//  Usage: any_property_map [records] [threads]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/any_property_map.hpp>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    const char * const names[] = {
+        "id", "weight", "label", "width", "ratio", "owner", "revision", "scale"
+    };
+
+    const std::size_t field_count = sizeof(names) / sizeof(names[0]);
+
+    typedef std::map<std::string, boost::any> any_map;
+
+    template<typename Map>
+    void set_field(Map & record, std::size_t field, std::size_t value)
+    {
+        switch (field % 3)
+        {
+        case 0: record.insert_or_assign(names[field], static_cast<int>(value)); break;
+        case 1: record.insert_or_assign(names[field], static_cast<double>(value)); break;
+        default: record.insert_or_assign(names[field], std::to_string(value)); break;
+        }
+    }
+
+    void set_field(any_map & record, std::size_t field, std::size_t value)
+    {
+        switch (field % 3)
+        {
+        case 0: record[names[field]] = static_cast<int>(value); break;
+        case 1: record[names[field]] = static_cast<double>(value); break;
+        default: record[names[field]] = std::to_string(value); break;
+        }
+    }
+
+    // The ints of a record
+    std::size_t read_by_name(const boost::any_property_map & record)
+    {
+        return static_cast<std::size_t>(boost::any_cast<int>(record.find("id"))
+            + boost::any_cast<int>(record.find("width"))
+            + boost::any_cast<int>(record.find("revision")));
+    }
+
+    std::size_t read_by_key(const boost::any_property_map & record)
+    {
+        static const boost::property_key id("id"), width("width"), revision("revision");
+        return static_cast<std::size_t>(boost::any_cast<int>(record.find(id))
+            + boost::any_cast<int>(record.find(width))
+            + boost::any_cast<int>(record.find(revision)));
+    }
+
+    template<typename Map>
+    void read_by_key(const char *, const std::vector<Map> &)
+    {
+    }
+
+    void read_by_key(const char * name, const std::vector<boost::any_property_map> & records)
+    {
+        const timer t;
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < records.size(); ++i)
+            sum += read_by_key(records[i]);
+        report(name, t.seconds(), records.size(), "records");
+        consume(sum);
+    }
+
+    std::size_t read_by_name(const any_map & record)
+    {
+        return static_cast<std::size_t>(*boost::any_cast<int>(&record.find("id")->second)
+            + *boost::any_cast<int>(&record.find("width")->second)
+            + *boost::any_cast<int>(&record.find("revision")->second));
+    }
+
+    template<typename Map>
+    void run(const char * name, std::size_t count, std::size_t thread_count)
+    {
+        std::printf("%s\n", name);
+        std::vector<Map> records(count);
+        {
+            const timer t;
+            for (std::size_t i = 0; i < count; ++i)
+                for (std::size_t field = 0; field < field_count; ++field)
+                    set_field(records[i], field, i);
+            report("  build", t.seconds(), count, "records");
+        }
+        {
+            const timer t;
+            const std::vector<Map> copies(records);
+            report("  copy", t.seconds(), count, "records");
+            consume(copies.size());
+        }
+        {
+            const timer t;
+            std::size_t sum = 0;
+            for (std::size_t i = 0; i < count; ++i)
+                sum += read_by_name(records[i]);
+            report("  read 3 fields by name", t.seconds(), count, "records");
+            consume(sum);
+        }
+        read_by_key("  read 3 fields by property_key", records);
+        {
+            std::atomic<std::size_t> total(0);
+            const timer t;
+            std::vector<std::thread> threads;
+            for (std::size_t i = 0; i < thread_count; ++i)
+            {
+                threads.push_back(std::thread([&records, &total]() {
+                    std::size_t sum = 0;
+                    for (std::size_t n = 0; n < records.size(); ++n)
+                        sum += read_by_name(records[n]);
+                    total.fetch_add(sum, std::memory_order_relaxed);
+                }));
+            }
+            for (std::size_t i = 0; i < threads.size(); ++i)
+                threads[i].join();
+            report("  read 3 fields by name, threads", t.seconds(), count * thread_count, "records");
+            consume(total.load());
+        }
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 1000000);
+    const std::size_t thread_count = argument(argc, argv, 2, 4);
+    std::printf("%u records of %u fields, %u threads\n", static_cast<unsigned>(count),
+        static_cast<unsigned>(field_count), static_cast<unsigned>(thread_count));
+
+    run<any_map>("std::map<std::string, boost::any>", count, thread_count);
+    run<boost::any_property_map>("any_property_map", count, thread_count);
+    return 0;
+}
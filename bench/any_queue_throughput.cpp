@@ -0,0 +1,157 @@
+//  Benchmark of any_queue: producer threads push ints, as many consumer
+//  threads sum them. Compares try_consume and try_consume_batch with a
+//  std::deque of boost::any guarded by a std::mutex.
+//
+//  Usage: any_queue_throughput [count] [producers]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/any_queue.hpp>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    class adder
+    {
+    public: // structors
+
+        explicit adder(std::size_t & sum)
+          : sum(&sum)
+        {
+        }
+
+    public: // visitor
+
+        void operator()(boost::any_view value) const
+        {
+            *sum += static_cast<std::size_t>(*boost::any_cast<int>(&value));
+        }
+
+    private: // representation
+
+        std::size_t * sum;
+    };
+
+    // What the queue is without any_queue
+    class locked_deque
+    {
+    public: // queue
+
+        bool push(int value)
+        {
+            const boost::any boxed(value);
+            std::lock_guard<std::mutex> lock(guard);
+            values.push_back(boxed);
+            return true;
+        }
+
+        std::size_t consume(std::size_t & sum)
+        {
+            boost::any value;
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                if (values.empty())
+                    return 0;
+                value.swap(values.front());
+                values.pop_front();
+            }
+            sum += static_cast<std::size_t>(boost::any_cast<int>(value));
+            return 1;
+        }
+
+    private: // representation
+
+        std::mutex guard;
+        std::deque<boost::any> values;
+    };
+
+    template<std::size_t Batch>
+    class lock_free
+    {
+    public: // queue
+
+        lock_free()
+          : queue(1024)
+        {
+        }
+
+        bool push(int value)
+        {
+            return queue.try_push(value);
+        }
+
+        std::size_t consume(std::size_t & sum)
+        {
+            return Batch == 1
+                ? static_cast<std::size_t>(queue.try_consume(adder(sum)))
+                : queue.try_consume_batch(adder(sum), Batch);
+        }
+
+    private: // representation
+
+        boost::any_queue queue;
+    };
+
+    template<typename Queue>
+    void run(const char * name, std::size_t count, std::size_t producers)
+    {
+        Queue queue;
+        std::atomic<std::size_t> consumed(0);
+        std::atomic<std::size_t> total(0);
+        const std::size_t per_producer = count / producers;
+        count = per_producer * producers;
+
+        const timer t;
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < producers; ++i)
+        {
+            threads.push_back(std::thread([&queue, per_producer]() {
+                for (std::size_t n = 0; n < per_producer; ++n)
+                    while (!queue.push(static_cast<int>(n)))
+                        std::this_thread::yield();
+            }));
+            threads.push_back(std::thread([&queue, &consumed, &total, count]() {
+                std::size_t sum = 0;
+                while (consumed.load(std::memory_order_relaxed) < count)
+                {
+                    const std::size_t n = queue.consume(sum);
+                    if (n)
+                        consumed.fetch_add(n, std::memory_order_relaxed);
+                    else
+                        std::this_thread::yield();
+                }
+                total.fetch_add(sum, std::memory_order_relaxed);
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+        report(name, t.seconds(), count, "values");
+        consume(total.load());
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 10000000);
+    const std::size_t producers = argument(argc, argv, 2, 2);
+    std::printf("%u values, %u producers, %u consumers\n",
+        static_cast<unsigned>(count), static_cast<unsigned>(producers), static_cast<unsigned>(producers));
+
+    run<locked_deque>("std::deque and std::mutex", count, producers);
+    run<lock_free<1> >("any_queue, try_consume", count, producers);
+    run<lock_free<64> >("any_queue, try_consume_batch of 64", count, producers);
+    return 0;
+}
@@ -0,0 +1,83 @@
+//  Benchmark of BOOST_ANY_SHARED_TRIVIAL_HOLDERS: copies and casts of
+//  `boost::any` holding values of many distinct trivially copyable types
+//  of the same size. Built once with and once without the macro; compare
+//  the times, the text sections (`size any_shared_holders*`) and the
+//  instruction cache misses (`perf stat -e L1-icache-load-misses ...`).
+//
+//  Usage: any_shared_holders [rounds]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any.hpp>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    // One distinct type per `Id`, all of the same layout
+    template<std::size_t Id>
+    struct record
+    {
+        int key;
+        int value;
+    };
+
+    const std::size_t type_count = 512;
+
+    template<std::size_t... Ids>
+    std::vector<boost::any> make_values(std::index_sequence<Ids...>)
+    {
+        std::vector<boost::any> values;
+        values.reserve(sizeof...(Ids));
+        const int expand[] = { 0, (values.push_back(record<Ids>{ static_cast<int>(Ids), 1 }), 0)... };
+        (void)expand;
+        return values;
+    }
+
+    template<std::size_t... Ids>
+    std::size_t sum_values(const std::vector<boost::any> & values, std::index_sequence<Ids...>)
+    {
+        std::size_t sum = 0;
+        const int expand[] = { 0, (sum += static_cast<std::size_t>(boost::any_cast<const record<Ids>&>(values[Ids]).value), 0)... };
+        (void)expand;
+        return sum;
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t rounds = argument(argc, argv, 1, 20000);
+    const std::vector<boost::any> values = make_values(std::make_index_sequence<type_count>());
+
+#ifdef BOOST_ANY_SHARED_TRIVIAL_HOLDERS
+    std::printf("shared trivial holders, %u types\n", static_cast<unsigned>(type_count));
+#else
+    std::printf("a holder per type, %u types\n", static_cast<unsigned>(type_count));
+#endif
+
+    {
+        const timer t;
+        for (std::size_t i = 0; i < rounds; ++i)
+        {
+            std::vector<boost::any> copy(values);
+            consume(copy.size());
+        }
+        report("copy", t.seconds(), rounds * type_count, "values");
+    }
+    {
+        const timer t;
+        for (std::size_t i = 0; i < rounds; ++i)
+            consume(sum_values(values, std::make_index_sequence<type_count>()));
+        report("any_cast", t.seconds(), rounds * type_count, "values");
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+//  Benchmark of arena_any against boost::any: fills batches of int, double
+//  and std::string values, reads them and drops the batch, as a request
+//  handler would. boost::any allocates and frees every value, arena_any
+//  bump-allocates them and the arena is reset once per batch.
+//
+//  Usage: arena_any [count] [batch]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/arena_any.hpp>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    const std::string text = "a string too long for the small string optimization";
+
+    template<typename Container>
+    void fill(Container & values, std::size_t batch, std::size_t first)
+    {
+        for (std::size_t i = 0; i < batch; ++i)
+        {
+            switch (i % 3)
+            {
+            case 0: values[i] = static_cast<int>(first + i); break;
+            case 1: values[i] = static_cast<double>(first + i); break;
+            default: values[i] = text; break;
+            }
+        }
+    }
+
+    template<typename Container>
+    std::size_t read(const Container & values)
+    {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            if (const int * value = boost::any_cast<int>(&values[i]))
+                sum += static_cast<std::size_t>(*value);
+            else if (const std::string * value = boost::any_cast<std::string>(&values[i]))
+                sum += value->size();
+        }
+        return sum;
+    }
+
+    void run_any(std::size_t count, std::size_t batch)
+    {
+        const timer t;
+        std::size_t sum = 0;
+        for (std::size_t done = 0; done < count; done += batch)
+        {
+            std::vector<boost::any> values(batch);
+            fill(values, batch, done);
+            sum += read(values);
+        }
+        report("boost::any", t.seconds(), count, "values");
+        consume(sum);
+    }
+
+    void run_arena_any(std::size_t count, std::size_t batch)
+    {
+        boost::any_arena arena;
+        const timer t;
+        std::size_t sum = 0;
+        for (std::size_t done = 0; done < count; done += batch)
+        {
+            std::vector<boost::arena_any> values(batch, boost::arena_any(arena));
+            fill(values, batch, done);
+            sum += read(values);
+            values.clear();
+            arena.reset();
+        }
+        report("arena_any", t.seconds(), count, "values");
+        consume(sum);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 10000000);
+    const std::size_t batch = argument(argc, argv, 2, 1000);
+    std::printf("%u values in batches of %u\n", static_cast<unsigned>(count), static_cast<unsigned>(batch));
+
+    run_any(count, batch);
+    run_arena_any(count, batch);
+    return 0;
+}
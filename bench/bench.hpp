@@ -0,0 +1,60 @@
+// what:  helpers of the runtime benchmarks
+// who:   Antony Polukhin
+// when:  2021
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BENCH_INCLUDED
+#define BENCH_INCLUDED
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+namespace any_bench
+{
+    // The `index`-th command line argument as a number, or `fallback`
+    inline std::size_t argument(int argc, char * argv[], int index, std::size_t fallback)
+    {
+        return argc > index ? static_cast<std::size_t>(std::strtoull(argv[index], 0, 10)) : fallback;
+    }
+
+    class timer
+    {
+    public: // structors
+
+        timer()
+          : start(std::chrono::steady_clock::now())
+        {
+        }
+
+    public: // queries
+
+        double seconds() const
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+    private: // representation
+
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // Prints one line of results: the time of `count` operations and their rate
+    inline void report(const char * name, double seconds, std::size_t count, const char * unit = "ops")
+    {
+        std::printf("%-40s %10.3f s  %14.0f %s/s\n", name, seconds, seconds > 0 ? count / seconds : 0.0, unit);
+    }
+
+    // Keeps the results from being optimized away
+    inline void consume(std::size_t value)
+    {
+        static volatile std::size_t sink;
+        sink = sink + value;
+    }
+}
+
+#endif
@@ -0,0 +1,65 @@
+# Copyright Antony Polukhin, 2013-2021.
+# Distributed under the Boost Software License, Version 1.0.
+# See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt
+#
+# Run by the `boost_any_compile_time` target. For each configuration prints
+# the lines and bytes of the preprocessed SOURCE and the best of REPEAT
+# `-fsyntax-only` runs, i.e. the time spent in the frontend.
+
+cmake_minimum_required( VERSION 3.23 ) # string(TIMESTAMP) with %f
+
+if( NOT REPEAT )
+    set( REPEAT 3 )
+endif()
+
+set( flags )
+string( REPLACE "|" ";" includes "${INCLUDES}" )
+foreach( dir IN LISTS includes )
+    list( APPEND flags "-I${dir}" )
+endforeach()
+if( STANDARD )
+    list( APPEND flags "-std=c++${STANDARD}" )
+endif()
+
+set( configurations default no_rtti boost_type_traits )
+set( default_flags )
+set( no_rtti_flags -fno-rtti -DBOOST_NO_RTTI -DBOOST_NO_TYPEID )
+set( boost_type_traits_flags -DBOOST_ANY_NO_STD_TYPE_TRAITS )
+
+message( STATUS "configuration           lines       bytes    frontend" )
+foreach( configuration IN LISTS configurations )
+    set( preprocessed "${OUTPUT_DIR}/any_include_only.${configuration}.ii" )
+    execute_process(
+        COMMAND "${COMPILER}" ${flags} ${${configuration}_flags} -E "${SOURCE}" -o "${preprocessed}"
+        RESULT_VARIABLE result
+    )
+    if( result )
+        message( FATAL_ERROR "cannot preprocess ${SOURCE} (${configuration})" )
+    endif()
+
+    file( SIZE "${preprocessed}" bytes )
+    file( STRINGS "${preprocessed}" lines )
+    list( LENGTH lines line_count ) # without the empty lines
+
+    set( best "" )
+    foreach( i RANGE 1 ${REPEAT} )
+        string( TIMESTAMP start "%s%f" )
+        execute_process(
+            COMMAND "${COMPILER}" ${flags} ${${configuration}_flags} -fsyntax-only "${SOURCE}"
+            RESULT_VARIABLE result
+        )
+        string( TIMESTAMP stop "%s%f" )
+        if( result )
+            message( FATAL_ERROR "cannot compile ${SOURCE} (${configuration})" )
+        endif()
+        math( EXPR elapsed "(${stop} - ${start}) / 1000" )
+        if( best STREQUAL "" OR elapsed LESS best )
+            set( best ${elapsed} )
+        endif()
+    endforeach()
+
+    string( LENGTH "${configuration}" length )
+    math( EXPR padding "20 - ${length}" )
+    string( REPEAT " " ${padding} pad )
+    message( STATUS "${configuration}${pad}${line_count}    ${bytes}    ${best} ms" )
+endforeach()
@@ -0,0 +1,122 @@
+//  Benchmark of concurrent_any_map: threads look up random keys and assign
+//  one key in ten, against a std::unordered_map guarded by one std::mutex
+//  and against concurrent_any_map with a single shard.
+//
+//  Usage: concurrent_any_map [count] [threads] [keys]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/concurrent_any_map.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    // Deterministic pseudo random numbers
+    std::size_t next(std::size_t & state)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    }
+
+    // What the map is without concurrent_any_map
+    class locked_map
+    {
+    public: // map
+
+        typedef std::shared_ptr<const boost::any> snapshot;
+
+        explicit locked_map(std::size_t /*shard_count*/)
+        {
+        }
+
+        void insert_or_assign(const std::string & key, int value)
+        {
+            const snapshot boxed = std::make_shared<const boost::any>(value);
+            std::lock_guard<std::mutex> lock(guard);
+            values[key] = boxed;
+        }
+
+        snapshot find(const std::string & key) const
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            const std::unordered_map<std::string, snapshot>::const_iterator it = values.find(key);
+            return it == values.end() ? snapshot() : it->second;
+        }
+
+    private: // representation
+
+        mutable std::mutex guard;
+        std::unordered_map<std::string, snapshot> values;
+    };
+
+    template<typename Map>
+    void run(const char * name, std::size_t shard_count, std::size_t count, std::size_t thread_count,
+        const std::vector<std::string> & keys)
+    {
+        Map map(shard_count);
+        for (std::size_t i = 0; i < keys.size(); ++i)
+            map.insert_or_assign(keys[i], static_cast<int>(i));
+
+        const std::size_t per_thread = count / thread_count;
+        std::atomic<std::size_t> total(0);
+        const timer t;
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            threads.push_back(std::thread([&map, &keys, &total, per_thread, i]() {
+                std::size_t state = i + 1;
+                std::size_t sum = 0;
+                for (std::size_t n = 0; n < per_thread; ++n)
+                {
+                    const std::size_t random = next(state);
+                    const std::string & key = keys[random % keys.size()];
+                    if (random % 10 == 0)
+                    {
+                        map.insert_or_assign(key, static_cast<int>(n));
+                        continue;
+                    }
+                    const typename Map::snapshot value = map.find(key);
+                    sum += static_cast<std::size_t>(*boost::any_cast<int>(value.get()));
+                }
+                total.fetch_add(sum, std::memory_order_relaxed);
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+        report(name, t.seconds(), per_thread * thread_count, "ops");
+        consume(total.load());
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 10000000);
+    const std::size_t thread_count = argument(argc, argv, 2, 4);
+    const std::size_t key_count = argument(argc, argv, 3, 10000);
+    std::printf("%u operations, %u threads, %u keys\n", static_cast<unsigned>(count),
+        static_cast<unsigned>(thread_count), static_cast<unsigned>(key_count));
+
+    std::vector<std::string> keys;
+    for (std::size_t i = 0; i < key_count; ++i)
+        keys.push_back("property/" + std::to_string(i));
+
+    run<locked_map>("std::unordered_map and std::mutex", 1, count, thread_count, keys);
+    run<boost::concurrent_any_map>("concurrent_any_map, 1 shard", 1, count, thread_count, keys);
+    run<boost::concurrent_any_map>("concurrent_any_map, 16 shards", 16, count, thread_count, keys);
+    return 0;
+}
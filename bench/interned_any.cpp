@@ -0,0 +1,84 @@
+//  Benchmark of interned_any against boost::any over a column of strings
+//  with few distinct values: constructing the values, copying the column,
+//  and comparing neighbouring values for equality.
+//
+//  Usage: interned_any [count] [distinct]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/interned_any.hpp>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    // Deterministic pseudo random numbers
+    std::size_t next(std::size_t & state)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    }
+
+    bool equal(const boost::any & lhs, const boost::any & rhs)
+    {
+        return boost::any_cast<const std::string &>(lhs) == boost::any_cast<const std::string &>(rhs);
+    }
+
+    bool equal(const boost::interned_any & lhs, const boost::interned_any & rhs)
+    {
+        return lhs == rhs;
+    }
+
+    template<typename Any>
+    void run(const char * name, std::size_t count, const std::vector<std::string> & categories)
+    {
+        std::printf("%s\n", name);
+        std::vector<Any> values;
+        values.reserve(count);
+        {
+            std::size_t state = 42;
+            const timer t;
+            for (std::size_t i = 0; i < count; ++i)
+                values.push_back(Any(categories[next(state) % categories.size()]));
+            report("  construct", t.seconds(), count, "values");
+        }
+        {
+            const timer t;
+            const std::vector<Any> copy(values);
+            report("  copy", t.seconds(), count, "values");
+            consume(copy.size());
+        }
+        {
+            const timer t;
+            std::size_t same = 0;
+            for (std::size_t i = 1; i < values.size(); ++i)
+                same += equal(values[i - 1], values[i]);
+            report("  compare", t.seconds(), count, "values");
+            consume(same);
+        }
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 10000000);
+    const std::size_t distinct = argument(argc, argv, 2, 100);
+    std::printf("%u values, %u distinct\n", static_cast<unsigned>(count), static_cast<unsigned>(distinct));
+
+    std::vector<std::string> categories;
+    for (std::size_t i = 0; i < distinct; ++i)
+        categories.push_back("category of a product in the catalogue, number " + std::to_string(i));
+
+    run<boost::any>("boost::any", count, categories);
+    run<boost::interned_any>("interned_any", count, categories);
+    return 0;
+}
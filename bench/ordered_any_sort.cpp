@@ -0,0 +1,106 @@
+//  Benchmark of sorting and binary search over ordered_any with any_less,
+//  against a hand-written cast ladder over boost::any. The values are a
+//  mix of int, double and std::string.
+//
+//  Usage: ordered_any_sort [count]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/ordered_any.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    // What the comparison of boost::any values is without ordered_any
+    struct cast_ladder_less
+    {
+        static int rank(const boost::any & value)
+        {
+            if (boost::any_cast<int>(&value))
+                return 0;
+            if (boost::any_cast<double>(&value))
+                return 1;
+            return 2;
+        }
+
+        bool operator()(const boost::any & lhs, const boost::any & rhs) const
+        {
+            const int lhs_rank = rank(lhs), rhs_rank = rank(rhs);
+            if (lhs_rank != rhs_rank)
+                return lhs_rank < rhs_rank;
+            switch (lhs_rank)
+            {
+            case 0: return boost::any_cast<int>(lhs) < boost::any_cast<int>(rhs);
+            case 1: return boost::any_cast<double>(lhs) < boost::any_cast<double>(rhs);
+            default: return boost::any_cast<const std::string&>(lhs) < boost::any_cast<const std::string&>(rhs);
+            }
+        }
+    };
+
+    // Deterministic pseudo random numbers
+    std::size_t next(std::size_t & state)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    }
+
+    template<typename Any>
+    std::vector<Any> make_values(std::size_t count)
+    {
+        std::vector<Any> values;
+        values.reserve(count);
+        std::size_t state = 42;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::size_t n = next(state);
+            switch (n % 3)
+            {
+            case 0: values.push_back(static_cast<int>(n % 1000000)); break;
+            case 1: values.push_back(static_cast<double>(n % 1000000) / 8); break;
+            default: values.push_back(std::to_string(n % 1000000)); break;
+            }
+        }
+        return values;
+    }
+
+    template<typename Any, typename Less>
+    void run(const char * sort_name, const char * search_name, std::size_t count, Less less)
+    {
+        std::vector<Any> values = make_values<Any>(count);
+        const std::vector<Any> keys(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(count / 10));
+        {
+            const timer t;
+            std::sort(values.begin(), values.end(), less);
+            report(sort_name, t.seconds(), count, "values");
+        }
+        {
+            const timer t;
+            std::size_t found = 0;
+            for (std::size_t i = 0; i < keys.size(); ++i)
+                found += std::binary_search(values.begin(), values.end(), keys[i], less);
+            report(search_name, t.seconds(), keys.size(), "lookups");
+            consume(found);
+        }
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 10000000);
+    std::printf("%u values\n", static_cast<unsigned>(count));
+
+    run<boost::any>("std::sort, cast ladder", "std::binary_search, cast ladder", count, cast_ladder_less());
+    run<boost::ordered_any>("std::sort, any_less", "std::binary_search, any_less", count, boost::any_less());
+    return 0;
+}
@@ -0,0 +1,87 @@
+//  Benchmark of to_std_any and from_std_any against copying the value
+//  into the other container, for large std::string and std::vector
+//  payloads.
+//
+//  Usage: std_any_interop [count] [payload bytes]
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <boost/any/std_any.hpp>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace any_bench
+{
+    std::vector<boost::any> make_values(std::size_t count, std::size_t bytes)
+    {
+        std::vector<boost::any> values;
+        values.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (i % 2)
+                values.push_back(std::string(bytes, 'x'));
+            else
+                values.push_back(std::vector<int>(bytes / sizeof(int), 1));
+        }
+        return values;
+    }
+
+    std::any copy_to_std(const boost::any & value)
+    {
+        if (const std::string * text = boost::any_cast<std::string>(&value))
+            return std::any(*text);
+        return std::any(boost::any_cast<const std::vector<int>&>(value));
+    }
+
+    boost::any copy_from_std(const std::any & value)
+    {
+        if (const std::string * text = std::any_cast<std::string>(&value))
+            return boost::any(*text);
+        return boost::any(std::any_cast<const std::vector<int>&>(value));
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace any_bench;
+    const std::size_t count = argument(argc, argv, 1, 10000);
+    const std::size_t bytes = argument(argc, argv, 2, 1 << 16);
+    std::printf("%u values of %u bytes\n", static_cast<unsigned>(count), static_cast<unsigned>(bytes));
+
+    std::vector<boost::any> values = make_values(count, bytes);
+    std::vector<std::any> converted(count);
+    {
+        const timer t;
+        for (std::size_t i = 0; i < count; ++i)
+            converted[i] = copy_to_std(values[i]);
+        report("copy to std::any", t.seconds(), count, "values");
+    }
+    {
+        const timer t;
+        for (std::size_t i = 0; i < count; ++i)
+            values[i] = copy_from_std(converted[i]);
+        report("copy from std::any", t.seconds(), count, "values");
+    }
+    {
+        const timer t;
+        for (std::size_t i = 0; i < count; ++i)
+            converted[i] = boost::to_std_any<std::string, std::vector<int> >(static_cast<boost::any&&>(values[i]));
+        report("to_std_any", t.seconds(), count, "values");
+    }
+    {
+        const timer t;
+        for (std::size_t i = 0; i < count; ++i)
+            values[i] = boost::from_std_any<std::string, std::vector<int> >(static_cast<std::any&&>(converted[i]));
+        report("from_std_any", t.seconds(), count, "values");
+    }
+    consume(values.size());
+    return 0;
+}
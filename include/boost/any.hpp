@@ -16,24 +16,50 @@
 
 #include <boost/config.hpp>
 #include <boost/type_index.hpp>
-#include <boost/type_traits/remove_reference.hpp>
-#include <boost/type_traits/decay.hpp>
-#include <boost/type_traits/remove_cv.hpp>
-#include <boost/type_traits/add_reference.hpp>
-#include <boost/type_traits/is_reference.hpp>
-#include <boost/type_traits/is_const.hpp>
 #include <boost/throw_exception.hpp>
 #include <boost/static_assert.hpp>
-#include <boost/utility/enable_if.hpp>
 #include <boost/core/addressof.hpp>
-#include <boost/type_traits/is_same.hpp>
-#include <boost/type_traits/is_const.hpp>
-#include <boost/type_traits/conditional.hpp>
+#include <boost/any/detail/type_hash.hpp>
+#include <boost/any/detail/type_traits.hpp>
+#include <boost/any/detail/value_ops.hpp>
+
+// With `BOOST_ANY_SHARED_TRIVIAL_HOLDERS` defined, the trivially copyable
+// types of the same size and alignment are held by the same holder class,
+// so that its code is not instantiated once per type. Each such holder is
+// two pointers larger. Define it in all the translation units or in none.
+#ifdef BOOST_ANY_SHARED_TRIVIAL_HOLDERS
+#   include <boost/type_traits/aligned_storage.hpp>
+#   include <cstddef>
+#   include <cstring>
+#endif
 
 namespace boost
 {
+    namespace anys { namespace detail {
+        struct any_access;
+
+        template<typename ValueType>
+        struct shares_holder
+        {
+#ifdef BOOST_ANY_SHARED_TRIVIAL_HOLDERS
+            BOOST_STATIC_CONSTANT(bool, value = (
+                has_trivial_copy<ValueType>::value
+                && has_trivial_move_constructor<ValueType>::value
+                && has_trivial_destructor<ValueType>::value
+            ));
+#else
+            BOOST_STATIC_CONSTANT(bool, value = false);
+#endif
+        };
+    }}
+
     class any
     {
+    public: // types
+
+        template<typename ValueType>
+        class static_storage;
+
     public: // structors
 
         BOOST_CONSTEXPR any() BOOST_NOEXCEPT
@@ -41,11 +67,18 @@ namespace boost
         {
         }
 
+        // Refers to `storage` instead of allocating a holder.
+        template<typename ValueType>
+        BOOST_CONSTEXPR any(static_storage<ValueType> & storage) BOOST_NOEXCEPT
+          : content(&storage)
+        {
+        }
+
         template<typename ValueType>
         any(const ValueType & value)
-          : content(new holder<
-                BOOST_DEDUCED_TYPENAME remove_cv<BOOST_DEDUCED_TYPENAME decay<const ValueType>::type>::type
-            >(value))
+          : content(holder_of<
+                BOOST_DEDUCED_TYPENAME anys::detail::remove_cv<BOOST_DEDUCED_TYPENAME anys::detail::decay<const ValueType>::type>::type
+            >::create(value))
         {
         }
 
@@ -65,16 +98,17 @@ namespace boost
         // Perfect forwarding of ValueType
         template<typename ValueType>
         any(ValueType&& value
-            , typename boost::disable_if<boost::is_same<any&, ValueType> >::type* = 0 // disable if value has type `any&`
-            , typename boost::disable_if<boost::is_const<ValueType> >::type* = 0) // disable if value has type `const ValueType&&`
-          : content(new holder< typename decay<ValueType>::type >(static_cast<ValueType&&>(value)))
+            , typename anys::detail::disable_if<anys::detail::is_same<any&, ValueType> >::type* = 0 // disable if value has type `any&`
+            , typename anys::detail::disable_if<anys::detail::is_const<ValueType> >::type* = 0) // disable if value has type `const ValueType&&`
+          : content(holder_of< typename anys::detail::decay<ValueType>::type >::create(static_cast<ValueType&&>(value)))
         {
         }
 #endif
 
         ~any() BOOST_NOEXCEPT
         {
-            delete content;
+            if (content)
+                content->destroy();
         }
 
     public: // modifiers
@@ -153,38 +187,81 @@ namespace boost
         {
         public: // structors
 
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+            BOOST_CONSTEXPR explicit placeholder(boost::uint64_t hash) BOOST_NOEXCEPT
+              : type_hash(hash)
+            {
+            }
+#endif
+
             virtual ~placeholder()
             {
             }
 
+            // Deletes the holder, unless it has static storage duration
+            virtual void destroy() BOOST_NOEXCEPT = 0;
+
         public: // queries
 
             virtual const boost::typeindex::type_info& type() const BOOST_NOEXCEPT = 0;
 
             virtual placeholder * clone() const = 0;
 
+            // For containers that copy held values into storage of their own:
+            // the address of the value and, in `ops`, the operations on it.
+            // Only `ops_holder` and the shared trivial holders provide them,
+            // so that the other holders cost no code per held type.
+            virtual void * value(const anys::detail::value_ops *& ops) BOOST_NOEXCEPT
+            {
+                ops = 0;
+                return 0;
+            }
+
+            // Whether the holder is a `static_storage`, which every `any`
+            // that refers to it shares: its value must not be moved from.
+            virtual bool is_static() const BOOST_NOEXCEPT
+            {
+                return false;
+            }
+
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+        public: // representation
+
+            // Compared by any_cast before the (string) type names
+            const boost::uint64_t type_hash;
+#endif
         };
 
+        // The value and its type, shared by `holder`, `ops_holder` and
+        // `static_storage`. Copies are plain holders.
         template<typename ValueType>
-        class holder
-#ifndef BOOST_NO_CXX11_FINAL
-          final
-#endif
+        class holder_base
           : public placeholder
         {
         public: // structors
 
-            holder(const ValueType & value)
+            BOOST_CONSTEXPR holder_base(const ValueType & value)
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+              : placeholder(anys::detail::type_hash<ValueType>::get())
+              , held(value)
+#else
               : held(value)
+#endif
             {
             }
 
 #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
-            holder(ValueType&& value)
+            BOOST_CONSTEXPR holder_base(ValueType&& value)
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+              : placeholder(anys::detail::type_hash<ValueType>::get())
+              , held(static_cast< ValueType&& >(value))
+#else
               : held(static_cast< ValueType&& >(value))
+#endif
             {
             }
 #endif
+
         public: // queries
 
             const boost::typeindex::type_info& type() const BOOST_NOEXCEPT BOOST_OVERRIDE
@@ -194,7 +271,7 @@ namespace boost
 
             placeholder * clone() const BOOST_OVERRIDE
             {
-                return new holder(held);
+                return new holder<ValueType>(held);
             }
 
         public: // representation
@@ -202,7 +279,318 @@ namespace boost
             ValueType held;
 
         private: // intentionally left unimplemented
-            holder & operator=(const holder &);
+            holder_base & operator=(const holder_base &);
+        };
+
+        template<typename ValueType>
+        class holder
+#ifndef BOOST_NO_CXX11_FINAL
+          final
+#endif
+          : public holder_base<ValueType>
+        {
+        public: // structors
+
+            BOOST_CONSTEXPR holder(const ValueType & value)
+              : holder_base<ValueType>(value)
+            {
+            }
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+            BOOST_CONSTEXPR holder(ValueType&& value)
+              : holder_base<ValueType>(static_cast< ValueType&& >(value))
+            {
+            }
+#endif
+
+            void destroy() BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                delete this;
+            }
+        };
+
+        // Holder that gives `anys::detail::any_access` the operations on its
+        // value. Only created for the containers of this library.
+        template<typename ValueType>
+        class ops_holder
+#ifndef BOOST_NO_CXX11_FINAL
+          final
+#endif
+          : public holder_base<ValueType>
+        {
+        public: // structors
+
+            explicit ops_holder(const ValueType & value)
+              : holder_base<ValueType>(value)
+            {
+            }
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+            explicit ops_holder(ValueType&& value)
+              : holder_base<ValueType>(static_cast< ValueType&& >(value))
+            {
+            }
+#endif
+
+            void destroy() BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                delete this;
+            }
+
+        public: // queries
+
+            placeholder * clone() const BOOST_OVERRIDE
+            {
+                return new ops_holder(this->held);
+            }
+
+            void * value(const anys::detail::value_ops *& ops) BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                ops = &anys::detail::value_ops_of<ValueType>::value;
+                return boost::addressof(this->held);
+            }
+        };
+
+#ifdef BOOST_ANY_SHARED_TRIVIAL_HOLDERS
+        // The code shared by the holders of the trivially copyable types of
+        // the same size and alignment. Only `identity` tells them apart;
+        // `data` points to the value, wherever the derived holder keeps it.
+        template<std::size_t Size, std::size_t Align>
+        class trivial_holder
+          : public placeholder
+        {
+        public: // structors
+
+            template<typename ValueType>
+            BOOST_CONSTEXPR explicit trivial_holder(ValueType * value) BOOST_NOEXCEPT
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+              : placeholder(anys::detail::type_hash<ValueType>::get())
+              , identity(&anys::detail::value_ops_of<ValueType>::value)
+#else
+              : identity(&anys::detail::value_ops_of<ValueType>::value)
+#endif
+              , data(value)
+            {
+            }
+
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+            trivial_holder(boost::uint64_t hash, const anys::detail::value_ops * identity, void * value) BOOST_NOEXCEPT
+              : placeholder(hash)
+              , identity(identity)
+              , data(value)
+            {
+            }
+#else
+            trivial_holder(const anys::detail::value_ops * identity, void * value) BOOST_NOEXCEPT
+              : identity(identity)
+              , data(value)
+            {
+            }
+#endif
+
+        public: // queries
+
+            const boost::typeindex::type_info& type() const BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                return identity->type();
+            }
+
+            placeholder * clone() const BOOST_OVERRIDE
+            {
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+                return trivial_heap_holder<Size, Align>::create(type_hash, identity, data);
+#else
+                return trivial_heap_holder<Size, Align>::create(identity, data);
+#endif
+            }
+
+            void * value(const anys::detail::value_ops *& ops) BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                ops = identity;
+                return data;
+            }
+
+        public: // representation
+
+            const anys::detail::value_ops * const identity;
+            void * const data;
+
+        private: // intentionally left unimplemented
+            trivial_holder & operator=(const trivial_holder &);
+        };
+
+        template<std::size_t Size, std::size_t Align>
+        class trivial_heap_holder
+          : public trivial_holder<Size, Align>
+        {
+        public: // structors
+
+            // Not inlined, so that the holders of all the types of this size
+            // and alignment are created by the same code
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+            static BOOST_NOINLINE placeholder * create(boost::uint64_t hash, const anys::detail::value_ops * identity, const void * value)
+            {
+                return new trivial_heap_holder(hash, identity, value);
+            }
+#else
+            static BOOST_NOINLINE placeholder * create(const anys::detail::value_ops * identity, const void * value)
+            {
+                return new trivial_heap_holder(identity, value);
+            }
+#endif
+
+            void destroy() BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                delete this;
+            }
+
+        private: // structors
+
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+            trivial_heap_holder(boost::uint64_t hash, const anys::detail::value_ops * identity, const void * value) BOOST_NOEXCEPT
+              : trivial_holder<Size, Align>(hash, identity, &storage)
+#else
+            trivial_heap_holder(const anys::detail::value_ops * identity, const void * value) BOOST_NOEXCEPT
+              : trivial_holder<Size, Align>(identity, &storage)
+#endif
+            {
+                std::memcpy(&storage, value, Size);
+            }
+
+        private: // representation
+
+            BOOST_DEDUCED_TYPENAME boost::aligned_storage<Size, Align>::type storage;
+        };
+
+        // Base of `static_storage` for the types with a shared holder. The
+        // value is a member of its own, so that it can be constant-initialized.
+        template<typename ValueType>
+        class trivial_static_holder
+          : public trivial_holder<sizeof(ValueType), anys::detail::alignment_of<ValueType>::value>
+        {
+        public: // structors
+
+            BOOST_CONSTEXPR explicit trivial_static_holder(const ValueType & value)
+              : trivial_holder<sizeof(ValueType), anys::detail::alignment_of<ValueType>::value>(boost::addressof(held))
+              , held(value)
+            {
+            }
+
+        public: // representation
+
+            ValueType held;
+        };
+#endif
+
+        // How `any` allocates a `ValueType` and finds it in the holder
+        template<typename ValueType, bool Shared = anys::detail::shares_holder<ValueType>::value>
+        struct holder_of
+        {
+            typedef holder<ValueType> type;
+            typedef holder_base<ValueType> static_base;
+
+            static placeholder * create(const ValueType & value)
+            {
+                return new type(value);
+            }
+
+            static placeholder * create_with_ops(const ValueType & value)
+            {
+                return new ops_holder<ValueType>(value);
+            }
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+            static placeholder * create(ValueType&& value)
+            {
+                return new type(static_cast<ValueType&&>(value));
+            }
+
+            static placeholder * create_with_ops(ValueType&& value)
+            {
+                return new ops_holder<ValueType>(static_cast<ValueType&&>(value));
+            }
+#endif
+
+            static ValueType * held(placeholder * content) BOOST_NOEXCEPT
+            {
+                return boost::addressof(static_cast<static_base *>(content)->held);
+            }
+        };
+
+#ifdef BOOST_ANY_SHARED_TRIVIAL_HOLDERS
+        template<typename ValueType>
+        struct holder_of<ValueType, true>
+        {
+            typedef trivial_holder<sizeof(ValueType), anys::detail::alignment_of<ValueType>::value> shared_type;
+            typedef trivial_heap_holder<sizeof(ValueType), anys::detail::alignment_of<ValueType>::value> type;
+            typedef trivial_static_holder<ValueType> static_base;
+
+            // Moving a trivially copyable type is copying it
+            static placeholder * create(const ValueType & value)
+            {
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+                return type::create(anys::detail::type_hash<ValueType>::get(),
+                    &anys::detail::value_ops_of<ValueType>::value, boost::addressof(value));
+#else
+                return type::create(&anys::detail::value_ops_of<ValueType>::value, boost::addressof(value));
+#endif
+            }
+
+            // The shared holders always give the operations
+            static placeholder * create_with_ops(const ValueType & value)
+            {
+                return create(value);
+            }
+
+            static ValueType * held(placeholder * content) BOOST_NOEXCEPT
+            {
+                return static_cast<ValueType *>(static_cast<shared_type *>(content)->data);
+            }
+        };
+#endif
+
+    public: // types
+
+        // Holder of the value of an `any` with static storage duration.
+        // Both can be constant-initialized for literal value types, so
+        // that no holder is allocated during dynamic initialization:
+        //
+        //   static boost::any::static_storage<int> storage(42);
+        //   constinit boost::any value(storage);
+        //
+        // `destroy` does nothing; copies of `value` are allocated on the
+        // heap as usual.
+        template<typename ValueType>
+        class static_storage
+#ifndef BOOST_NO_CXX11_FINAL
+          final
+#endif
+          : public holder_of<ValueType>::static_base
+        {
+            typedef BOOST_DEDUCED_TYPENAME holder_of<ValueType>::static_base base_type;
+
+        public: // structors
+
+            BOOST_CONSTEXPR explicit static_storage(const ValueType & value)
+              : base_type(value)
+            {
+            }
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+            BOOST_CONSTEXPR explicit static_storage(ValueType&& value)
+              : base_type(static_cast< ValueType&& >(value))
+            {
+            }
+#endif
+
+            void destroy() BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+            }
+
+            bool is_static() const BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                return true;
+            }
         };
 
 #ifndef BOOST_NO_MEMBER_TEMPLATE_FRIENDS
@@ -215,6 +603,11 @@ namespace boost
         template<typename ValueType>
         friend ValueType * unsafe_any_cast(any *) BOOST_NOEXCEPT;
 
+        friend struct anys::detail::any_access;
+
+        template<typename ValueType>
+        friend struct anys::detail::any_assign;
+
 #else
 
     public: // representation (public so any_cast can be non-friend)
@@ -230,6 +623,41 @@ namespace boost
         lhs.swap(rhs);
     }
 
+    namespace anys { namespace detail {
+        template<typename ValueType>
+        struct any_assign
+        {
+            static void copy(any & dst, const void * src)
+            {
+                any result;
+                result.content = any::holder_of<ValueType>::create_with_ops(*static_cast<const ValueType *>(src));
+                result.swap(dst);
+            }
+
+            static void move(any & dst, const void * src)
+            {
+                any result;
+                result.content = any::holder_of<ValueType>::create_with_ops(move_source<ValueType>::get(src));
+                result.swap(dst);
+            }
+        };
+
+        // A `boost::any` held in storage of a container is assigned as is
+        template<>
+        struct any_assign<any>
+        {
+            static void copy(any & dst, const void * src)
+            {
+                dst = *static_cast<const any *>(src);
+            }
+
+            static void move(any & dst, const void * src)
+            {
+                dst = move_source<any>::get(src);
+            }
+        };
+    }}
+
     class BOOST_SYMBOL_VISIBLE bad_any_cast :
 #ifndef BOOST_NO_RTTI
         public std::bad_cast
@@ -248,10 +676,14 @@ namespace boost
     template<typename ValueType>
     ValueType * any_cast(any * operand) BOOST_NOEXCEPT
     {
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+        return operand && operand->content
+            && operand->content->type_hash == anys::detail::type_hash<ValueType>::get()
+            && anys::detail::is_same_type_name<ValueType>(operand->content->type())
+#else
         return operand && operand->type() == boost::typeindex::type_id<ValueType>()
-            ? boost::addressof(
-                static_cast<any::holder<BOOST_DEDUCED_TYPENAME remove_cv<ValueType>::type> *>(operand->content)->held
-              )
+#endif
+            ? any::holder_of<BOOST_DEDUCED_TYPENAME anys::detail::remove_cv<ValueType>::type>::held(operand->content)
             : 0;
     }
 
@@ -264,7 +696,7 @@ namespace boost
     template<typename ValueType>
     ValueType any_cast(any & operand)
     {
-        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+        typedef BOOST_DEDUCED_TYPENAME anys::detail::remove_reference<ValueType>::type nonref;
 
 
         nonref * result = any_cast<nonref>(boost::addressof(operand));
@@ -275,10 +707,10 @@ namespace boost
         // `ValueType` is not a reference. Example:
         // `static_cast<std::string>(*result);` 
         // which is equal to `std::string(*result);`
-        typedef BOOST_DEDUCED_TYPENAME boost::conditional<
-            boost::is_reference<ValueType>::value,
+        typedef BOOST_DEDUCED_TYPENAME anys::detail::conditional<
+            anys::detail::is_reference<ValueType>::value,
             ValueType,
-            BOOST_DEDUCED_TYPENAME boost::add_reference<ValueType>::type
+            BOOST_DEDUCED_TYPENAME anys::detail::add_reference<ValueType>::type
         >::type ref_type;
 
 #ifdef BOOST_MSVC
@@ -294,7 +726,7 @@ namespace boost
     template<typename ValueType>
     inline ValueType any_cast(const any & operand)
     {
-        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+        typedef BOOST_DEDUCED_TYPENAME anys::detail::remove_reference<ValueType>::type nonref;
         return any_cast<const nonref &>(const_cast<any &>(operand));
     }
 
@@ -303,8 +735,8 @@ namespace boost
     inline ValueType any_cast(any&& operand)
     {
         BOOST_STATIC_ASSERT_MSG(
-            boost::is_rvalue_reference<ValueType&&>::value /*true if ValueType is rvalue or just a value*/
-            || boost::is_const< typename boost::remove_reference<ValueType>::type >::value,
+            anys::detail::is_rvalue_reference<ValueType&&>::value /*true if ValueType is rvalue or just a value*/
+            || anys::detail::is_const< typename anys::detail::remove_reference<ValueType>::type >::value,
             "boost::any_cast shall not be used for getting nonconst references to temporary objects" 
         );
         return any_cast<ValueType>(operand);
@@ -320,9 +752,7 @@ namespace boost
     template<typename ValueType>
     inline ValueType * unsafe_any_cast(any * operand) BOOST_NOEXCEPT
     {
-        return boost::addressof(
-            static_cast<any::holder<ValueType> *>(operand->content)->held
-        );
+        return any::holder_of<ValueType>::held(operand->content);
     }
 
     template<typename ValueType>
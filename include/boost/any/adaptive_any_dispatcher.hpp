@@ -0,0 +1,288 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ADAPTIVE_ANY_DISPATCHER_INCLUDED
+#define BOOST_ANY_ADAPTIVE_ANY_DISPATCHER_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Dispatching an `any` to the handler of its type, for candidate types that
+// are only known at run time. The candidates are probed in an order that
+// follows the observed workload: every `sample_period()`-th dispatch of a
+// thread counts a hit for the matched candidate, and after
+// `reorder_samples()` samples the probe order is sorted by hits. Hits are
+// halved on each reordering, so the order follows shifts of the type mix.
+//
+// Dispatching is thread safe and lock free. Candidates are added before the
+// dispatcher is shared between threads.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_HDR_ATOMIC) || defined(BOOST_NO_CXX11_HDR_MUTEX) \
+    || defined(BOOST_NO_CXX11_HDR_FUNCTIONAL) || defined(BOOST_NO_CXX11_THREAD_LOCAL) \
+    || defined(BOOST_NO_CXX11_LAMBDAS)
+#   error boost::anys::adaptive_any_dispatcher requires C++11 <atomic>, <mutex>, <functional>, thread_local and lambdas
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/any_cast_one_of.hpp>
+#include <boost/assert.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace boost
+{
+namespace anys
+{
+    namespace detail
+    {
+        // Dispatches of the calling thread, shared by all dispatchers.
+        inline std::size_t & dispatch_tick() BOOST_NOEXCEPT
+        {
+            static thread_local std::size_t tick = 0;
+            return tick;
+        }
+
+        // Only copied while the owning vector grows, which is not concurrent
+        // with any other access.
+        struct relaxed_slot
+        {
+            explicit relaxed_slot(std::size_t value) BOOST_NOEXCEPT
+              : value(value)
+            {
+            }
+
+            relaxed_slot(const relaxed_slot & other) BOOST_NOEXCEPT
+              : value(other.value.load(std::memory_order_relaxed))
+            {
+            }
+
+            std::atomic<std::size_t> value;
+        };
+    } // namespace detail
+
+    class adaptive_any_dispatcher
+      : private boost::noncopyable
+    {
+    public: // structors
+
+        // `sample_period` is rounded up to a power of two.
+        explicit adaptive_any_dispatcher(std::size_t sample_period = 16, std::size_t reorder_samples = 1024)
+          : mask(1)
+          , period(reorder_samples ? reorder_samples : 1)
+          , samples(0)
+          , version(0)
+        {
+            while (mask < sample_period)
+                mask <<= 1;
+            --mask;
+        }
+
+    public: // modifiers
+
+        // Adds a candidate, probed last until the next reordering. `handler`
+        // is called with a `ValueType&` to the held value. Adding a type
+        // again replaces its handler. Returns the index of the candidate.
+        template<typename ValueType, typename Handler>
+        std::size_t add(Handler handler)
+        {
+            typedef BOOST_DEDUCED_TYPENAME boost::remove_cv<ValueType>::type value_type;
+
+            candidate c;
+            c.type = boost::typeindex::type_id<value_type>();
+            c.handler = [handler](any & operand) mutable {
+                handler(*boost::unsafe_any_cast<value_type>(&operand));
+            };
+
+            for (std::size_t i = 0; i < candidates.size(); ++i)
+            {
+                if (candidates[i].type == c.type)
+                {
+                    candidates[i].handler = c.handler;
+                    return i;
+                }
+            }
+
+            candidates.push_back(c);
+            hit_counts.push_back(detail::relaxed_slot(0));
+            order.push_back(detail::relaxed_slot(candidates.size() - 1));
+            return candidates.size() - 1;
+        }
+
+        // Sorts the probe order by hits now. Thread safe.
+        void reorder()
+        {
+            std::lock_guard<std::mutex> lock(reordering);
+            reorder_locked();
+        }
+
+    public: // queries
+
+        // Calls the handler of the held type. Returns false if `operand`
+        // is empty or holds none of the candidate types.
+        bool dispatch(any & operand) const
+        {
+            const std::size_t index = index_of(operand);
+            if (index == any_npos)
+                return false;
+            candidates[index].handler(operand);
+            return true;
+        }
+
+        // Index of the candidate that `operand` holds, or `any_npos`.
+        std::size_t index_of(const any & operand) const
+        {
+            if (operand.empty())
+                return any_npos;
+
+            const std::size_t index = find(boost::typeindex::type_index(operand.type()));
+            if (index != any_npos && !(++detail::dispatch_tick() & mask))
+                record(index);
+            return index;
+        }
+
+        std::size_t size() const BOOST_NOEXCEPT
+        {
+            return candidates.size();
+        }
+
+        std::size_t sample_period() const BOOST_NOEXCEPT
+        {
+            return mask + 1;
+        }
+
+        std::size_t reorder_samples() const BOOST_NOEXCEPT
+        {
+            return period;
+        }
+
+        // Sampled hits of candidate `index` since the last reorderings,
+        // halved on each of them.
+        std::size_t hits(std::size_t index) const BOOST_NOEXCEPT
+        {
+            BOOST_ASSERT(index < candidates.size());
+            return hit_counts[index].value.load(std::memory_order_relaxed);
+        }
+
+        // Candidate indexes in the order they are probed.
+        std::vector<std::size_t> probe_order() const
+        {
+            std::lock_guard<std::mutex> lock(reordering);
+            std::vector<std::size_t> result(order.size());
+            for (std::size_t i = 0; i < order.size(); ++i)
+                result[i] = order[i].value.load(std::memory_order_relaxed);
+            return result;
+        }
+
+    private: // types
+
+        struct candidate
+        {
+            boost::typeindex::type_index type;
+            std::function<void(any &)> handler;
+        };
+
+        struct more_hits
+        {
+            explicit more_hits(const std::vector<std::size_t> & counts) BOOST_NOEXCEPT
+              : counts(&counts)
+            {
+            }
+
+            bool operator()(std::size_t lhs, std::size_t rhs) const BOOST_NOEXCEPT
+            {
+                return (*counts)[lhs] > (*counts)[rhs];
+            }
+
+            const std::vector<std::size_t> * counts;
+        };
+
+    private: // implementation
+
+        // A hit is always right. A miss may be caused by a concurrent
+        // reordering that left the order torn, so the candidates are then
+        // checked again in the order they were added.
+        std::size_t find(const boost::typeindex::type_index & type) const BOOST_NOEXCEPT
+        {
+            const unsigned before = version.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < order.size(); ++i)
+            {
+                const std::size_t index = order[i].value.load(std::memory_order_relaxed);
+                if (candidates[index].type == type)
+                    return index;
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (!(before & 1u) && version.load(std::memory_order_relaxed) == before)
+                return any_npos;
+
+            for (std::size_t i = 0; i < candidates.size(); ++i)
+            {
+                if (candidates[i].type == type)
+                    return i;
+            }
+            return any_npos;
+        }
+
+        void record(std::size_t index) const
+        {
+            hit_counts[index].value.fetch_add(1, std::memory_order_relaxed);
+            if (samples.fetch_add(1, std::memory_order_relaxed) + 1 < period)
+                return;
+
+            // Another thread is already reordering
+            std::unique_lock<std::mutex> lock(reordering, std::try_to_lock);
+            if (lock.owns_lock())
+                reorder_locked();
+        }
+
+        void reorder_locked() const
+        {
+            samples.store(0, std::memory_order_relaxed);
+
+            std::vector<std::size_t> counts(candidates.size()), sorted(candidates.size());
+            for (std::size_t i = 0; i < counts.size(); ++i)
+            {
+                counts[i] = hit_counts[i].value.load(std::memory_order_relaxed);
+                hit_counts[i].value.fetch_sub(counts[i] - counts[i] / 2, std::memory_order_relaxed);
+                sorted[i] = order[i].value.load(std::memory_order_relaxed);
+            }
+            std::stable_sort(sorted.begin(), sorted.end(), more_hits(counts));
+
+            const unsigned current = version.load(std::memory_order_relaxed);
+            version.store(current + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (std::size_t i = 0; i < sorted.size(); ++i)
+                order[i].value.store(sorted[i], std::memory_order_relaxed);
+            version.store(current + 2, std::memory_order_release);
+        }
+
+    private: // representation
+
+        std::vector<candidate> candidates;
+        mutable std::vector<detail::relaxed_slot> hit_counts;
+        mutable std::vector<detail::relaxed_slot> order; // candidate indexes
+        std::size_t mask; // sample_period() - 1
+        std::size_t period;
+        mutable std::atomic<std::size_t> samples;
+        mutable std::atomic<unsigned> version; // odd while reordering
+        mutable std::mutex reordering;
+    };
+} // namespace anys
+
+    using boost::anys::adaptive_any_dispatcher;
+} // namespace boost
+
+#endif
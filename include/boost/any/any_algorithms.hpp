@@ -0,0 +1,230 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ANY_ALGORITHMS_INCLUDED
+#define BOOST_ANY_ANY_ALGORITHMS_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Bulk algorithms over random access ranges of `boost::any`. The type checks
+// are split into contiguous chunks that run on separate threads; results are
+// combined in the order of the range, so the output does not depend on the
+// number of threads. Ranges shorter than `any_algorithms_serial_limit`
+// elements are processed by the calling thread only.
+//
+// The algorithms are declared in `boost::anys` only, their names are too
+// generic for `namespace boost`.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_HDR_THREAD) || defined(BOOST_NO_CXX11_HDR_EXCEPTION) \
+    || defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_LAMBDAS) \
+    || defined(BOOST_NO_CXX11_DECLTYPE) || defined(BOOST_NO_CXX11_HDR_TYPE_TRAITS)
+#   error boost::anys::any_algorithms require C++11 <thread>, <exception>, <type_traits>, rvalue references, lambdas and decltype
+#endif
+
+#include <boost/any.hpp>
+#include <boost/type_index.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace boost
+{
+namespace anys
+{
+    BOOST_STATIC_CONSTEXPR std::size_t any_algorithms_serial_limit = 16384;
+
+    namespace detail
+    {
+        // Splits [0, size) into at most `max_threads` chunks (all hardware
+        // threads if zero) and calls `body(chunk, begin, end)` for each, on
+        // separate threads. Returns the number of chunks. The first
+        // exception thrown by a chunk is rethrown after all of them finished.
+        template<typename Body>
+        std::size_t for_each_chunk(std::size_t size, std::size_t max_threads, Body body)
+        {
+            std::size_t chunks = max_threads ? max_threads : std::thread::hardware_concurrency();
+            if (!chunks || size < any_algorithms_serial_limit)
+                chunks = 1;
+            chunks = (std::min)(chunks, size ? size : 1);
+
+            const std::size_t step = size / chunks, extra = size % chunks;
+            std::vector<std::exception_ptr> errors(chunks);
+            std::vector<std::thread> threads;
+            threads.reserve(chunks - 1);
+
+            std::size_t begin = 0;
+            for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+            {
+                const std::size_t end = begin + step + (chunk < extra ? 1 : 0);
+                const auto run = [&body, &errors, chunk, begin, end]() {
+                    try {
+                        body(chunk, begin, end);
+                    } catch (...) {
+                        errors[chunk] = std::current_exception();
+                    }
+                };
+                if (chunk + 1 == chunks)
+                {
+                    run(); // the last chunk runs on the calling thread
+                }
+                else
+                {
+                    try {
+                        threads.push_back(std::thread(run));
+                    } catch (...) {
+                        run(); // could not start a thread
+                    }
+                }
+                begin = end;
+            }
+
+            for (std::size_t i = 0; i < threads.size(); ++i)
+                threads[i].join();
+            for (std::size_t i = 0; i < errors.size(); ++i)
+            {
+                if (errors[i])
+                    std::rethrow_exception(errors[i]);
+            }
+            return chunks;
+        }
+
+        template<typename ValueType>
+        inline bool holds(const boost::any & operand) BOOST_NOEXCEPT
+        {
+            return boost::any_cast<ValueType>(&operand) != 0;
+        }
+    } // namespace detail
+
+    // Number of elements per held type; empty elements are counted as `void`.
+    template<typename RandomAccessIterator>
+    std::map<boost::typeindex::type_index, std::size_t>
+        count_by_type(RandomAccessIterator first, RandomAccessIterator last, std::size_t max_threads = 0)
+    {
+        typedef std::map<boost::typeindex::type_index, std::size_t> counts_type;
+
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        std::vector<counts_type> partial(max_threads ? max_threads : (std::max)(std::thread::hardware_concurrency(), 1u));
+        const std::size_t chunks = detail::for_each_chunk(size, partial.size(),
+            [first, &partial](std::size_t chunk, std::size_t begin, std::size_t end) {
+                counts_type & counts = partial[chunk];
+
+                // Runs of the same type are counted with one map lookup
+                std::size_t i = begin;
+                while (i != end)
+                {
+                    const boost::typeindex::type_index type(first[i].type());
+                    std::size_t run = 1;
+                    while (i + run != end && boost::typeindex::type_index(first[i + run].type()) == type)
+                        ++run;
+                    counts[type] += run;
+                    i += run;
+                }
+            });
+
+        counts_type result;
+        result.swap(partial[0]);
+        for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+        {
+            for (typename counts_type::const_iterator it = partial[chunk].begin(); it != partial[chunk].end(); ++it)
+                result[it->first] += it->second;
+        }
+        return result;
+    }
+
+    // Copies every held `ValueType` to `out`, in the order of the range.
+    template<typename ValueType, typename RandomAccessIterator, typename OutputIterator>
+    OutputIterator extract(RandomAccessIterator first, RandomAccessIterator last, OutputIterator out, std::size_t max_threads = 0)
+    {
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        std::vector<std::vector<const ValueType *> > found(max_threads ? max_threads : (std::max)(std::thread::hardware_concurrency(), 1u));
+        const std::size_t chunks = detail::for_each_chunk(size, found.size(),
+            [first, &found](std::size_t chunk, std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i != end; ++i)
+                {
+                    if (const ValueType * value = boost::any_cast<ValueType>(&first[i]))
+                        found[chunk].push_back(value);
+                }
+            });
+
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            for (std::size_t i = 0; i < found[chunk].size(); ++i)
+                *out++ = *found[chunk][i];
+        }
+        return out;
+    }
+
+    // Writes `transform(value)` to `out` for every held `ValueType`, in the
+    // order of the range. `transform` is called concurrently from several
+    // threads.
+    template<typename ValueType, typename RandomAccessIterator, typename OutputIterator, typename Transform>
+    OutputIterator transform_if(RandomAccessIterator first, RandomAccessIterator last, OutputIterator out,
+        Transform transform, std::size_t max_threads = 0)
+    {
+        typedef typename std::decay<decltype(transform(std::declval<const ValueType &>()))>::type result_type;
+
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        std::vector<std::vector<result_type> > results(max_threads ? max_threads : (std::max)(std::thread::hardware_concurrency(), 1u));
+        const std::size_t chunks = detail::for_each_chunk(size, results.size(),
+            [first, &results, &transform](std::size_t chunk, std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i != end; ++i)
+                {
+                    if (const ValueType * value = boost::any_cast<ValueType>(&first[i]))
+                        results[chunk].push_back(transform(*value));
+                }
+            });
+
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+            out = std::move(results[chunk].begin(), results[chunk].end(), out);
+        return out;
+    }
+
+    // Reorders the range so that elements holding a `ValueType` come first
+    // and returns the end of that group. Like `std::partition` the relative
+    // order is not kept; elements are exchanged by `swap`, which does not
+    // copy the held values.
+    template<typename ValueType, typename RandomAccessIterator>
+    RandomAccessIterator partition_by_type(RandomAccessIterator first, RandomAccessIterator last, std::size_t max_threads = 0)
+    {
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        std::vector<unsigned char> matches(size);
+        detail::for_each_chunk(size, max_threads,
+            [first, &matches](std::size_t, std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i != end; ++i)
+                    matches[i] = detail::holds<ValueType>(first[i]);
+            });
+
+        std::size_t left = 0, right = size;
+        for (;;)
+        {
+            while (left != right && matches[left])
+                ++left;
+            while (left != right && !matches[right - 1])
+                --right;
+            if (left == right)
+                break;
+
+            --right;
+            using std::swap;
+            swap(first[left], first[right]);
+            ++left;
+        }
+        return first + static_cast<std::ptrdiff_t>(left);
+    }
+} // namespace anys
+} // namespace boost
+
+#endif
@@ -0,0 +1,323 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ANY_BASE_CAST_INCLUDED
+#define BOOST_ANY_ANY_BASE_CAST_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Casting the value held by a `boost::any` to one of its base classes.
+// Hierarchies are registered with `BOOST_ANY_REGISTER_BASES(Derived, Bases...)`
+// at namespace scope; bases of bases are found transitively. The path from a
+// held type to a requested base is resolved once and cached in a lock free
+// table per base, which grows with the number of held types, so repeated
+// casts cost one lookup and the pointer adjustments of the path.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) || defined(BOOST_NO_CXX11_VARIADIC_MACROS) \
+    || defined(BOOST_NO_CXX11_HDR_ATOMIC) || defined(BOOST_NO_CXX11_HDR_MUTEX)
+#   error boost::anys::any_base_cast requires C++11 variadic templates and macros, <atomic> and <mutex>
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/detail/type_cache.hpp>
+#include <boost/config/helper_macros.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/is_base_of.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace boost
+{
+namespace anys
+{
+    namespace detail
+    {
+        typedef void * (*upcast_function)(void *);
+        typedef void * (*held_function)(boost::any &);
+
+        template<typename Derived, typename Base>
+        void * upcast(void * value) BOOST_NOEXCEPT
+        {
+            return static_cast<Base *>(static_cast<Derived *>(value));
+        }
+
+        // The held value of an `any` known to hold a `ValueType`
+        template<typename ValueType>
+        void * held_value(boost::any & operand) BOOST_NOEXCEPT
+        {
+            return boost::unsafe_any_cast<ValueType>(&operand);
+        }
+
+        // Path from a held type to a base. `epoch` tells whether a missing
+        // path may have been added by a later registration.
+        struct resolved_upcast
+        {
+            const boost::typeindex::type_info * type;
+            held_function held; // of the held type, if found
+            std::vector<upcast_function> path;
+            bool found;
+            unsigned long epoch;
+
+            void * apply(boost::any & operand) const BOOST_NOEXCEPT
+            {
+                void * value = held(operand);
+                for (std::size_t i = 0; i < path.size(); ++i)
+                    value = path[i](value);
+                return value;
+            }
+        };
+
+        class base_registry
+          : private boost::noncopyable
+        {
+        public: // structors
+
+            // Never destroyed, so that casts remain usable by destructors of
+            // objects with static storage duration.
+            static base_registry & instance()
+            {
+                static base_registry * const registry = new base_registry();
+                return *registry;
+            }
+
+        public: // modifiers
+
+            void add(const boost::typeindex::type_index & derived, held_function held,
+                     const boost::typeindex::type_index & base, upcast_function upcast)
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                registered_type & entry = bases[derived];
+                entry.held = held;
+                for (std::size_t i = 0; i < entry.direct.size(); ++i)
+                {
+                    if (entry.direct[i].first == base)
+                        return;
+                }
+                entry.direct.push_back(std::make_pair(base, upcast));
+                registrations.fetch_add(1, std::memory_order_release);
+            }
+
+            // Keeps a cache entry that was replaced. Other threads may still
+            // be reading it, so it lives as long as the registry.
+            void retire(const resolved_upcast * entry)
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                retired.push_back(entry);
+            }
+
+        public: // queries
+
+            unsigned long epoch() const BOOST_NOEXCEPT
+            {
+                return registrations.load(std::memory_order_acquire);
+            }
+
+            // Depth first in the order of registration, so the first
+            // registered path to an ambiguous base is used.
+            resolved_upcast resolve(const boost::typeindex::type_info & type, const boost::typeindex::type_index & base) const
+            {
+                resolved_upcast result;
+                result.type = &type;
+                result.held = 0;
+
+                std::lock_guard<std::mutex> lock(guard);
+                result.epoch = registrations.load(std::memory_order_relaxed);
+                const bases_type::const_iterator it = bases.find(boost::typeindex::type_index(type));
+                if (it != bases.end())
+                    result.held = it->second.held;
+                result.found = result.held && find_path(boost::typeindex::type_index(type), base, result.path);
+                return result;
+            }
+
+        private: // implementation
+
+            base_registry()
+              : registrations(0)
+            {
+            }
+
+            bool find_path(const boost::typeindex::type_index & from, const boost::typeindex::type_index & to,
+                           std::vector<upcast_function> & path) const
+            {
+                if (from == to)
+                    return true;
+
+                const bases_type::const_iterator it = bases.find(from);
+                if (it == bases.end())
+                    return false;
+
+                const std::vector<std::pair<boost::typeindex::type_index, upcast_function> > & direct = it->second.direct;
+                for (std::size_t i = 0; i < direct.size(); ++i)
+                {
+                    path.push_back(direct[i].second);
+                    if (find_path(direct[i].first, to, path))
+                        return true;
+                    path.pop_back();
+                }
+                return false;
+            }
+
+        private: // representation
+
+            struct registered_type
+            {
+                registered_type() BOOST_NOEXCEPT
+                  : held(0)
+                {
+                }
+
+                held_function held;
+                std::vector<std::pair<boost::typeindex::type_index, upcast_function> > direct;
+            };
+
+            typedef std::map<boost::typeindex::type_index, registered_type> bases_type;
+
+            mutable std::mutex guard;
+            bases_type bases; // direct bases of each registered type
+            std::vector<const resolved_upcast *> retired; // replaced cache entries
+            std::atomic<unsigned long> registrations;
+        };
+
+        // Cache of the paths to `Base`, keyed by the `type_info` of the held
+        // type. Outdated "not found" entries are replaced, and the replaced
+        // ones retired to the registry, which is bounded by the number of
+        // registrations.
+        template<typename Base>
+        class base_cast_cache
+        {
+        public: // queries
+
+            static void * cast(boost::any & operand)
+            {
+                base_registry & registry = base_registry::instance();
+                const boost::typeindex::type_info & type = operand.type();
+
+                for (;;)
+                {
+                    std::atomic<const resolved_upcast *> & slot = cache.slot(type);
+                    const resolved_upcast * entry = slot.load(std::memory_order_acquire);
+                    if (entry && entry->type != &type)
+                        continue; // another type took the slot
+
+                    if (entry && (entry->found || entry->epoch == registry.epoch()))
+                        return entry->found ? entry->apply(operand) : 0;
+
+                    resolved_upcast * const resolved = new resolved_upcast(registry.resolve(type, key()));
+                    if (slot.compare_exchange_strong(entry, resolved, std::memory_order_acq_rel))
+                    {
+                        if (entry)
+                            registry.retire(entry);
+                        else
+                            cache.inserted();
+                        return resolved->found ? resolved->apply(operand) : 0;
+                    }
+                    delete resolved;
+                }
+            }
+
+        private: // implementation
+
+            static const boost::typeindex::type_index & key()
+            {
+                static const boost::typeindex::type_index base = boost::typeindex::type_id<Base>();
+                return base;
+            }
+
+        private: // representation
+
+            static type_cache<resolved_upcast> cache;
+        };
+
+        template<typename Base>
+        type_cache<resolved_upcast> base_cast_cache<Base>::cache;
+
+        template<typename Derived, typename... Bases>
+        struct base_registrar
+        {
+            base_registrar()
+            {
+                const int expand[] = { 0, (base_registrar::add<Bases>(), 0)... };
+                (void)expand;
+            }
+
+            template<typename Base>
+            static void add()
+            {
+                BOOST_STATIC_ASSERT_MSG((boost::is_base_of<Base, Derived>::value),
+                    "BOOST_ANY_REGISTER_BASES: not a base class");
+                base_registry::instance().add(
+                    boost::typeindex::type_id<Derived>(), &detail::held_value<Derived>,
+                    boost::typeindex::type_id<Base>(),
+                    &detail::upcast<Derived, Base>
+                );
+            }
+        };
+    } // namespace detail
+
+    // Pointer to the held value as a `Base`, null if `operand` is empty or
+    // `Base` is neither the held type nor one of its registered bases.
+    template<typename Base>
+    Base * any_base_cast(any * operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_cv<Base>::type base_type;
+
+        if (!operand || operand->empty())
+            return 0;
+        if (base_type * const same = boost::any_cast<base_type>(operand))
+            return same;
+
+        return static_cast<Base *>(static_cast<base_type *>(
+            detail::base_cast_cache<base_type>::cast(*operand)
+        ));
+    }
+
+    template<typename Base>
+    inline const Base * any_base_cast(const any * operand)
+    {
+        return anys::any_base_cast<Base>(const_cast<any *>(operand));
+    }
+
+    // Throws `bad_any_cast` if the held value is not a `Base`.
+    template<typename Base>
+    Base & any_base_cast(any & operand)
+    {
+        Base * const result = anys::any_base_cast<Base>(boost::addressof(operand));
+        if (!result)
+            boost::throw_exception(bad_any_cast());
+        return *result;
+    }
+
+    template<typename Base>
+    inline const Base & any_base_cast(const any & operand)
+    {
+        return anys::any_base_cast<const Base>(const_cast<any &>(operand));
+    }
+} // namespace anys
+
+    using boost::anys::any_base_cast;
+} // namespace boost
+
+// Registers the direct base classes of `Derived` for `any_base_cast`.
+// Use at namespace scope, once per class.
+#define BOOST_ANY_REGISTER_BASES(...)                                         \
+    static const ::boost::anys::detail::base_registrar<__VA_ARGS__>           \
+        BOOST_JOIN(boost_any_register_bases_, __LINE__);                      \
+    /**/
+
+#endif
@@ -0,0 +1,242 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ANY_CAST_ONE_OF_INCLUDED
+#define BOOST_ANY_ANY_CAST_ONE_OF_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Casting an `any` to the first matching type of a candidate list. The stored
+// type is queried once; short lists are then scanned linearly, longer lists
+// are looked up by hash in a table that is sorted on first use.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) || defined(BOOST_NO_CXX11_EXPLICIT_CONVERSION_OPERATORS)
+#   error boost::anys::any_cast_one_of requires C++11 variadic templates and explicit conversion operators
+#endif
+
+#include <boost/any.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <algorithm>
+#include <cstddef>
+
+#ifndef BOOST_ANY_ONE_OF_LINEAR_LIMIT
+// Candidate lists longer than this use the hashed lookup.
+#   define BOOST_ANY_ONE_OF_LINEAR_LIMIT 8
+#endif
+
+namespace boost
+{
+namespace anys
+{
+    // Returned by `any_index_of` when none of the candidates matches.
+    BOOST_STATIC_CONSTEXPR std::size_t any_npos = static_cast<std::size_t>(-1);
+
+    namespace detail
+    {
+        template<std::size_t I, typename... ValueTypes>
+        struct type_at;
+
+        template<typename ValueType, typename... Rest>
+        struct type_at<0, ValueType, Rest...>
+        {
+            typedef ValueType type;
+        };
+
+        template<std::size_t I, typename ValueType, typename... Rest>
+        struct type_at<I, ValueType, Rest...>
+          : type_at<I - 1, Rest...>
+        {
+        };
+
+        template<typename ValueType>
+        void * held_address(any * operand) BOOST_NOEXCEPT
+        {
+            return boost::unsafe_any_cast<ValueType>(operand);
+        }
+
+        template<typename... ValueTypes>
+        void * held_address_at(std::size_t index, any * operand) BOOST_NOEXCEPT
+        {
+            typedef void * (*getter)(any *);
+            static const getter getters[] = {
+                &held_address<BOOST_DEDUCED_TYPENAME boost::remove_cv<ValueTypes>::type>...
+            };
+            return index == any_npos ? 0 : getters[index](operand);
+        }
+
+        template<typename... ValueTypes>
+        std::size_t linear_index_of(const boost::typeindex::type_info& type) BOOST_NOEXCEPT
+        {
+            const boost::typeindex::type_index candidates[] = {
+                boost::typeindex::type_id<ValueTypes>()...
+            };
+            for (std::size_t i = 0; i < sizeof...(ValueTypes); ++i)
+            {
+                if (candidates[i] == type)
+                    return i;
+            }
+            return any_npos;
+        }
+
+        template<typename... ValueTypes>
+        class hashed_index_table
+        {
+        public: // structors
+
+            hashed_index_table()
+            {
+                const boost::typeindex::type_index candidates[] = {
+                    boost::typeindex::type_id<ValueTypes>()...
+                };
+                for (std::size_t i = 0; i < sizeof...(ValueTypes); ++i)
+                {
+                    entries[i].hash = candidates[i].hash_code();
+                    entries[i].type = candidates[i];
+                    entries[i].index = i;
+                }
+                std::sort(entries, entries + sizeof...(ValueTypes), &hash_less);
+            }
+
+        public: // queries
+
+            std::size_t find(const boost::typeindex::type_info& type) const BOOST_NOEXCEPT
+            {
+                const boost::typeindex::type_index key(type);
+                entry probe;
+                probe.hash = key.hash_code();
+                probe.index = 0;
+
+                const entry * it = std::lower_bound(
+                    entries, entries + sizeof...(ValueTypes), probe, &hash_less
+                );
+                for (; it != entries + sizeof...(ValueTypes) && it->hash == probe.hash; ++it)
+                {
+                    if (it->type == key)
+                        return it->index;
+                }
+                return any_npos;
+            }
+
+        private: // representation
+
+            struct entry
+            {
+                std::size_t hash;
+                boost::typeindex::type_index type;
+                std::size_t index;
+            };
+
+            // Ties are ordered by index, so duplicates resolve to the first one
+            static bool hash_less(const entry & lhs, const entry & rhs) BOOST_NOEXCEPT
+            {
+                return lhs.hash < rhs.hash || (lhs.hash == rhs.hash && lhs.index < rhs.index);
+            }
+
+            entry entries[sizeof...(ValueTypes)];
+        };
+
+        template<bool Hashed, typename... ValueTypes>
+        struct index_of_impl
+        {
+            static std::size_t find(const boost::typeindex::type_info& type) BOOST_NOEXCEPT
+            {
+                return detail::linear_index_of<ValueTypes...>(type);
+            }
+        };
+
+        template<typename... ValueTypes>
+        struct index_of_impl<true, ValueTypes...>
+        {
+            static std::size_t find(const boost::typeindex::type_info& type) BOOST_NOEXCEPT
+            {
+                static const hashed_index_table<ValueTypes...> table;
+                return table.find(type);
+            }
+        };
+    } // namespace detail
+
+    // Index of the first of `ValueTypes` that `operand` holds, or `any_npos`.
+    template<typename... ValueTypes>
+    std::size_t any_index_of(const any & operand) BOOST_NOEXCEPT
+    {
+        if (operand.empty())
+            return any_npos;
+
+        return detail::index_of_impl<
+            (sizeof...(ValueTypes) > BOOST_ANY_ONE_OF_LINEAR_LIMIT), ValueTypes...
+        >::find(operand.type());
+    }
+
+    // Result of `any_cast_one_of`: the index of the matched candidate and
+    // a pointer to the held value.
+    template<typename... ValueTypes>
+    class any_one_of_ptr
+    {
+    public: // structors
+
+        any_one_of_ptr(std::size_t index, void * value) BOOST_NOEXCEPT
+          : matched(index), held(value)
+        {
+        }
+
+    public: // queries
+
+        std::size_t index() const BOOST_NOEXCEPT
+        {
+            return matched;
+        }
+
+        explicit operator bool() const BOOST_NOEXCEPT
+        {
+            return matched != any_npos;
+        }
+
+        // Pointer to the held value if candidate `I` matched, null otherwise.
+        template<std::size_t I>
+        typename detail::type_at<I, ValueTypes...>::type * get() const BOOST_NOEXCEPT
+        {
+            return matched == I
+                ? static_cast<typename detail::type_at<I, ValueTypes...>::type *>(held)
+                : 0;
+        }
+
+    private: // representation
+
+        std::size_t matched;
+        void * held;
+    };
+
+    template<typename... ValueTypes>
+    any_one_of_ptr<ValueTypes...> any_cast_one_of(any * operand) BOOST_NOEXCEPT
+    {
+        const std::size_t index = operand ? anys::any_index_of<ValueTypes...>(*operand) : any_npos;
+        return any_one_of_ptr<ValueTypes...>(
+            index, detail::held_address_at<ValueTypes...>(index, operand)
+        );
+    }
+
+    template<typename... ValueTypes>
+    any_one_of_ptr<const ValueTypes...> any_cast_one_of(const any * operand) BOOST_NOEXCEPT
+    {
+        const std::size_t index = operand ? anys::any_index_of<ValueTypes...>(*operand) : any_npos;
+        return any_one_of_ptr<const ValueTypes...>(
+            index, detail::held_address_at<ValueTypes...>(index, const_cast<any *>(operand))
+        );
+    }
+} // namespace anys
+
+    using boost::anys::any_npos;
+    using boost::anys::any_index_of;
+    using boost::anys::any_one_of_ptr;
+    using boost::anys::any_cast_one_of;
+} // namespace boost
+
+#endif
@@ -0,0 +1,405 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ANY_COLUMNIZER_INCLUDED
+#define BOOST_ANY_ANY_COLUMNIZER_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Converts rows of `boost::any` into typed columns. The type of a column is
+// fixed up front or taken from its first non-empty cell; every following
+// cell costs one type check and one copy into a contiguous array. Empty
+// cells and cells of another type are recorded in a null bitmap. Columns
+// hold at most `chunk_rows()` rows, so long tables are converted chunk by
+// chunk with bounded memory.
+//
+// Until its type is named, a column whose type was taken from a cell keeps
+// copies of the `boost::any` cells. The first `column<ValueType>(c)` on a
+// non-const columnizer converts them in one pass, after which the column
+// keeps that type for the next chunks.
+
+#include <boost/config.hpp>
+#include <boost/any.hpp>
+#include <boost/any/detail/any_access.hpp>
+#include <boost/any/detail/type_hash.hpp>
+#include <boost/any/detail/value_ops.hpp>
+#include <boost/assert.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/type_index.hpp>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace boost
+{
+namespace anys
+{
+    class any_columnizer
+      : private boost::noncopyable
+    {
+    public: // constants
+
+        // Alignment of the column arrays, enough for aligned vector loads.
+        BOOST_STATIC_CONSTANT(std::size_t, column_alignment = 64);
+
+    public: // structors
+
+        explicit any_columnizer(std::size_t columns, std::size_t chunk_rows = 4096)
+          : cols(columns)
+          , words((chunk_rows + 63) / 64)
+          , nulls(columns * words)
+          , capacity(chunk_rows)
+          , count(0)
+        {
+            BOOST_ASSERT(chunk_rows);
+        }
+
+        ~any_columnizer() BOOST_NOEXCEPT
+        {
+            clear();
+            for (std::size_t c = 0; c < cols.size(); ++c)
+                ::operator delete(cols[c].block);
+        }
+
+    public: // modifiers
+
+        // Fixes the type of column `c` instead of inferring it from the
+        // first non-empty cell. Only allowed while the chunk is empty.
+        template<typename ValueType>
+        void set_column_type(std::size_t c)
+        {
+            BOOST_ASSERT(c < cols.size());
+            BOOST_ASSERT(!count);
+            column_data & col = cols[c];
+            if (col.held == &any_columnizer::held<ValueType>)
+                return;
+
+            ::operator delete(col.block);
+            col = column_data();
+            adopt(col, detail::value_ops_of<ValueType>::value);
+            col.held = &any_columnizer::held<ValueType>;
+            col.type = &boost::typeindex::type_id<ValueType>().type_info();
+            col.hash = any_columnizer::hash_of<ValueType>();
+        }
+
+        // Appends rows, each a range of `boost::any`, until the chunk is
+        // full. Cells past the end of a short row are null, cells past the
+        // last column are ignored. Returns the first row not appended.
+        // If copying a cell throws, the row is not appended.
+        template<typename RowIterator>
+        RowIterator append(RowIterator first, RowIterator last)
+        {
+            for (; first != last && count != capacity; ++first)
+                append_row(boost::begin(*first), boost::end(*first));
+            return first;
+        }
+
+        // Destroys the values of the current chunk. Column types and
+        // buffers are kept for the next chunk.
+        void clear() BOOST_NOEXCEPT
+        {
+            for (std::size_t c = 0; c < cols.size(); ++c)
+            {
+                column_data & col = cols[c];
+                if (!col.ops)
+                    continue;
+                if (!col.ops->trivial)
+                {
+                    for (std::size_t r = 0; r < count; ++r)
+                    {
+                        if (!is_null_at(c, r))
+                            col.ops->destroy(col.data + r * col.ops->size);
+                    }
+                }
+                std::memset(col.data, 0, count * col.ops->size);
+            }
+            if (!nulls.empty())
+                std::memset(&nulls[0], 0, nulls.size() * sizeof(boost::uint64_t));
+            count = 0;
+        }
+
+    public: // queries
+
+        std::size_t columns() const BOOST_NOEXCEPT
+        {
+            return cols.size();
+        }
+
+        std::size_t rows() const BOOST_NOEXCEPT
+        {
+            return count;
+        }
+
+        std::size_t chunk_rows() const BOOST_NOEXCEPT
+        {
+            return capacity;
+        }
+
+        bool full() const BOOST_NOEXCEPT
+        {
+            return count == capacity;
+        }
+
+        // `void` until the type of the column is known.
+        const boost::typeindex::type_info& column_type(std::size_t c) const BOOST_NOEXCEPT
+        {
+            BOOST_ASSERT(c < cols.size());
+            return cols[c].type ? *cols[c].type : boost::typeindex::type_id<void>().type_info();
+        }
+
+        // `rows()` values, or null if column `c` is not of type `ValueType`.
+        // Null rows of trivially copyable types are zero; for other types
+        // only the non-null rows hold objects. Also null for a column that
+        // still holds copies of its cells, see `column` below.
+        template<typename ValueType>
+        const ValueType * column(std::size_t c) const BOOST_NOEXCEPT
+        {
+            BOOST_ASSERT(c < cols.size());
+            const column_data & col = cols[c];
+            if (!col.held || !any_columnizer::is<ValueType>(col))
+                return 0;
+            return static_cast<const ValueType *>(static_cast<const void *>(col.data));
+        }
+
+        // Converts the copies of the cells of column `c` into values first,
+        // if they are `ValueType`s. If a copy throws, the column is left
+        // as it was.
+        template<typename ValueType>
+        const ValueType * column(std::size_t c)
+        {
+            BOOST_ASSERT(c < cols.size());
+            column_data & col = cols[c];
+            if (!col.held && col.type && any_columnizer::is<ValueType>(col))
+                unbox<ValueType>(c);
+            return static_cast<const any_columnizer &>(*this).column<ValueType>(c);
+        }
+
+        // Bit `r % 64` of word `r / 64` is set if row `r` is null.
+        const boost::uint64_t * null_bitmap(std::size_t c) const BOOST_NOEXCEPT
+        {
+            BOOST_ASSERT(c < cols.size());
+            return &nulls[c * words];
+        }
+
+        bool is_null(std::size_t c, std::size_t r) const BOOST_NOEXCEPT
+        {
+            BOOST_ASSERT(c < cols.size());
+            BOOST_ASSERT(r < count);
+            return is_null_at(c, r);
+        }
+
+        std::size_t null_count(std::size_t c) const BOOST_NOEXCEPT
+        {
+            std::size_t result = 0;
+            for (std::size_t r = 0; r < count; ++r)
+                result += is_null(c, r);
+            return result;
+        }
+
+    private: // types
+
+        // `type` and `ops` are null until the type of the column is known.
+        // `held` is null while the column holds copies of its cells, whose
+        // `ops` are those of `boost::any`. `data` points into `block`,
+        // aligned to `column_alignment`.
+        struct column_data
+        {
+            column_data() BOOST_NOEXCEPT
+              : ops(0), held(0), type(0), hash(0), block(0), data(0)
+            {
+            }
+
+            const detail::value_ops * ops;
+            const void * (*held)(const boost::any & cell);
+            const boost::typeindex::type_info * type;
+            boost::uint64_t hash; // see `hash_of`
+            void * block;
+            char * data;
+        };
+
+    private: // implementation
+
+        // Null if `cell` does not hold a `ValueType`
+        template<typename ValueType>
+        static const void * held(const boost::any & cell) BOOST_NOEXCEPT
+        {
+            return boost::any_cast<ValueType>(&cell);
+        }
+
+        // Without RTTI the `type_hash` of the type, compared before the
+        // names as by `any_cast`; 0 otherwise.
+        template<typename ValueType>
+        static boost::uint64_t hash_of() BOOST_NOEXCEPT
+        {
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+            return detail::type_hash<ValueType>::get();
+#else
+            return 0;
+#endif
+        }
+
+        static boost::uint64_t hash_of(const boost::any & cell) BOOST_NOEXCEPT
+        {
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+            return detail::any_access::type_hash(cell);
+#else
+            (void)cell;
+            return 0;
+#endif
+        }
+
+        static bool same_type(const column_data & col, const boost::typeindex::type_info & type, boost::uint64_t hash) BOOST_NOEXCEPT
+        {
+            return col.hash == hash
+                && (col.type == &type || boost::typeindex::type_index(*col.type) == boost::typeindex::type_index(type));
+        }
+
+        template<typename ValueType>
+        static bool is(const column_data & col) BOOST_NOEXCEPT
+        {
+            return same_type(col, boost::typeindex::type_id<ValueType>().type_info(), any_columnizer::hash_of<ValueType>());
+        }
+
+        void adopt(column_data & col, const detail::value_ops & ops)
+        {
+            const std::size_t alignment = ops.align > column_alignment ? ops.align : column_alignment;
+            const std::size_t bytes = capacity * ops.size;
+            col.block = ::operator new(bytes + alignment - 1);
+            const std::size_t address = reinterpret_cast<std::size_t>(col.block);
+            col.data = static_cast<char *>(col.block) + (detail::align_up(address, alignment) - address);
+            std::memset(col.data, 0, bytes);
+            col.ops = &ops;
+        }
+
+        // Replaces the copies of the cells of column `c` by the values
+        template<typename ValueType>
+        void unbox(std::size_t c)
+        {
+            column_data & col = cols[c];
+            column_data values;
+            adopt(values, detail::value_ops_of<ValueType>::value);
+
+            std::size_t r = 0;
+            BOOST_TRY {
+                for (; r < count; ++r)
+                {
+                    if (!is_null_at(c, r))
+                        ::new(static_cast<void *>(values.data + r * sizeof(ValueType))) ValueType(*boost::unsafe_any_cast<ValueType>(cell_at(col, r)));
+                }
+            } BOOST_CATCH(...) {
+                while (r)
+                {
+                    --r;
+                    if (!is_null_at(c, r))
+                        values.ops->destroy(values.data + r * sizeof(ValueType));
+                }
+                ::operator delete(values.block);
+                BOOST_RETHROW
+            }
+            BOOST_CATCH_END
+
+            for (r = 0; r < count; ++r)
+            {
+                if (!is_null_at(c, r))
+                    cell_at(col, r)->~any();
+            }
+            ::operator delete(col.block);
+            values.held = &any_columnizer::held<ValueType>;
+            values.type = &boost::typeindex::type_id<ValueType>().type_info();
+            values.hash = any_columnizer::hash_of<ValueType>();
+            col = values;
+        }
+
+        static boost::any * cell_at(const column_data & col, std::size_t r) BOOST_NOEXCEPT
+        {
+            return static_cast<boost::any *>(static_cast<void *>(col.data + r * sizeof(boost::any)));
+        }
+
+        void set_null(std::size_t c, std::size_t r) BOOST_NOEXCEPT
+        {
+            nulls[c * words + r / 64] |= boost::uint64_t(1) << (r % 64);
+        }
+
+        template<typename CellIterator>
+        void append_row(CellIterator cell, CellIterator end)
+        {
+            std::size_t c = 0;
+            BOOST_TRY {
+                for (; c < cols.size(); ++c)
+                {
+                    column_data & col = cols[c];
+                    const void * value = 0;
+                    if (cell != end)
+                    {
+                        const boost::any & a = *cell;
+                        ++cell;
+                        if (!a.empty() && !col.type)
+                        {
+                            adopt(col, detail::value_ops_of<boost::any>::value);
+                            col.type = &a.type();
+                            col.hash = any_columnizer::hash_of(a);
+                        }
+                        if (col.held)
+                            value = col.held(a);
+                        else if (!a.empty() && same_type(col, a.type(), any_columnizer::hash_of(a)))
+                            value = &a;
+                    }
+
+                    if (!value)
+                    {
+                        set_null(c, count);
+                        continue;
+                    }
+
+                    void * const dst = col.data + count * col.ops->size;
+                    if (col.ops->trivial)
+                        std::memcpy(dst, value, col.ops->size);
+                    else
+                        col.ops->copy(dst, value);
+                }
+            } BOOST_CATCH(...) {
+                // Cells before `c` were appended, cell `c` was not
+                for (std::size_t i = 0; i < c; ++i)
+                {
+                    if (!is_null_at(i, count))
+                    {
+                        cols[i].ops->destroy(cols[i].data + count * cols[i].ops->size);
+                        std::memset(cols[i].data + count * cols[i].ops->size, 0, cols[i].ops->size);
+                    }
+                    nulls[i * words + count / 64] &= ~(boost::uint64_t(1) << (count % 64));
+                }
+                BOOST_RETHROW
+            }
+            BOOST_CATCH_END
+            ++count;
+        }
+
+        bool is_null_at(std::size_t c, std::size_t r) const BOOST_NOEXCEPT
+        {
+            return (nulls[c * words + r / 64] >> (r % 64)) & 1u;
+        }
+
+    private: // representation
+
+        std::vector<column_data> cols;
+        std::size_t words; // bitmap words per column
+        std::vector<boost::uint64_t> nulls;
+        std::size_t capacity;
+        std::size_t count;
+    };
+} // namespace anys
+
+    using boost::anys::any_columnizer;
+} // namespace boost
+
+#endif
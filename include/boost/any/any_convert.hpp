@@ -0,0 +1,341 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ANY_CONVERT_INCLUDED
+#define BOOST_ANY_ANY_CONVERT_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Conversion of the value held by a `boost::any` to a requested type,
+// whatever convertible type it holds. Converters from `From` to `To` are
+// registered at run time; each `To` has its own dispatch table keyed by the
+// held type, so a conversion is one hash lookup. The lookup result for a
+// held type, including "no conversion", is memoized in a lock free table.
+//
+// Built in are value preserving numeric conversions (`short` to `int`,
+// `int` and `float` to `double`, ...), arithmetic types to `std::string`
+// and `std::string` to arithmetic types with `boost::lexical_cast`. An
+// integer is not converted to a floating point type whose mantissa cannot
+// hold all of its values, e.g. `long long` to `double`.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_HDR_MUTEX) || defined(BOOST_NO_CXX11_HDR_ATOMIC)
+#   error boost::anys::any_convert requires C++11 <mutex> and <atomic>
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/detail/type_cache.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace boost
+{
+namespace anys
+{
+    namespace detail
+    {
+        template<typename To>
+        class conversion_table
+          : private boost::noncopyable
+        {
+        public: // types
+
+            typedef To (*invoker)(void (*convert)(), const boost::any & from);
+
+            // `invoke` is null for "no conversion"
+            struct entry
+            {
+                invoker invoke;
+                void (*convert)();
+            };
+
+        public: // structors
+
+            // Never destroyed, so that conversions remain usable by
+            // destructors of objects with static storage duration.
+            static conversion_table & instance()
+            {
+                static conversion_table * const table = new conversion_table();
+                return *table;
+            }
+
+        public: // modifiers
+
+            // Replaces a converter registered for the same `From`.
+            template<typename From>
+            void add(To (*convert)(const From &))
+            {
+                entry e = { &conversion_table::invoke<From>, reinterpret_cast<void (*)()>(convert) };
+                const boost::typeindex::type_index type = boost::typeindex::type_id<From>();
+
+                std::lock_guard<std::mutex> lock(guard);
+                generation.fetch_add(1, std::memory_order_release); // outdates the cache
+                for (std::size_t i = 0; i < registered.size(); ++i)
+                {
+                    if (registered[i].first == type)
+                    {
+                        registered[i].second = e;
+                        return;
+                    }
+                }
+                registered.push_back(std::make_pair(type, e));
+            }
+
+        public: // queries
+
+            // Takes no lock once the held type was looked up, unless a
+            // converter was added since.
+            entry find(const boost::typeindex::type_info & type) const
+            {
+                for (;;)
+                {
+                    std::atomic<const cached_entry *> & slot = cache.slot(type);
+                    const cached_entry * cached = slot.load(std::memory_order_acquire);
+                    if (cached && cached->type != &type)
+                        continue; // another type took the slot
+                    if (cached && cached->generation == generation.load(std::memory_order_acquire))
+                        return cached->value;
+
+                    std::lock_guard<std::mutex> lock(guard);
+                    cached_entry * const resolved = new cached_entry(resolve(type));
+                    if (slot.compare_exchange_strong(cached, resolved, std::memory_order_acq_rel))
+                    {
+                        if (cached)
+                            retired.push_back(cached);
+                        else
+                            cache.inserted();
+                        return resolved->value;
+                    }
+                    delete resolved;
+                }
+            }
+
+        private: // types
+
+            // Lookup result for a held type, valid while no converter is added
+            struct cached_entry
+            {
+                const boost::typeindex::type_info * type;
+                entry value;
+                unsigned long generation;
+            };
+
+        private: // implementation
+
+            conversion_table();
+
+            template<typename From>
+            static To invoke(void (*convert)(), const boost::any & from)
+            {
+                return reinterpret_cast<To (*)(const From &)>(convert)(*boost::unsafe_any_cast<From>(&from));
+            }
+
+            // The cache is keyed by the address of the `type_info`, which
+            // may differ across shared libraries; this compares the types.
+            // Called with `guard` held.
+            cached_entry resolve(const boost::typeindex::type_info & held) const
+            {
+                cached_entry result = { &held, { 0, 0 }, generation.load(std::memory_order_relaxed) };
+                const boost::typeindex::type_index type(held);
+                for (std::size_t i = 0; i < registered.size(); ++i)
+                {
+                    if (registered[i].first == type)
+                    {
+                        result.value = registered[i].second;
+                        break;
+                    }
+                }
+                return result;
+            }
+
+        private: // representation
+
+            mutable std::mutex guard;
+            std::vector<std::pair<boost::typeindex::type_index, entry> > registered;
+            std::atomic<unsigned long> generation; // of `registered`
+            mutable type_cache<cached_entry> cache;
+            mutable std::vector<const cached_entry *> retired; // replaced cache entries, may still be read
+        };
+
+        // Conversions that keep every value of `From`: to a floating point
+        // type with at least as many mantissa digits and as large exponents,
+        // to an integer with at least as many value bits and a sign if
+        // `From` has one.
+        template<typename From, typename To>
+        struct is_numeric_widening
+          : boost::integral_constant<bool,
+                boost::is_arithmetic<From>::value && boost::is_arithmetic<To>::value
+                && !boost::is_same<From, To>::value && !boost::is_same<To, bool>::value
+                && std::numeric_limits<From>::digits <= std::numeric_limits<To>::digits
+                && (boost::is_floating_point<To>::value
+                    ? std::numeric_limits<From>::max_exponent <= std::numeric_limits<To>::max_exponent
+                    : (boost::is_integral<From>::value
+                        && (!boost::is_signed<From>::value || boost::is_signed<To>::value)))
+            >
+        {
+        };
+
+        template<typename From, typename To>
+        To numeric_conversion(const From & from)
+        {
+            return static_cast<To>(from);
+        }
+
+        template<typename From, typename To>
+        To lexical_conversion(const From & from)
+        {
+            return boost::lexical_cast<To>(from);
+        }
+
+        inline std::string c_string_conversion(const char * const & from)
+        {
+            return from ? std::string(from) : std::string();
+        }
+
+        template<typename From, typename To>
+        void add_widening(conversion_table<To> & table, boost::true_type)
+        {
+            table.template add<From>(&numeric_conversion<From, To>);
+        }
+
+        template<typename From, typename To>
+        void add_widening(conversion_table<To> &, boost::false_type) BOOST_NOEXCEPT
+        {
+        }
+
+        template<typename From, typename To>
+        void add_widening(conversion_table<To> & table)
+        {
+            detail::add_widening<From>(table, detail::is_numeric_widening<From, To>());
+        }
+
+        // `std::string` to arithmetic types
+        template<typename To>
+        void add_string_conversions(conversion_table<To> & table, boost::true_type)
+        {
+            table.template add<std::string>(&lexical_conversion<std::string, To>);
+        }
+
+        template<typename To>
+        void add_string_conversions(conversion_table<To> &, boost::false_type) BOOST_NOEXCEPT
+        {
+        }
+
+        // Arithmetic types to `std::string`
+        inline void add_string_conversions(conversion_table<std::string> & table, boost::false_type)
+        {
+            table.add<const char *>(&c_string_conversion);
+            table.add<short>(&lexical_conversion<short, std::string>);
+            table.add<unsigned short>(&lexical_conversion<unsigned short, std::string>);
+            table.add<int>(&lexical_conversion<int, std::string>);
+            table.add<unsigned int>(&lexical_conversion<unsigned int, std::string>);
+            table.add<long>(&lexical_conversion<long, std::string>);
+            table.add<unsigned long>(&lexical_conversion<unsigned long, std::string>);
+            table.add<long long>(&lexical_conversion<long long, std::string>);
+            table.add<unsigned long long>(&lexical_conversion<unsigned long long, std::string>);
+            table.add<float>(&lexical_conversion<float, std::string>);
+            table.add<double>(&lexical_conversion<double, std::string>);
+            table.add<long double>(&lexical_conversion<long double, std::string>);
+        }
+
+        template<typename To>
+        conversion_table<To>::conversion_table()
+          : generation(0)
+        {
+            detail::add_widening<bool>(*this);
+            detail::add_widening<char>(*this);
+            detail::add_widening<signed char>(*this);
+            detail::add_widening<unsigned char>(*this);
+            detail::add_widening<short>(*this);
+            detail::add_widening<unsigned short>(*this);
+            detail::add_widening<int>(*this);
+            detail::add_widening<unsigned int>(*this);
+            detail::add_widening<long>(*this);
+            detail::add_widening<unsigned long>(*this);
+            detail::add_widening<long long>(*this);
+            detail::add_widening<unsigned long long>(*this);
+            detail::add_widening<float>(*this);
+            detail::add_widening<double>(*this);
+            detail::add_widening<long double>(*this);
+            detail::add_string_conversions(*this, boost::integral_constant<bool,
+                boost::is_arithmetic<To>::value && !boost::is_same<To, bool>::value>());
+        }
+    } // namespace detail
+
+    // Registers a converter from `From` to `To`, replacing a previous one
+    // for the same types. Thread safe.
+    template<typename From, typename To>
+    inline void register_any_conversion(To (*convert)(const From &))
+    {
+        detail::conversion_table<To>::instance().template add<From>(convert);
+    }
+
+    // Returns false if `operand` is empty or there is no conversion from
+    // the held type. Exceptions of the converter are propagated.
+    template<typename To>
+    bool try_any_convert(const boost::any & operand, To & result)
+    {
+        if (operand.empty())
+            return false;
+
+        if (const To * same = boost::any_cast<To>(&operand))
+        {
+            result = *same;
+            return true;
+        }
+
+        const BOOST_DEDUCED_TYPENAME detail::conversion_table<To>::entry e
+            = detail::conversion_table<To>::instance().find(operand.type());
+        if (e.invoke)
+        {
+            result = e.invoke(e.convert, operand);
+            return true;
+        }
+        return false;
+    }
+
+    // Throws `bad_any_cast` if `operand` is empty or there is no
+    // conversion from the held type.
+    template<typename To>
+    To any_convert(const boost::any & operand)
+    {
+        if (!operand.empty())
+        {
+            if (const To * same = boost::any_cast<To>(&operand))
+                return *same;
+
+            const BOOST_DEDUCED_TYPENAME detail::conversion_table<To>::entry e
+                = detail::conversion_table<To>::instance().find(operand.type());
+            if (e.invoke)
+                return e.invoke(e.convert, operand);
+        }
+        boost::throw_exception(bad_any_cast());
+    }
+} // namespace anys
+
+    using boost::anys::register_any_conversion;
+    using boost::anys::try_any_convert;
+    using boost::anys::any_convert;
+} // namespace boost
+
+#endif
@@ -0,0 +1,163 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ANY_HANDLE_INCLUDED
+#define BOOST_ANY_ANY_HANDLE_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Typed access to the value of a `boost::any` that is checked once. The
+// handle remembers the holder of the value; dereferencing it is a plain
+// pointer access, asserted to be still valid in debug builds only.
+// Reassigning, swapping, moving or clearing the `any` makes the handle
+// invalid, `valid()` tells that without a type comparison and `refresh()`
+// redoes the checked cast. A handle stays valid only if the `any` holds a
+// `ValueType` at the same address, which may also be a new value whose
+// holder reuses the memory of the old one.
+
+#include <boost/config.hpp>
+#include <boost/any.hpp>
+#include <boost/any/detail/any_access.hpp>
+#include <boost/assert.hpp>
+#include <boost/core/explicit_operator_bool.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_index.hpp>
+
+namespace boost
+{
+namespace anys
+{
+    template<typename ValueType>
+    class any_handle
+    {
+    public: // types
+
+        typedef ValueType value_type;
+
+        // `const any` for handles to const values
+        typedef BOOST_DEDUCED_TYPENAME boost::conditional<
+            boost::is_const<ValueType>::value, const any, any
+        >::type source_type;
+
+    public: // structors
+
+        any_handle() BOOST_NOEXCEPT
+          : source(0), holder(0), type(0), value(0)
+        {
+        }
+
+        // Empty if `operand` does not hold a `ValueType`.
+        explicit any_handle(source_type & operand) BOOST_NOEXCEPT
+          : source(&operand), holder(0), type(0), value(0)
+        {
+            bind();
+        }
+
+    public: // modifiers
+
+        // Redoes the checked cast of the same `any` if the handle is not
+        // valid any more. Returns false if it does not hold a `ValueType`.
+        bool refresh() BOOST_NOEXCEPT
+        {
+            if (!source)
+                return false;
+            if (!valid())
+                bind();
+            return value != 0;
+        }
+
+        void reset() BOOST_NOEXCEPT
+        {
+            source = 0;
+            holder = 0;
+            type = 0;
+            value = 0;
+        }
+
+    public: // queries
+
+        // The `any` still holds the value the handle was bound to. One
+        // compare of the holder address and one of the address of its type
+        // info, but no type comparison.
+        bool valid() const BOOST_NOEXCEPT
+        {
+            return value
+                && detail::any_access::holder(*source) == holder
+                && &source->type() == type;
+        }
+
+        // Not checked in release builds.
+        ValueType & operator*() const BOOST_NOEXCEPT
+        {
+            BOOST_ASSERT(valid());
+            return *value;
+        }
+
+        ValueType * operator->() const BOOST_NOEXCEPT
+        {
+            BOOST_ASSERT(valid());
+            return value;
+        }
+
+        ValueType * get() const BOOST_NOEXCEPT
+        {
+            BOOST_ASSERT(!value || valid());
+            return value;
+        }
+
+        source_type * any_ptr() const BOOST_NOEXCEPT
+        {
+            return source;
+        }
+
+        // True if the handle was bound to a `ValueType`, even if it is not
+        // valid any more.
+        BOOST_EXPLICIT_OPERATOR_BOOL_NOEXCEPT()
+
+        bool operator!() const BOOST_NOEXCEPT
+        {
+            return !value;
+        }
+
+    private: // implementation
+
+        void bind() BOOST_NOEXCEPT
+        {
+            value = boost::any_cast<BOOST_DEDUCED_TYPENAME remove_cv<ValueType>::type>(source);
+            holder = value ? detail::any_access::holder(*source) : 0;
+            type = value ? &source->type() : 0;
+        }
+
+    private: // representation
+
+        source_type * source;
+        const void * holder;
+        const boost::typeindex::type_info * type; // tells a new holder at the same address
+        ValueType * value;
+    };
+
+    template<typename ValueType>
+    inline any_handle<ValueType> make_any_handle(any & operand) BOOST_NOEXCEPT
+    {
+        return any_handle<ValueType>(operand);
+    }
+
+    template<typename ValueType>
+    inline any_handle<const ValueType> make_any_handle(const any & operand) BOOST_NOEXCEPT
+    {
+        return any_handle<const ValueType>(operand);
+    }
+} // namespace anys
+
+    using boost::anys::any_handle;
+    using boost::anys::make_any_handle;
+} // namespace boost
+
+#endif
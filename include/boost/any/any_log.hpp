@@ -0,0 +1,848 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ANY_LOG_INCLUDED
+#define BOOST_ANY_ANY_LOG_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// An append-only file of `boost::any` values. `any_log_writer` appends
+// records; `any_log_reader` maps the file into memory, indexes every
+// `index_stride`-th record for random access and decodes a record only
+// when asked to, into a `boost::any` or not at all: `any_log_record` is a
+// view of the bytes in the mapping.
+//
+// File format, in the byte order of the writer:
+//
+//   header:  "BOOSTANY", uint32 version, uint32 0x01020304
+//   record:  uint32 type, uint32 size, `size` bytes, zero padding to 8
+//
+// A record of type 0xFFFFFFFF defines the next type id, its bytes are the
+// name of the type; 0xFFFFFFFE is an empty `boost::any`. Types are encoded
+// by codecs registered with `register_any_log_type`, under names that are
+// stored in the file, so that logs can be read by other programs. The
+// arithmetic types and `std::string` are registered by default.
+//
+// A reader does not see records appended after it was opened, nor records
+// still buffered by a writer. An incomplete record at the end of the file,
+// e.g. after a crash, is ignored by readers. An empty file, left by a crash
+// while the log was being created, is read as an empty log.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_HDR_MUTEX) || defined(BOOST_NO_CXX11_HDR_UNORDERED_MAP)
+#   error boost::anys::any_log requires C++11 <mutex> and <unordered_map>
+#endif
+
+#include <boost/any.hpp>
+#include <boost/assert.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/type_traits/has_trivial_copy.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace boost
+{
+namespace anys
+{
+    // Thrown for files that are not logs or are corrupted, for I/O errors
+    // and for types without a codec.
+    class BOOST_SYMBOL_VISIBLE any_log_error
+      : public std::runtime_error
+    {
+    public:
+        explicit any_log_error(const std::string & what)
+          : std::runtime_error("boost::anys::any_log: " + what)
+        {
+        }
+    };
+
+    namespace detail
+    {
+        struct log_record_header
+        {
+            boost::uint32_t type;
+            boost::uint32_t size;
+        };
+
+        BOOST_STATIC_CONSTEXPR boost::uint32_t log_version = 1;
+        BOOST_STATIC_CONSTEXPR boost::uint32_t log_byte_order = 0x01020304;
+        BOOST_STATIC_CONSTEXPR boost::uint32_t log_type_definition = 0xFFFFFFFF;
+        BOOST_STATIC_CONSTEXPR boost::uint32_t log_empty_value = 0xFFFFFFFE;
+        BOOST_STATIC_CONSTEXPR std::size_t log_header_size = 16;
+        BOOST_STATIC_CONSTEXPR std::size_t log_alignment = 8;
+
+        inline std::size_t log_padded(std::size_t size) BOOST_NOEXCEPT
+        {
+            return (size + log_alignment - 1) & ~(log_alignment - 1);
+        }
+
+        // Moves to the end of `file` and returns its size, -1 on failure.
+        // The 64 bit calls, so that logs over 2 GiB work with a 32 bit `long`.
+        inline boost::int64_t log_seek_end(std::FILE * file) BOOST_NOEXCEPT
+        {
+#if defined(BOOST_WINDOWS) && !defined(__CYGWIN__)
+            return ::_fseeki64(file, 0, SEEK_END) ? -1 : static_cast<boost::int64_t>(::_ftelli64(file));
+#else
+            return ::fseeko(file, 0, SEEK_END) ? -1 : static_cast<boost::int64_t>(::ftello(file));
+#endif
+        }
+
+        // -1 if there is no such file. Throws `any_log_error` if the file
+        // exists but its size cannot be queried.
+        inline boost::int64_t log_file_size(const std::string & path)
+        {
+            errno = 0;
+            std::FILE * const file = std::fopen(path.c_str(), "rb");
+            if (!file)
+            {
+                if (errno == ENOENT)
+                    return -1;
+                boost::throw_exception(any_log_error("cannot open " + path));
+            }
+
+            const boost::int64_t size = log_seek_end(file);
+            std::fclose(file);
+            if (size < 0)
+                boost::throw_exception(any_log_error("cannot get the size of " + path));
+            return size;
+        }
+
+        template<typename ValueType>
+        const void * log_held(const boost::any & operand) BOOST_NOEXCEPT
+        {
+            return boost::unsafe_any_cast<ValueType>(&operand);
+        }
+
+        // How the values of one type are stored. `encode` and `decode` are
+        // the functions given to `register_any_log_type`, if any; `held`
+        // finds the value in a `boost::any` of the type.
+        struct log_codec
+        {
+            std::string name;
+            boost::typeindex::type_index type;
+            const void * (*held)(const boost::any & operand);
+            void (*encode)();
+            void (*decode)();
+            void (*write)(const log_codec & self, const void * value, std::string & out);
+            void (*read)(const log_codec & self, const char * data, std::size_t size, boost::any & out);
+        };
+
+        template<typename ValueType>
+        struct trivial_log_codec
+        {
+            static void write(const log_codec &, const void * value, std::string & out)
+            {
+                out.append(static_cast<const char *>(value), sizeof(ValueType));
+            }
+
+            static void read(const log_codec & self, const char * data, std::size_t size, boost::any & out)
+            {
+                if (size != sizeof(ValueType))
+                    boost::throw_exception(any_log_error("wrong size of a " + self.name));
+
+                ValueType value;
+                std::memcpy(static_cast<void *>(&value), data, sizeof(ValueType));
+                out = value;
+            }
+        };
+
+        struct string_log_codec
+        {
+            static void write(const log_codec &, const void * value, std::string & out)
+            {
+                out.append(*static_cast<const std::string *>(value));
+            }
+
+            static void read(const log_codec &, const char * data, std::size_t size, boost::any & out)
+            {
+                out = std::string(data, size);
+            }
+        };
+
+        template<typename ValueType>
+        struct user_log_codec
+        {
+            typedef void (*encoder)(const ValueType &, std::string &);
+            typedef ValueType (*decoder)(const char *, std::size_t);
+
+            static void write(const log_codec & self, const void * value, std::string & out)
+            {
+                reinterpret_cast<encoder>(self.encode)(*static_cast<const ValueType *>(value), out);
+            }
+
+            static void read(const log_codec & self, const char * data, std::size_t size, boost::any & out)
+            {
+                out = reinterpret_cast<decoder>(self.decode)(data, size);
+            }
+        };
+
+        class log_codec_registry
+          : private boost::noncopyable
+        {
+        public: // structors
+
+            // Never destroyed, so that logs remain usable by destructors of
+            // objects with static storage duration.
+            static log_codec_registry & instance()
+            {
+                static log_codec_registry * const registry = new log_codec_registry();
+                return *registry;
+            }
+
+        public: // modifiers
+
+            // Replaces the codec of the type, and of the name
+            void add(const log_codec & codec)
+            {
+                const log_codec * const stored = new log_codec(codec);
+                std::lock_guard<std::mutex> lock(guard);
+                by_type[codec.type] = stored;
+                by_name[codec.name] = stored;
+            }
+
+            template<typename ValueType>
+            void add_trivial(const char * name)
+            {
+                const log_codec codec = {
+                    name, boost::typeindex::type_id<ValueType>(), &log_held<ValueType>, 0, 0,
+                    &trivial_log_codec<ValueType>::write, &trivial_log_codec<ValueType>::read
+                };
+                add(codec);
+            }
+
+        public: // queries
+
+            // Null if the type has no codec
+            const log_codec * find(const boost::typeindex::type_index & type) const
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                const std::map<boost::typeindex::type_index, const log_codec *>::const_iterator it = by_type.find(type);
+                return it == by_type.end() ? 0 : it->second;
+            }
+
+            const log_codec * find(const std::string & name) const
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                const std::unordered_map<std::string, const log_codec *>::const_iterator it = by_name.find(name);
+                return it == by_name.end() ? 0 : it->second;
+            }
+
+        private: // implementation
+
+            log_codec_registry()
+            {
+                add_trivial<bool>("bool");
+                add_trivial<char>("char");
+                add_trivial<signed char>("signed char");
+                add_trivial<unsigned char>("unsigned char");
+                add_trivial<short>("short");
+                add_trivial<unsigned short>("unsigned short");
+                add_trivial<int>("int");
+                add_trivial<unsigned int>("unsigned int");
+                add_trivial<long>("long");
+                add_trivial<unsigned long>("unsigned long");
+                add_trivial<long long>("long long");
+                add_trivial<unsigned long long>("unsigned long long");
+                add_trivial<float>("float");
+                add_trivial<double>("double");
+
+                const log_codec text = {
+                    "std::string", boost::typeindex::type_id<std::string>(), &log_held<std::string>, 0, 0,
+                    &string_log_codec::write, &string_log_codec::read
+                };
+                add(text);
+            }
+
+        private: // representation
+
+            mutable std::mutex guard;
+            std::map<boost::typeindex::type_index, const log_codec *> by_type;
+            std::unordered_map<std::string, const log_codec *> by_name;
+        };
+    } // namespace detail
+
+    // Stores `ValueType` as its bytes under `name`
+    template<typename ValueType>
+    void register_any_log_type(const std::string & name)
+    {
+        BOOST_STATIC_ASSERT_MSG(
+            boost::has_trivial_copy<ValueType>::value && boost::has_trivial_destructor<ValueType>::value,
+            "boost::anys::register_any_log_type: types that are not trivially copyable need an encoder and a decoder"
+        );
+        const detail::log_codec codec = {
+            name, boost::typeindex::type_id<ValueType>(), &detail::log_held<ValueType>, 0, 0,
+            &detail::trivial_log_codec<ValueType>::write, &detail::trivial_log_codec<ValueType>::read
+        };
+        detail::log_codec_registry::instance().add(codec);
+    }
+
+    // Stores `ValueType` under `name` as the bytes appended by `encode`,
+    // which `decode` is given back
+    template<typename ValueType>
+    void register_any_log_type(const std::string & name,
+        void (*encode)(const ValueType &, std::string &),
+        ValueType (*decode)(const char *, std::size_t))
+    {
+        BOOST_ASSERT(encode && decode);
+        const detail::log_codec codec = {
+            name, boost::typeindex::type_id<ValueType>(), &detail::log_held<ValueType>,
+            reinterpret_cast<void (*)()>(encode), reinterpret_cast<void (*)()>(decode),
+            &detail::user_log_codec<ValueType>::write, &detail::user_log_codec<ValueType>::read
+        };
+        detail::log_codec_registry::instance().add(codec);
+    }
+
+    class any_log_reader;
+
+    // A record in the mapping of an `any_log_reader`, valid as long as the
+    // reader is
+    class any_log_record
+    {
+    public: // queries
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return type == detail::log_empty_value;
+        }
+
+        // Empty for an empty value
+        const std::string & type_name() const;
+
+        // The encoded value
+        const char * data() const BOOST_NOEXCEPT
+        {
+            return payload;
+        }
+
+        std::size_t size() const BOOST_NOEXCEPT
+        {
+            return length;
+        }
+
+        // Whether the value was stored with the codec of `ValueType`
+        template<typename ValueType>
+        bool is() const;
+
+        // The value in place, for trivially copyable types; null if the
+        // record holds another type
+        template<typename ValueType>
+        const ValueType * get() const
+        {
+            BOOST_STATIC_ASSERT_MSG(
+                boost::has_trivial_copy<ValueType>::value && boost::has_trivial_destructor<ValueType>::value
+                    && boost::alignment_of<ValueType>::value <= detail::log_alignment,
+                "boost::anys::any_log_record::get requires a trivially copyable type aligned to at most 8"
+            );
+            return is<ValueType>() && length == sizeof(ValueType)
+                ? static_cast<const ValueType *>(static_cast<const void *>(payload))
+                : 0;
+        }
+
+        // Throws `any_log_error` if the type has no codec
+        boost::any to_any() const;
+
+    private: // representation
+
+        friend class any_log_reader;
+
+        any_log_record(const any_log_reader & log, boost::uint32_t type, const char * payload, std::size_t length) BOOST_NOEXCEPT
+          : log(&log)
+          , type(type)
+          , payload(payload)
+          , length(length)
+        {
+        }
+
+        const any_log_reader * log;
+        boost::uint32_t type;
+        const char * payload;
+        std::size_t length;
+    };
+
+    class any_log_reader
+      : private boost::noncopyable
+    {
+    public: // types
+
+        class const_iterator
+        {
+        public: // types
+
+            typedef std::input_iterator_tag iterator_category;
+            typedef any_log_record value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const any_log_record * pointer;
+            typedef any_log_record reference;
+
+        public: // structors
+
+            const_iterator() BOOST_NOEXCEPT
+              : log(0)
+              , offset(0)
+            {
+            }
+
+        public: // queries
+
+            any_log_record operator*() const
+            {
+                return log->record_at(offset);
+            }
+
+            const_iterator & operator++()
+            {
+                offset = log->next_value(log->next(offset));
+                return *this;
+            }
+
+            const_iterator operator++(int)
+            {
+                const const_iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            friend bool operator==(const const_iterator & lhs, const const_iterator & rhs) BOOST_NOEXCEPT
+            {
+                return lhs.offset == rhs.offset;
+            }
+
+            friend bool operator!=(const const_iterator & lhs, const const_iterator & rhs) BOOST_NOEXCEPT
+            {
+                return lhs.offset != rhs.offset;
+            }
+
+        private: // representation
+
+            friend class any_log_reader;
+
+            const_iterator(const any_log_reader & log, std::size_t offset) BOOST_NOEXCEPT
+              : log(&log)
+              , offset(offset)
+            {
+            }
+
+            const any_log_reader * log;
+            std::size_t offset;
+        };
+
+    public: // structors
+
+        // Maps the file and reads the headers of all the records
+        explicit any_log_reader(const std::string & path, std::size_t index_stride = 64)
+          : base(0)
+          , length(0)
+          , stride(index_stride ? index_stride : 1)
+          , records(0)
+        {
+            if (detail::log_file_size(path) == 0)
+                return; // nothing to map
+
+            BOOST_TRY
+            {
+                mapping = boost::interprocess::file_mapping(path.c_str(), boost::interprocess::read_only);
+                region = boost::interprocess::mapped_region(mapping, boost::interprocess::read_only);
+            }
+            BOOST_CATCH (const boost::interprocess::interprocess_exception & e)
+            {
+                boost::throw_exception(any_log_error("cannot map " + path + ": " + e.what()));
+            }
+            BOOST_CATCH_END
+
+            base = static_cast<const char *>(region.get_address());
+            const std::size_t mapped = region.get_size();
+            if (mapped < detail::log_header_size || std::memcmp(base, "BOOSTANY", 8))
+                boost::throw_exception(any_log_error(path + " is not a log"));
+
+            boost::uint32_t version, byte_order;
+            std::memcpy(&version, base + 8, 4);
+            std::memcpy(&byte_order, base + 12, 4);
+            if (version != detail::log_version || byte_order != detail::log_byte_order)
+                boost::throw_exception(any_log_error(path + " has an unsupported version or byte order"));
+
+            std::size_t offset = detail::log_header_size;
+            while (offset + sizeof(detail::log_record_header) <= mapped)
+            {
+                const detail::log_record_header h = header(offset);
+                const std::size_t end = offset + sizeof(detail::log_record_header) + detail::log_padded(h.size);
+                if (end > mapped)
+                    break; // incomplete
+
+                if (h.type == detail::log_type_definition)
+                {
+                    names.push_back(std::string(base + offset + sizeof(detail::log_record_header), h.size));
+                    codecs.push_back(detail::log_codec_registry::instance().find(names.back()));
+                }
+                else
+                {
+                    if (h.type != detail::log_empty_value && h.type >= names.size())
+                        boost::throw_exception(any_log_error(path + " is corrupted"));
+                    if (records % stride == 0)
+                        index.push_back(offset);
+                    ++records;
+                }
+                offset = end;
+            }
+            length = offset;
+        }
+
+    public: // queries
+
+        // Number of values
+        std::size_t size() const BOOST_NOEXCEPT
+        {
+            return records;
+        }
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return !records;
+        }
+
+        // Walks at most `index_stride - 1` records from an indexed one
+        any_log_record operator[](std::size_t position) const
+        {
+            BOOST_ASSERT(position < records);
+            std::size_t offset = index[position / stride];
+            for (std::size_t i = position % stride; i; --i)
+                offset = next_value(next(offset));
+            return record_at(offset);
+        }
+
+        any_log_record at(std::size_t position) const
+        {
+            if (position >= records)
+                boost::throw_exception(std::out_of_range("boost::anys::any_log_reader::at"));
+            return (*this)[position];
+        }
+
+        const_iterator begin() const BOOST_NOEXCEPT
+        {
+            return const_iterator(*this, length ? next_value(detail::log_header_size) : 0);
+        }
+
+        const_iterator end() const BOOST_NOEXCEPT
+        {
+            return const_iterator(*this, length);
+        }
+
+        // The types defined in the file, by id
+        std::size_t type_count() const BOOST_NOEXCEPT
+        {
+            return names.size();
+        }
+
+        const std::string & type_name(std::size_t type) const
+        {
+            BOOST_ASSERT(type < names.size());
+            return names[type];
+        }
+
+        // Bytes of complete records, including the header of the file
+        std::size_t valid_size() const BOOST_NOEXCEPT
+        {
+            return length;
+        }
+
+    private: // implementation
+
+        friend class any_log_record;
+
+        detail::log_record_header header(std::size_t offset) const BOOST_NOEXCEPT
+        {
+            detail::log_record_header h;
+            std::memcpy(&h, base + offset, sizeof(h));
+            return h;
+        }
+
+        std::size_t next(std::size_t offset) const BOOST_NOEXCEPT
+        {
+            return offset + sizeof(detail::log_record_header) + detail::log_padded(header(offset).size);
+        }
+
+        // The first record at or after `offset` that is not a type definition
+        std::size_t next_value(std::size_t offset) const BOOST_NOEXCEPT
+        {
+            while (offset < length && header(offset).type == detail::log_type_definition)
+                offset = next(offset);
+            return offset;
+        }
+
+        any_log_record record_at(std::size_t offset) const BOOST_NOEXCEPT
+        {
+            const detail::log_record_header h = header(offset);
+            return any_log_record(*this, h.type, base + offset + sizeof(detail::log_record_header), h.size);
+        }
+
+    private: // representation
+
+        boost::interprocess::file_mapping mapping;
+        boost::interprocess::mapped_region region;
+        const char * base;
+        std::size_t length;
+
+        std::vector<std::string> names;                 // by type id
+        std::vector<const detail::log_codec *> codecs;  // by type id, null if not registered
+        std::vector<std::size_t> index;                 // offsets of every `stride`-th value
+        std::size_t stride;
+        std::size_t records;
+    };
+
+    inline const std::string & any_log_record::type_name() const
+    {
+        static const std::string none;
+        return empty() ? none : log->names[type];
+    }
+
+    template<typename ValueType>
+    bool any_log_record::is() const
+    {
+        const detail::log_codec * const codec = empty() ? 0 : log->codecs[type];
+        return codec && codec->type == boost::typeindex::type_id<BOOST_DEDUCED_TYPENAME boost::decay<ValueType>::type>();
+    }
+
+    inline boost::any any_log_record::to_any() const
+    {
+        boost::any result;
+        if (empty())
+            return result;
+
+        const detail::log_codec * const codec = log->codecs[type];
+        if (!codec)
+            boost::throw_exception(any_log_error("no codec for " + log->names[type]));
+        codec->read(*codec, payload, length, result);
+        return result;
+    }
+
+    class any_log_writer
+      : private boost::noncopyable
+    {
+    public: // structors
+
+        // Creates the file, or appends to it if it is a log. The header of a
+        // new file is written at once, an empty file is given one. A file is
+        // never truncated: one created by another writer in the meantime is
+        // an error.
+        explicit any_log_writer(const std::string & path)
+          : file(0)
+          , records(0)
+        {
+            const boost::int64_t size = detail::log_file_size(path);
+            if (size > 0)
+            {
+                const any_log_reader log(path, static_cast<std::size_t>(-1));
+                for (std::size_t i = 0; i < log.type_count(); ++i)
+                    names[log.type_name(i)] = static_cast<boost::uint32_t>(i);
+                records = log.size();
+
+                // Where "ab" starts is implementation-defined until the
+                // first write
+                open(path, "ab", "cannot open ");
+                const boost::int64_t end = detail::log_seek_end(file);
+                if (end < 0 || static_cast<boost::uint64_t>(end) != log.valid_size())
+                {
+                    std::fclose(file);
+                    boost::throw_exception(any_log_error(path + (end < 0
+                        ? " cannot be appended to" : " ends with an incomplete record")));
+                }
+                return;
+            }
+
+            if (size == 0)
+            {
+                // Left by a crash while the log was being created
+                open(path, "r+b", "cannot open ");
+                if (detail::log_seek_end(file) != 0)
+                {
+                    std::fclose(file);
+                    boost::throw_exception(any_log_error(path + " was written while being opened"));
+                }
+            }
+            else
+            {
+                open(path, "wbx", "cannot create ");
+            }
+
+            char header[detail::log_header_size];
+            std::memcpy(header, "BOOSTANY", 8);
+            std::memcpy(header + 8, &detail::log_version, 4);
+            std::memcpy(header + 12, &detail::log_byte_order, 4);
+            if (std::fwrite(header, 1, sizeof(header), file) != sizeof(header) || std::fflush(file))
+            {
+                std::fclose(file);
+                boost::throw_exception(any_log_error("cannot write " + path));
+            }
+        }
+
+        // Writes the buffered records; errors are ignored
+        ~any_log_writer() BOOST_NOEXCEPT
+        {
+            if (!buffer.empty())
+                std::fwrite(buffer.data(), 1, buffer.size(), file);
+            std::fclose(file);
+        }
+
+    public: // modifiers
+
+        // Throws `any_log_error` if the type has no codec
+        template<typename ValueType>
+        void append(const ValueType & value)
+        {
+            typedef BOOST_DEDUCED_TYPENAME boost::decay<ValueType>::type value_type;
+            append_value(entry(boost::typeindex::type_id<value_type>().type_info()), &value);
+        }
+
+        void append(const boost::any & value)
+        {
+            if (value.empty())
+            {
+                append_record(detail::log_empty_value, 0, 0);
+                return;
+            }
+            const type_entry & e = entry(value.type());
+            append_value(e, e.codec->held(value));
+        }
+
+        // Writes the buffered records to the file
+        void flush()
+        {
+            write_buffer();
+            if (std::fflush(file))
+                boost::throw_exception(any_log_error("cannot write"));
+        }
+
+    public: // queries
+
+        // Number of values in the file, buffered ones included
+        std::size_t size() const BOOST_NOEXCEPT
+        {
+            return records;
+        }
+
+    private: // implementation
+
+        BOOST_STATIC_CONSTEXPR std::size_t buffer_size = 1 << 20;
+
+        // "x" makes `fopen` fail if the file exists (C11)
+        void open(const std::string & path, const char * mode, const char * error)
+        {
+            file = std::fopen(path.c_str(), mode);
+            if (!file)
+                boost::throw_exception(any_log_error(error + path));
+        }
+
+        struct type_entry
+        {
+            boost::uint32_t id;
+            const detail::log_codec * codec;
+        };
+
+        const type_entry & entry(const boost::typeindex::type_info & type)
+        {
+            std::unordered_map<const boost::typeindex::type_info *, type_entry>::iterator it = types.find(&type);
+            if (it == types.end())
+                it = types.insert(std::make_pair(&type, define(type))).first;
+            return it->second;
+        }
+
+        void append_value(const type_entry & e, const void * value)
+        {
+            payload.clear();
+            e.codec->write(*e.codec, value, payload);
+            append_record(e.id, payload.data(), payload.size());
+        }
+
+        // Writes the definition of the type unless the file has it already
+        type_entry define(const boost::typeindex::type_info & type)
+        {
+            const detail::log_codec * const codec
+                = detail::log_codec_registry::instance().find(boost::typeindex::type_index(type));
+            if (!codec)
+            {
+                boost::throw_exception(any_log_error(
+                    "no codec for " + boost::typeindex::type_index(type).pretty_name()));
+            }
+
+            const std::unordered_map<std::string, boost::uint32_t>::const_iterator it = names.find(codec->name);
+            if (it != names.end())
+            {
+                const type_entry existing = { it->second, codec };
+                return existing;
+            }
+
+            const type_entry defined = { static_cast<boost::uint32_t>(names.size()), codec };
+            write_record(detail::log_type_definition, codec->name.data(), codec->name.size());
+            names[codec->name] = defined.id;
+            return defined;
+        }
+
+        void append_record(boost::uint32_t type, const char * data, std::size_t size)
+        {
+            write_record(type, data, size);
+            ++records;
+        }
+
+        void write_record(boost::uint32_t type, const char * data, std::size_t size)
+        {
+            if (size > 0xFFFFFFFFu)
+                boost::throw_exception(any_log_error("a record of 4GB or more"));
+
+            const detail::log_record_header h = { type, static_cast<boost::uint32_t>(size) };
+            buffer.append(reinterpret_cast<const char *>(&h), sizeof(h));
+            buffer.append(data, size);
+            buffer.append(detail::log_padded(size) - size, '\0');
+            if (buffer.size() >= buffer_size)
+                write_buffer();
+        }
+
+        void write_buffer()
+        {
+            if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size())
+                boost::throw_exception(any_log_error("cannot write"));
+            buffer.clear();
+        }
+
+    private: // representation
+
+        std::FILE * file;
+        std::string buffer;   // records not written to `file` yet
+        std::string payload;  // encoded value, reused
+        std::unordered_map<const boost::typeindex::type_info *, type_entry> types;
+        std::unordered_map<std::string, boost::uint32_t> names;
+        std::size_t records;
+    };
+} // namespace anys
+
+    using boost::anys::any_log_error;
+    using boost::anys::any_log_reader;
+    using boost::anys::any_log_record;
+    using boost::anys::any_log_writer;
+    using boost::anys::register_any_log_type;
+} // namespace boost
+
+#endif
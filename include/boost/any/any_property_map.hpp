@@ -0,0 +1,602 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ANY_PROPERTY_MAP_INCLUDED
+#define BOOST_ANY_ANY_PROPERTY_MAP_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// A small record of named heterogeneous values. Names are interned once per
+// process into `property_key`s; a map keeps its keys in a sorted flat array
+// and the values in a single arena next to it. Small values that can be
+// moved without throwing are stored in the arena directly, others are stored
+// there as a `boost::any`, as is a `boost::any` inserted into the map: its
+// view is the value it holds. Copying a map costs two allocations plus the
+// copies of the boxed values.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_HDR_MUTEX) \
+    || defined(BOOST_NO_CXX11_HDR_ATOMIC)
+#   error boost::anys::any_property_map requires C++11 rvalue references, <mutex> and <atomic>
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/any_view.hpp>
+#include <boost/any/detail/any_access.hpp>
+#include <boost/any/detail/type_hash.hpp>
+#include <boost/any/detail/value_ops.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_nothrow_move_constructible.hpp>
+#include <boost/utility/string_view.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace boost
+{
+namespace anys
+{
+    namespace detail
+    {
+        // Process-wide table of interned property names. Names are never
+        // removed and the table is never destroyed, so their addresses stay
+        // valid. Each bucket is a list that only grows at its head, published
+        // with a release store: lookups of interned names take no lock, only
+        // interning a new name does.
+        class property_key_registry
+        {
+        public: // singleton access
+
+            static property_key_registry & instance()
+            {
+                static property_key_registry * const singleton = new property_key_registry();
+                return *singleton;
+            }
+
+        public: // interning
+
+            const std::string * intern(boost::string_view name, boost::uint32_t & id)
+            {
+                const boost::uint64_t hash = anys::detail::fnv1a_hash(name.data(), name.size());
+                std::atomic<const interned_name *> & head = bucket(hash);
+                if (const std::string * found = find_in(head.load(std::memory_order_acquire), hash, name, id))
+                    return found;
+
+                std::lock_guard<std::mutex> lock(guard);
+                const interned_name * const first = head.load(std::memory_order_relaxed);
+                if (const std::string * found = find_in(first, hash, name, id))
+                    return found;
+
+                const interned_name * const fresh = new interned_name(hash, count, name, first);
+                head.store(fresh, std::memory_order_release);
+                id = count++;
+                return &fresh->name;
+            }
+
+            // Does not intern `name`; null if it was never interned.
+            const std::string * find(boost::string_view name, boost::uint32_t & id) const
+            {
+                const boost::uint64_t hash = anys::detail::fnv1a_hash(name.data(), name.size());
+                return find_in(bucket(hash).load(std::memory_order_acquire), hash, name, id);
+            }
+
+        private: // types
+
+            struct interned_name
+            {
+                interned_name(boost::uint64_t hash, boost::uint32_t id, boost::string_view name, const interned_name * next)
+                  : hash(hash), id(id), name(name.data(), name.size()), next(next)
+                {
+                }
+
+                const boost::uint64_t hash;
+                const boost::uint32_t id;
+                const std::string name;
+                const interned_name * const next;
+            };
+
+            BOOST_STATIC_CONSTANT(std::size_t, bucket_count = 512);
+
+        private: // implementation
+
+            property_key_registry()
+              : count(0)
+            {
+                for (std::size_t i = 0; i < bucket_count; ++i)
+                    buckets[i].store(0, std::memory_order_relaxed);
+            }
+
+            std::atomic<const interned_name *> & bucket(boost::uint64_t hash) const
+            {
+                return buckets[static_cast<std::size_t>(hash ^ (hash >> 32)) % bucket_count];
+            }
+
+            static const std::string * find_in(const interned_name * entry, boost::uint64_t hash,
+                                               boost::string_view name, boost::uint32_t & id)
+            {
+                for (; entry; entry = entry->next)
+                {
+                    if (entry->hash == hash && boost::string_view(entry->name) == name)
+                    {
+                        id = entry->id;
+                        return &entry->name;
+                    }
+                }
+                return 0;
+            }
+
+        private: // prevention
+
+            property_key_registry(const property_key_registry &);
+            property_key_registry & operator=(const property_key_registry &);
+
+        private: // representation
+
+            std::mutex guard; // serializes interning
+            mutable std::atomic<const interned_name *> buckets[bucket_count];
+            boost::uint32_t count;
+        };
+    } // namespace detail
+
+    // An interned property name. Keys made from equal names compare equal
+    // by their ids.
+    class property_key
+    {
+    public: // structors
+
+        // Interns `name` if it was not interned yet.
+        explicit property_key(boost::string_view name)
+          : key_name(detail::property_key_registry::instance().intern(name, key_id))
+        {
+        }
+
+        // Looks `name` up without interning it. Returns false if no key
+        // with that name was ever made.
+        static bool find(boost::string_view name, property_key & result)
+        {
+            boost::uint32_t id;
+            if (const std::string * found = detail::property_key_registry::instance().find(name, id))
+            {
+                result = property_key(id, found);
+                return true;
+            }
+            return false;
+        }
+
+    public: // queries
+
+        boost::uint32_t id() const BOOST_NOEXCEPT
+        {
+            return key_id;
+        }
+
+        boost::string_view name() const BOOST_NOEXCEPT
+        {
+            return *key_name;
+        }
+
+        friend bool operator==(const property_key & lhs, const property_key & rhs) BOOST_NOEXCEPT
+        {
+            return lhs.key_id == rhs.key_id;
+        }
+
+        friend bool operator!=(const property_key & lhs, const property_key & rhs) BOOST_NOEXCEPT
+        {
+            return lhs.key_id != rhs.key_id;
+        }
+
+        // Orders by interning order, not by name.
+        friend bool operator<(const property_key & lhs, const property_key & rhs) BOOST_NOEXCEPT
+        {
+            return lhs.key_id < rhs.key_id;
+        }
+
+    private: // implementation
+
+        friend class any_property_map;
+
+        property_key(boost::uint32_t id, const std::string * name) BOOST_NOEXCEPT
+          : key_id(id), key_name(name)
+        {
+        }
+
+    private: // representation
+
+        boost::uint32_t key_id;
+        const std::string * key_name;
+    };
+
+    class any_property_map
+    {
+    public: // types
+
+        // Values up to this size that can be moved without throwing are
+        // stored in the arena directly.
+        BOOST_STATIC_CONSTANT(std::size_t, inline_size = 4 * sizeof(void *));
+
+        template<typename ValueType>
+        struct is_stored_inline
+          : boost::integral_constant<bool,
+                sizeof(ValueType) <= inline_size
+                && boost::alignment_of<ValueType>::value <= boost::alignment_of<detail::max_align>::value
+                && boost::is_nothrow_move_constructible<ValueType>::value
+            >
+        {
+        };
+
+    public: // structors
+
+        any_property_map() BOOST_NOEXCEPT
+          : arena(0), arena_size(0), arena_used(0)
+        {
+        }
+
+        // Lays the values of `other` out one after another in a single
+        // new arena.
+        any_property_map(const any_property_map & other)
+          : fields(other.fields), arena(0), arena_size(0), arena_used(0)
+        {
+            std::size_t size = 0;
+            for (std::size_t i = 0; i < fields.size(); ++i)
+                size += slot_size(*fields[i].ops);
+            reserve_arena(size);
+
+            std::size_t copied = 0;
+            BOOST_TRY {
+                for (; copied < fields.size(); ++copied)
+                {
+                    field & f = fields[copied];
+                    f.ops->copy(arena_at(arena_used), other.stored_at(f));
+                    f.offset = static_cast<boost::uint32_t>(arena_used);
+                    arena_used += slot_size(*f.ops);
+                }
+            } BOOST_CATCH(...) {
+                fields.resize(copied);
+                destroy();
+                BOOST_RETHROW
+            }
+            BOOST_CATCH_END
+        }
+
+        any_property_map(any_property_map&& other) BOOST_NOEXCEPT
+          : arena(0), arena_size(0), arena_used(0)
+        {
+            swap(other);
+        }
+
+        ~any_property_map() BOOST_NOEXCEPT
+        {
+            destroy();
+        }
+
+    public: // modifiers
+
+        any_property_map & swap(any_property_map & rhs) BOOST_NOEXCEPT
+        {
+            fields.swap(rhs.fields);
+            std::swap(arena, rhs.arena);
+            std::swap(arena_size, rhs.arena_size);
+            std::swap(arena_used, rhs.arena_used);
+            return *this;
+        }
+
+        any_property_map & operator=(const any_property_map & rhs)
+        {
+            any_property_map(rhs).swap(*this);
+            return *this;
+        }
+
+        any_property_map & operator=(any_property_map&& rhs) BOOST_NOEXCEPT
+        {
+            rhs.swap(*this);
+            any_property_map().swap(rhs);
+            return *this;
+        }
+
+        // Returns true if `key` was inserted, false if it was assigned. The
+        // map is left unchanged if the copy of `value` throws.
+        template<typename ValueType>
+        bool insert_or_assign(const property_key & key, ValueType&& value)
+        {
+            typedef BOOST_DEDUCED_TYPENAME decay<ValueType>::type value_type;
+            return insert_or_assign_impl<value_type>(
+                key,
+                static_cast<ValueType&&>(value),
+                boost::integral_constant<bool, is_stored_inline<value_type>::value>()
+            );
+        }
+
+        template<typename ValueType>
+        bool insert_or_assign(boost::string_view name, ValueType&& value)
+        {
+            return insert_or_assign(property_key(name), static_cast<ValueType&&>(value));
+        }
+
+        // Returns true if `key` was present.
+        bool erase(const property_key & key) BOOST_NOEXCEPT
+        {
+            const std::size_t i = lower_bound(key.id());
+            if (i == fields.size() || fields[i].key != key.id())
+                return false;
+
+            fields[i].ops->destroy(stored_at(fields[i]));
+            fields.erase(fields.begin() + static_cast<std::ptrdiff_t>(i));
+            if (fields.empty())
+                arena_used = 0;
+            return true;
+        }
+
+        void clear() BOOST_NOEXCEPT
+        {
+            for (std::size_t i = 0; i < fields.size(); ++i)
+                fields[i].ops->destroy(stored_at(fields[i]));
+            fields.clear();
+            arena_used = 0;
+        }
+
+    public: // queries
+
+        std::size_t size() const BOOST_NOEXCEPT
+        {
+            return fields.size();
+        }
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return fields.empty();
+        }
+
+        // An empty view if `key` is not present or its value is an empty
+        // `boost::any`.
+        any_view find(const property_key & key) BOOST_NOEXCEPT
+        {
+            const std::size_t i = lower_bound(key.id());
+            return i != fields.size() && fields[i].key == key.id() ? view_at(i) : any_view();
+        }
+
+        const_any_view find(const property_key & key) const BOOST_NOEXCEPT
+        {
+            return const_cast<any_property_map *>(this)->find(key);
+        }
+
+        // Looks the name up without interning it.
+        any_view find(boost::string_view name)
+        {
+            property_key key(0, 0);
+            return property_key::find(name, key) ? find(key) : any_view();
+        }
+
+        const_any_view find(boost::string_view name) const
+        {
+            return const_cast<any_property_map *>(this)->find(name);
+        }
+
+        bool contains(const property_key & key) const BOOST_NOEXCEPT
+        {
+            const std::size_t i = lower_bound(key.id());
+            return i != fields.size() && fields[i].key == key.id();
+        }
+
+        // Looks the name up without interning it.
+        bool contains(boost::string_view name) const
+        {
+            property_key key(0, 0);
+            return property_key::find(name, key) && contains(key);
+        }
+
+        // Keys and values in the order of their keys.
+        property_key key_at(std::size_t index) const BOOST_NOEXCEPT
+        {
+            return property_key(fields[index].key, fields[index].name);
+        }
+
+        any_view value_at(std::size_t index) BOOST_NOEXCEPT
+        {
+            return view_at(index);
+        }
+
+        const_any_view value_at(std::size_t index) const BOOST_NOEXCEPT
+        {
+            return const_cast<any_property_map *>(this)->view_at(index);
+        }
+
+    private: // types
+
+        struct field
+        {
+            boost::uint32_t key;
+            boost::uint32_t offset;
+            const std::string * name;
+            const detail::value_ops * ops; // of the object in the arena
+        };
+
+        // Searching a few keys one by one is faster than bisecting them.
+        BOOST_STATIC_CONSTANT(std::size_t, linear_search_limit = 8);
+
+    private: // implementation
+
+        static std::size_t slot_size(const detail::value_ops & ops) BOOST_NOEXCEPT
+        {
+            return detail::align_up(ops.size, sizeof(detail::max_align));
+        }
+
+        void * arena_at(std::size_t offset) const BOOST_NOEXCEPT
+        {
+            return reinterpret_cast<unsigned char *>(arena) + offset;
+        }
+
+        void * stored_at(const field & f) const BOOST_NOEXCEPT
+        {
+            return arena_at(f.offset);
+        }
+
+        any_view view_at(std::size_t index) BOOST_NOEXCEPT
+        {
+            const field & f = fields[index];
+            if (f.ops != &detail::value_ops_of<boost::any>::value)
+                return any_view(*f.ops, stored_at(f));
+
+            boost::any & boxed = *static_cast<boost::any *>(stored_at(f));
+            const detail::value_ops * const ops = detail::any_access::ops(boxed);
+            return ops ? any_view(*ops, detail::any_access::value(boxed)) : any_view();
+        }
+
+        std::size_t lower_bound(boost::uint32_t key) const BOOST_NOEXCEPT
+        {
+            if (fields.size() <= linear_search_limit)
+            {
+                std::size_t i = 0;
+                while (i < fields.size() && fields[i].key < key)
+                    ++i;
+                return i;
+            }
+
+            std::size_t first = 0, count = fields.size();
+            while (count)
+            {
+                const std::size_t step = count / 2;
+                if (fields[first + step].key < key)
+                {
+                    first += step + 1;
+                    count -= step + 1;
+                }
+                else
+                {
+                    count = step;
+                }
+            }
+            return first;
+        }
+
+        void reserve_arena(std::size_t size)
+        {
+            if (size)
+            {
+                arena = static_cast<detail::max_align *>(::operator new(size));
+                arena_size = size;
+            }
+        }
+
+        // Makes room for `size` more bytes at the end of the arena. Values
+        // are moved into the new arena without gaps left by erased or
+        // reassigned values.
+        void grow_arena(std::size_t size)
+        {
+            if (arena_used + size <= arena_size)
+                return;
+
+            std::size_t live = size;
+            for (std::size_t i = 0; i < fields.size(); ++i)
+                live += slot_size(*fields[i].ops);
+
+            any_property_map grown;
+            grown.reserve_arena((std::max)(live, arena_size * 2));
+
+            // Cannot throw: stored objects are moved without throwing
+            for (std::size_t i = 0; i < fields.size(); ++i)
+            {
+                field & f = fields[i];
+                void * const from = stored_at(f);
+                f.ops->move(grown.arena_at(grown.arena_used), from);
+                f.ops->destroy(from);
+                f.offset = static_cast<boost::uint32_t>(grown.arena_used);
+                grown.arena_used += slot_size(*f.ops);
+            }
+
+            std::swap(arena, grown.arena);
+            std::swap(arena_size, grown.arena_size);
+            std::swap(arena_used, grown.arena_used);
+        }
+
+        // `stored` is the object to be placed into the arena: the value
+        // itself or a `boost::any` holding it.
+        template<typename StoredType>
+        bool place(const property_key & key, StoredType & stored)
+        {
+            const detail::value_ops & ops = detail::value_ops_of<StoredType>::value;
+            const std::size_t i = lower_bound(key.id());
+            if (i != fields.size() && fields[i].key == key.id() && fields[i].ops == &ops)
+            {
+                // Same type: the old slot is reused
+                void * const slot = stored_at(fields[i]);
+                ops.destroy(slot);
+                ::new(slot) StoredType(static_cast<StoredType&&>(stored));
+                return false;
+            }
+
+            grow_arena(slot_size(ops));
+
+            const bool inserted = i == fields.size() || fields[i].key != key.id();
+            if (inserted)
+            {
+                const field f = { key.id(), 0, key.key_name, &ops };
+                fields.insert(fields.begin() + static_cast<std::ptrdiff_t>(i), f);
+            }
+            else
+            {
+                fields[i].ops->destroy(stored_at(fields[i]));
+            }
+
+            field & f = fields[i];
+            ::new(arena_at(arena_used)) StoredType(static_cast<StoredType&&>(stored));
+            f.offset = static_cast<boost::uint32_t>(arena_used);
+            f.ops = &ops;
+            arena_used += slot_size(ops);
+            return inserted;
+        }
+
+        template<typename ValueType, typename Arg>
+        bool insert_or_assign_impl(const property_key & key, Arg&& arg, boost::true_type /*inline*/)
+        {
+            ValueType value(static_cast<Arg&&>(arg));
+            return place(key, value);
+        }
+
+        template<typename ValueType, typename Arg>
+        bool insert_or_assign_impl(const property_key & key, Arg&& arg, boost::false_type /*boxed*/)
+        {
+            boost::any value(static_cast<Arg&&>(arg));
+            return place(key, value);
+        }
+
+        void destroy() BOOST_NOEXCEPT
+        {
+            clear();
+            ::operator delete(arena);
+            arena = 0;
+            arena_size = 0;
+        }
+
+    private: // representation
+
+        std::vector<field> fields;
+        detail::max_align * arena;
+        std::size_t arena_size;
+        std::size_t arena_used;
+    };
+
+    inline void swap(any_property_map & lhs, any_property_map & rhs) BOOST_NOEXCEPT
+    {
+        lhs.swap(rhs);
+    }
+} // namespace anys
+
+    using boost::anys::property_key;
+    using boost::anys::any_property_map;
+} // namespace boost
+
+#endif
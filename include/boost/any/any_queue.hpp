@@ -0,0 +1,391 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ANY_QUEUE_INCLUDED
+#define BOOST_ANY_ANY_QUEUE_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// A bounded, lock-free, multi-producer multi-consumer queue of heterogeneous
+// values. Payloads that fit into `InlineCapacity` bytes and have a non
+// throwing move constructor are stored in the ring slot itself; others are
+// stored in the slot as a `boost::any`. A pushed `boost::any` is stored as
+// is, consumers see the value it holds. Producers and consumers each claim
+// slots with a single CAS on their own index (Dmitry Vyukov's bounded MPMC
+// queue), consumers may claim a whole batch of slots at once.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_HDR_ATOMIC) \
+    || defined(BOOST_NO_CXX11_HDR_TYPE_TRAITS)
+#   error boost::anys::any_queue requires C++11 rvalue references, <atomic> and <type_traits>
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/any_view.hpp>
+#include <boost/any/detail/any_access.hpp>
+#include <boost/any/detail/value_ops.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace boost
+{
+namespace anys
+{
+    template<std::size_t InlineCapacity = 3 * sizeof(void *)>
+    class basic_any_queue
+      : private boost::noncopyable
+    {
+    public: // structors
+
+        // `capacity` is rounded up to a power of two.
+        explicit basic_any_queue(std::size_t capacity)
+          : mask(round_up_to_power_of_2(capacity) - 1)
+          , slots(new slot[mask + 1])
+        {
+            for (std::size_t i = 0; i <= mask; ++i)
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+            enqueue_pos.store(0, std::memory_order_relaxed);
+            dequeue_pos.store(0, std::memory_order_relaxed);
+        }
+
+        ~basic_any_queue() BOOST_NOEXCEPT
+        {
+            while (try_consume(discard()))
+            {
+            }
+            delete[] slots;
+        }
+
+    public: // producers
+
+        // Returns false if the queue is full. The value is constructed before
+        // a slot is claimed, so a throwing copy leaves the queue unchanged.
+        template<typename ValueType>
+        bool try_push(ValueType&& value)
+        {
+            typedef BOOST_DEDUCED_TYPENAME decay<ValueType>::type value_type;
+            return push_impl<value_type>(
+                static_cast<ValueType&&>(value),
+                boost::integral_constant<int,
+                    boost::is_same<value_type, boost::any>::value ? 2 : (is_stored_inline<value_type>::value ? 0 : 1)
+                >()
+            );
+        }
+
+    public: // consumers
+
+        // Calls `visitor(any_view)` for the oldest value and removes it.
+        // Returns false if the queue is empty.
+        template<typename Visitor>
+        bool try_consume(Visitor visitor)
+        {
+            std::size_t pos;
+            slot * s = claim_for_pop(pos);
+            if (!s)
+                return false;
+
+            release_guard guard(*this, pos, 1);
+            visitor(s->view());
+            return true;
+        }
+
+        // Claims up to `max_count` ready values with one CAS and calls
+        // `visitor(any_view)` on each, oldest first. Returns their number.
+        template<typename Visitor>
+        std::size_t try_consume_batch(Visitor visitor, std::size_t max_count)
+        {
+            if (!max_count)
+                return 0;
+
+            std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            std::size_t count = 0;
+            for (;;)
+            {
+                count = 0;
+                while (count < max_count && count <= mask)
+                {
+                    const std::size_t seq = slots[(pos + count) & mask].sequence.load(std::memory_order_acquire);
+                    if (seq != pos + count + 1)
+                        break;
+                    ++count;
+                }
+
+                if (!count)
+                {
+                    const std::size_t seq = slots[pos & mask].sequence.load(std::memory_order_acquire);
+                    if (static_cast<std::ptrdiff_t>(seq - (pos + 1)) < 0)
+                        return 0;
+                    pos = dequeue_pos.load(std::memory_order_relaxed); // another consumer got it
+                    continue;
+                }
+
+                if (dequeue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+                    break;
+            }
+
+            release_guard guard(*this, pos, count);
+            for (; guard.done < count; ++guard.done)
+            {
+                slot & s = slots[(pos + guard.done) & mask];
+                visitor(s.view());
+                s.destroy();
+                s.sequence.store(pos + guard.done + mask + 1, std::memory_order_release);
+            }
+            return count;
+        }
+
+        // Moves the oldest value into `out`. Values stored as `boost::any`
+        // are moved without an allocation, values stored inline are moved into
+        // a new holder. If that allocation throws, the value is dropped.
+        bool try_pop(boost::any & out)
+        {
+            std::size_t pos;
+            slot * s = claim_for_pop(pos);
+            if (!s)
+                return false;
+
+            release_guard guard(*this, pos, 1);
+            if (s->boxed)
+                out = static_cast<boost::any&&>(*s->boxed_any());
+            else
+                s->ops->move_to_any(s->value, out);
+            return true;
+        }
+
+    public: // queries
+
+        std::size_t capacity() const BOOST_NOEXCEPT
+        {
+            return mask + 1;
+        }
+
+        // Only a snapshot if other threads are using the queue.
+        bool empty() const BOOST_NOEXCEPT
+        {
+            const std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            return static_cast<std::ptrdiff_t>(
+                slots[pos & mask].sequence.load(std::memory_order_acquire) - (pos + 1)
+            ) < 0;
+        }
+
+        // Whether values of `ValueType` are stored in the slot itself.
+        template<typename ValueType>
+        struct is_stored_inline
+          : boost::integral_constant<bool,
+                sizeof(ValueType) <= InlineCapacity
+                && boost::alignment_of<ValueType>::value <= boost::alignment_of<detail::max_align>::value
+                && std::is_nothrow_move_constructible<ValueType>::value
+            >
+        {
+        };
+
+    private: // types
+
+        struct slot
+        {
+            std::atomic<std::size_t> sequence;
+            const detail::value_ops * ops;  // null for an empty `boost::any`
+            void * value;   // the payload, in `storage` or in the holder of `storage`
+            bool boxed;     // `storage` holds a `boost::any`
+            union
+            {
+                detail::max_align align;
+                unsigned char bytes[InlineCapacity < sizeof(boost::any) ? sizeof(boost::any) : InlineCapacity];
+            } storage;
+
+            any_view view() const BOOST_NOEXCEPT
+            {
+                return ops ? any_view(*ops, value) : any_view();
+            }
+
+            boost::any * boxed_any() BOOST_NOEXCEPT
+            {
+                return static_cast<boost::any *>(static_cast<void *>(storage.bytes));
+            }
+
+            void destroy() BOOST_NOEXCEPT
+            {
+                if (boxed)
+                    boxed_any()->~any();
+                else
+                    ops->destroy(value);
+            }
+        };
+
+        struct discard
+        {
+            void operator()(any_view) const BOOST_NOEXCEPT
+            {
+            }
+        };
+
+        // Destroys and releases the claimed slots that were not released
+        // yet, even if a visitor throws.
+        struct release_guard
+        {
+            basic_any_queue & queue;
+            std::size_t pos;
+            std::size_t count;
+            std::size_t done;
+
+            release_guard(basic_any_queue & q, std::size_t first, std::size_t n) BOOST_NOEXCEPT
+              : queue(q), pos(first), count(n), done(0)
+            {
+            }
+
+            ~release_guard() BOOST_NOEXCEPT
+            {
+                for (; done < count; ++done)
+                {
+                    slot & s = queue.slots[(pos + done) & queue.mask];
+                    s.destroy();
+                    s.sequence.store(pos + done + queue.mask + 1, std::memory_order_release);
+                }
+            }
+        };
+
+    private: // implementation
+
+        static std::size_t round_up_to_power_of_2(std::size_t n) BOOST_NOEXCEPT
+        {
+            std::size_t result = 2;
+            while (result < n)
+                result <<= 1;
+            return result;
+        }
+
+        slot * claim_for_push(std::size_t & pos) BOOST_NOEXCEPT
+        {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                slot & s = slots[pos & mask];
+                const std::size_t seq = s.sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - pos);
+                if (diff == 0)
+                {
+                    if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        return &s;
+                }
+                else if (diff < 0)
+                {
+                    return 0;
+                }
+                else
+                {
+                    pos = enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        slot * claim_for_pop(std::size_t & pos) BOOST_NOEXCEPT
+        {
+            pos = dequeue_pos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                slot & s = slots[pos & mask];
+                const std::size_t seq = s.sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+                if (diff == 0)
+                {
+                    if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        return &s;
+                }
+                else if (diff < 0)
+                {
+                    return 0;
+                }
+                else
+                {
+                    pos = dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        template<typename ValueType, typename Arg>
+        bool push_impl(Arg&& arg, boost::integral_constant<int, 0> /*inline*/)
+        {
+            ValueType value(static_cast<Arg&&>(arg));
+
+            std::size_t pos;
+            slot * s = claim_for_push(pos);
+            if (!s)
+                return false;
+
+            s->value = ::new(static_cast<void *>(s->storage.bytes)) ValueType(static_cast<ValueType&&>(value));
+            s->ops = &detail::value_ops_of<ValueType>::value;
+            s->boxed = false;
+            s->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename ValueType, typename Arg>
+        bool push_impl(Arg&& arg, boost::integral_constant<int, 1> /*boxed*/)
+        {
+            boost::any value(static_cast<Arg&&>(arg));
+
+            std::size_t pos;
+            slot * s = claim_for_push(pos);
+            if (!s)
+                return false;
+
+            boost::any * boxed = ::new(static_cast<void *>(s->storage.bytes)) boost::any(static_cast<boost::any&&>(value));
+            s->value = boost::any_cast<ValueType>(boxed);
+            s->ops = &detail::value_ops_of<ValueType>::value;
+            s->boxed = true;
+            s->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename ValueType, typename Arg>
+        bool push_impl(Arg&& arg, boost::integral_constant<int, 2> /*boost::any*/)
+        {
+            boost::any value(static_cast<Arg&&>(arg));
+
+            std::size_t pos;
+            slot * s = claim_for_push(pos);
+            if (!s)
+                return false;
+
+            boost::any * boxed = ::new(static_cast<void *>(s->storage.bytes)) boost::any(static_cast<boost::any&&>(value));
+            s->value = detail::any_access::value(*boxed);
+            s->ops = detail::any_access::ops(*boxed);
+            s->boxed = true;
+            s->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+    private: // representation
+
+        const std::size_t mask;
+        slot * const slots;
+
+        // Producers and consumers update different cache lines
+        char padding0[64];
+        std::atomic<std::size_t> enqueue_pos;
+        char padding1[64];
+        std::atomic<std::size_t> dequeue_pos;
+        char padding2[64];
+    };
+
+    typedef basic_any_queue<> any_queue;
+} // namespace anys
+
+    using boost::anys::basic_any_queue;
+    using boost::anys::any_queue;
+} // namespace boost
+
+#endif
@@ -0,0 +1,393 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ANY_TUPLE_INCLUDED
+#define BOOST_ANY_ANY_TUPLE_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// A fixed-shape record of heterogeneous values. All the field payloads share
+// a single allocation, each one aligned for its own type, instead of costing
+// one `any::holder` allocation per field. `clone_range` snapshots a range of
+// `boost::any` into one such block.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+#   error boost::anys::any_tuple requires C++11 rvalue references and variadic templates
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/any_view.hpp>
+#include <boost/any/detail/any_access.hpp>
+#include <boost/any/detail/value_ops.hpp>
+#include <boost/assert.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <cstddef>
+#include <iterator>
+#include <new>
+
+#if defined(__GNUC__) || defined(__clang__)
+#   define BOOST_ANY_DETAIL_PREFETCH(address) __builtin_prefetch(address)
+#else
+#   define BOOST_ANY_DETAIL_PREFETCH(address) ((void)0)
+#endif
+
+namespace boost
+{
+namespace anys
+{
+    class any_tuple;
+
+    namespace detail
+    {
+        template<typename... ValueTypes>
+        struct is_single_any_tuple
+        {
+            BOOST_STATIC_CONSTANT(bool, value = false);
+        };
+
+        template<typename ValueType>
+        struct is_single_any_tuple<ValueType>
+          : boost::is_same<BOOST_DEDUCED_TYPENAME boost::decay<ValueType>::type, any_tuple>
+        {
+        };
+    }
+
+    class any_tuple
+    {
+    public: // structors
+
+        BOOST_CONSTEXPR any_tuple() BOOST_NOEXCEPT
+          : fields(0), data(0), count(0)
+        {
+        }
+
+        // Constructs one field per argument. All the payloads are placed
+        // into a single allocation.
+        template<typename... ValueTypes
+            , typename = BOOST_DEDUCED_TYPENAME boost::disable_if<detail::is_single_any_tuple<ValueTypes...> >::type>
+        explicit any_tuple(ValueTypes&&... values)
+          : fields(0), data(0), count(0)
+        {
+            const detail::value_ops * const layout[] = {
+                &detail::value_ops_of<BOOST_DEDUCED_TYPENAME decay<ValueTypes>::type>::value...
+            };
+            allocate(layout, sizeof...(ValueTypes));
+            BOOST_TRY {
+                emplace_fields(0, static_cast<ValueTypes&&>(values)...);
+            } BOOST_CATCH(...) {
+                deallocate();
+                BOOST_RETHROW
+            }
+            BOOST_CATCH_END
+        }
+
+        any_tuple(const any_tuple & other)
+          : fields(0), data(0), count(0)
+        {
+            if (!other.count)
+                return;
+
+            allocate(other.fields, other.count);
+            std::size_t i = 0;
+            BOOST_TRY {
+                for (; i < count; ++i)
+                {
+                    if (fields[i].ops)
+                        fields[i].ops->copy(data + fields[i].offset, other.data + other.fields[i].offset);
+                }
+            } BOOST_CATCH(...) {
+                destroy_fields(i);
+                deallocate();
+                BOOST_RETHROW
+            }
+            BOOST_CATCH_END
+        }
+
+        any_tuple(any_tuple&& other) BOOST_NOEXCEPT
+          : fields(other.fields), data(other.data), count(other.count)
+        {
+            other.fields = 0;
+            other.data = 0;
+            other.count = 0;
+        }
+
+        ~any_tuple() BOOST_NOEXCEPT
+        {
+            destroy_fields(count);
+            deallocate();
+        }
+
+    public: // modifiers
+
+        any_tuple & swap(any_tuple & rhs) BOOST_NOEXCEPT
+        {
+            field * tmp_fields = fields;
+            char * tmp_data = data;
+            std::size_t tmp_count = count;
+            fields = rhs.fields;
+            data = rhs.data;
+            count = rhs.count;
+            rhs.fields = tmp_fields;
+            rhs.data = tmp_data;
+            rhs.count = tmp_count;
+            return *this;
+        }
+
+        any_tuple & operator=(const any_tuple& rhs)
+        {
+            any_tuple(rhs).swap(*this);
+            return *this;
+        }
+
+        any_tuple & operator=(any_tuple&& rhs) BOOST_NOEXCEPT
+        {
+            rhs.swap(*this);
+            any_tuple().swap(rhs);
+            return *this;
+        }
+
+        void clear() BOOST_NOEXCEPT
+        {
+            any_tuple().swap(*this);
+        }
+
+    public: // queries
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return !count;
+        }
+
+        std::size_t size() const BOOST_NOEXCEPT
+        {
+            return count;
+        }
+
+        const boost::typeindex::type_info& type(std::size_t i) const BOOST_NOEXCEPT
+        {
+            BOOST_ASSERT(i < count);
+            return detail::any_access::type(fields[i].ops, data + fields[i].offset);
+        }
+
+    public: // element access
+
+        any_view operator[](std::size_t i) BOOST_NOEXCEPT
+        {
+            BOOST_ASSERT(i < count);
+            return fields[i].ops ? any_view(*fields[i].ops, data + fields[i].offset) : any_view();
+        }
+
+        const_any_view operator[](std::size_t i) const BOOST_NOEXCEPT
+        {
+            BOOST_ASSERT(i < count);
+            return fields[i].ops ? const_any_view(*fields[i].ops, data + fields[i].offset) : const_any_view();
+        }
+
+        // Throws `bad_any_cast` if field `i` does not hold a `ValueType`.
+        template<typename ValueType>
+        ValueType & get(std::size_t i)
+        {
+            BOOST_ASSERT(i < count);
+            ValueType * const result = detail::any_access::cast<ValueType>(fields[i].ops, data + fields[i].offset);
+            if (!result)
+                boost::throw_exception(bad_any_cast());
+
+            return *result;
+        }
+
+        template<typename ValueType>
+        const ValueType & get(std::size_t i) const
+        {
+            return const_cast<any_tuple *>(this)->get<const ValueType>(i);
+        }
+
+    private: // types
+
+        // `ops` is null for a field copied from an empty `boost::any`.
+        struct field
+        {
+            const detail::value_ops * ops;
+            std::size_t offset;
+        };
+
+        template<typename ForwardIterator>
+        friend any_tuple clone_range(ForwardIterator first, ForwardIterator last);
+
+    private: // implementation
+
+        static const detail::value_ops * ops_of(const detail::value_ops * ops) BOOST_NOEXCEPT
+        {
+            return ops;
+        }
+
+        static const detail::value_ops * ops_of(const field & f) BOOST_NOEXCEPT
+        {
+            return f.ops;
+        }
+
+        static const detail::value_ops * ops_of(const boost::any & value) BOOST_NOEXCEPT
+        {
+            return detail::any_access::ops(value);
+        }
+
+        // Allocates one block holding the field table followed by the
+        // payloads, each at an offset suitably aligned for its type.
+        // `layout` iterates over ops tables, fields or `boost::any`s.
+        template<typename LayoutIterator>
+        void allocate(LayoutIterator layout, std::size_t n)
+        {
+            std::size_t alignment = boost::alignment_of<field>::value;
+            std::size_t payload = 0;
+            LayoutIterator it = layout;
+            for (std::size_t i = 0; i < n; ++i, ++it)
+            {
+                const detail::value_ops * const ops = ops_of(*it);
+                if (!ops)
+                    continue;
+                if (ops->align > alignment)
+                    alignment = ops->align;
+                payload = detail::align_up(payload, ops->align) + ops->size;
+            }
+
+            const std::size_t header = n * sizeof(field);
+            std::size_t prefix = detail::align_up(header, alignment);
+            if (alignment > boost::alignment_of<detail::max_align>::value)
+                prefix += alignment - 1; // `::operator new` does not align that much
+
+            void * block = ::operator new(prefix + payload);
+            fields = static_cast<field *>(block);
+            const std::size_t address = reinterpret_cast<std::size_t>(block) + header;
+            data = static_cast<char *>(block) + header + (detail::align_up(address, alignment) - address);
+            count = n;
+
+            std::size_t offset = 0;
+            for (std::size_t i = 0; i < n; ++i, ++layout)
+            {
+                const detail::value_ops * const ops = ops_of(*layout);
+                fields[i].ops = ops;
+                fields[i].offset = 0;
+                if (ops)
+                {
+                    offset = detail::align_up(offset, ops->align);
+                    fields[i].offset = offset;
+                    offset += ops->size;
+                }
+            }
+        }
+
+        void deallocate() BOOST_NOEXCEPT
+        {
+            ::operator delete(fields);
+            fields = 0;
+            data = 0;
+            count = 0;
+        }
+
+        void destroy_fields(std::size_t n) BOOST_NOEXCEPT
+        {
+            while (n)
+            {
+                --n;
+                if (fields[n].ops)
+                    fields[n].ops->destroy(data + fields[n].offset);
+            }
+        }
+
+        void emplace_fields(std::size_t) BOOST_NOEXCEPT
+        {
+        }
+
+        template<typename ValueType, typename... Rest>
+        void emplace_fields(std::size_t i, ValueType&& value, Rest&&... rest)
+        {
+            typedef BOOST_DEDUCED_TYPENAME decay<ValueType>::type value_type;
+            ::new(static_cast<void *>(data + fields[i].offset)) value_type(static_cast<ValueType&&>(value));
+            BOOST_TRY {
+                emplace_fields(i + 1, static_cast<Rest&&>(rest)...);
+            } BOOST_CATCH(...) {
+                fields[i].ops->destroy(data + fields[i].offset);
+                BOOST_RETHROW
+            }
+            BOOST_CATCH_END
+        }
+
+    private: // representation
+
+        field * fields; // start of the allocation
+        char * data;
+        std::size_t count;
+    };
+
+    inline void swap(any_tuple & lhs, any_tuple & rhs) BOOST_NOEXCEPT
+    {
+        lhs.swap(rhs);
+    }
+
+    // Copies the values held by a range of `boost::any` into a single block,
+    // instead of one `clone()` allocation per element. The holders are
+    // walked once to size the block; while values are copied, the holders a
+    // few elements ahead are prefetched. Empty elements become empty fields.
+    // Only the values of the `boost::any` made by this library (`to_any` of
+    // a view, `pop` of a queue, ...) are copied into the block; any other
+    // element is copied as a whole `boost::any`, which still clones it.
+    template<typename ForwardIterator>
+    any_tuple clone_range(ForwardIterator first, ForwardIterator last)
+    {
+        any_tuple result;
+        const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+        if (!n)
+            return result;
+
+        result.allocate(first, n);
+        ForwardIterator ahead = first;
+        for (std::size_t i = 0; i < 4 && ahead != last; ++i)
+            ++ahead;
+
+        std::size_t i = 0;
+        BOOST_TRY {
+            for (; first != last; ++first, ++i)
+            {
+                if (ahead != last)
+                {
+                    BOOST_ANY_DETAIL_PREFETCH(detail::any_access::holder(*ahead));
+                    ++ahead;
+                }
+                if (result.fields[i].ops)
+                    result.fields[i].ops->copy(result.data + result.fields[i].offset, detail::any_access::value(*first));
+            }
+        } BOOST_CATCH(...) {
+            result.destroy_fields(i);
+            result.deallocate();
+            BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+        return result;
+    }
+
+    template<typename ForwardRange>
+    inline any_tuple clone_range(const ForwardRange & range)
+    {
+        return anys::clone_range(boost::begin(range), boost::end(range));
+    }
+} // namespace anys
+
+    using boost::anys::any_tuple;
+    using boost::anys::clone_range;
+} // namespace boost
+
+#endif
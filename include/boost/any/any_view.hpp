@@ -0,0 +1,200 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ANY_VIEW_INCLUDED
+#define BOOST_ANY_ANY_VIEW_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Non-owning, `any`-like references to a value stored elsewhere (a field of
+// an `any_tuple`, a slot of a container, ...). Views are cheap to copy and
+// support `any_cast` with the same type checking as `boost::any`. A view of
+// a boxed `boost::any` (see `detail/any_access.hpp`) behaves as a view of the
+// value that it holds.
+
+#include <boost/any.hpp>
+#include <boost/any/detail/any_access.hpp>
+#include <boost/any/detail/value_ops.hpp>
+#include <boost/config.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/add_reference.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/is_reference.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+
+namespace boost
+{
+namespace anys
+{
+    class const_any_view;
+
+    class any_view
+    {
+    public: // structors
+
+        BOOST_CONSTEXPR any_view() BOOST_NOEXCEPT
+          : ops(0), value(0)
+        {
+        }
+
+        any_view(const detail::value_ops & value_ops, void * value_ptr) BOOST_NOEXCEPT
+          : ops(&value_ops), value(value_ptr)
+        {
+        }
+
+    public: // queries
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return detail::any_access::empty(ops, value);
+        }
+
+        const boost::typeindex::type_info& type() const BOOST_NOEXCEPT
+        {
+            return detail::any_access::type(ops, value);
+        }
+
+        // Deep copy of the viewed value into an owning `boost::any`.
+        boost::any to_any() const
+        {
+            boost::any result;
+            if (ops)
+                ops->to_any(value, result);
+            return result;
+        }
+
+        // The address of the value, or of the `boost::any` holding it.
+        void * data() const BOOST_NOEXCEPT
+        {
+            return value;
+        }
+
+    private: // representation
+
+        friend class const_any_view;
+
+        template<typename ValueType>
+        friend ValueType * any_cast(any_view *) BOOST_NOEXCEPT;
+
+        const detail::value_ops * ops;
+        void * value;
+    };
+
+    class const_any_view
+    {
+    public: // structors
+
+        BOOST_CONSTEXPR const_any_view() BOOST_NOEXCEPT
+          : ops(0), value(0)
+        {
+        }
+
+        const_any_view(const detail::value_ops & value_ops, const void * value_ptr) BOOST_NOEXCEPT
+          : ops(&value_ops), value(value_ptr)
+        {
+        }
+
+        const_any_view(const any_view & other) BOOST_NOEXCEPT
+          : ops(other.ops), value(other.value)
+        {
+        }
+
+    public: // queries
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return detail::any_access::empty(ops, value);
+        }
+
+        const boost::typeindex::type_info& type() const BOOST_NOEXCEPT
+        {
+            return detail::any_access::type(ops, value);
+        }
+
+        boost::any to_any() const
+        {
+            boost::any result;
+            if (ops)
+                ops->to_any(value, result);
+            return result;
+        }
+
+        // The address of the value, or of the `boost::any` holding it.
+        const void * data() const BOOST_NOEXCEPT
+        {
+            return value;
+        }
+
+    private: // representation
+
+        template<typename ValueType>
+        friend const ValueType * any_cast(const_any_view *) BOOST_NOEXCEPT;
+
+        const detail::value_ops * ops;
+        const void * value;
+    };
+
+    template<typename ValueType>
+    ValueType * any_cast(any_view * operand) BOOST_NOEXCEPT
+    {
+        return operand ? detail::any_access::cast<ValueType>(operand->ops, operand->value) : 0;
+    }
+
+    template<typename ValueType>
+    const ValueType * any_cast(const_any_view * operand) BOOST_NOEXCEPT
+    {
+        return operand
+            ? detail::any_access::cast<const ValueType>(operand->ops, const_cast<void *>(operand->value))
+            : 0;
+    }
+
+    template<typename ValueType>
+    inline const ValueType * any_cast(const const_any_view * operand) BOOST_NOEXCEPT
+    {
+        return any_cast<ValueType>(const_cast<const_any_view *>(operand));
+    }
+
+    template<typename ValueType>
+    ValueType any_cast(any_view operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+
+        nonref * result = anys::any_cast<nonref>(boost::addressof(operand));
+        if(!result)
+            boost::throw_exception(bad_any_cast());
+
+        typedef BOOST_DEDUCED_TYPENAME boost::conditional<
+            boost::is_reference<ValueType>::value,
+            ValueType,
+            BOOST_DEDUCED_TYPENAME boost::add_reference<ValueType>::type
+        >::type ref_type;
+
+        return static_cast<ref_type>(*result);
+    }
+
+    template<typename ValueType>
+    ValueType any_cast(const_any_view operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+
+        const nonref * result = anys::any_cast<nonref>(boost::addressof(operand));
+        if(!result)
+            boost::throw_exception(bad_any_cast());
+
+        return static_cast<const nonref &>(*result);
+    }
+} // namespace anys
+
+    using boost::anys::any_view;
+    using boost::anys::const_any_view;
+    using boost::anys::any_cast;
+} // namespace boost
+
+#endif
@@ -0,0 +1,428 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ARENA_ANY_INCLUDED
+#define BOOST_ANY_ARENA_ANY_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// A variant type like boost::any whose values live in a monotonic arena.
+// Values are bump-allocated and never freed one at a time: destroying or
+// reassigning an `arena_any` only forgets its value. `any_arena::reset()`
+// runs the destructors of the values that need one, newest first, and
+// releases the memory at once.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+#   error boost::anys::arena_any requires C++11 rvalue references
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/detail/value_ops.hpp>
+#include <boost/assert.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/add_reference.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/is_reference.hpp>
+#include <boost/type_traits/is_rvalue_reference.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <cstddef>
+#include <new>
+
+namespace boost
+{
+namespace anys
+{
+    class arena_any;
+
+    class any_arena
+      : private boost::noncopyable
+    {
+    public: // structors
+
+        // Memory is taken from the system in blocks of `block_size` bytes,
+        // or larger for values that do not fit.
+        explicit any_arena(std::size_t block_size = 4096) BOOST_NOEXCEPT
+          : blocks(0), current(0), end(0), finalizers(0), size(block_size), used(0)
+        {
+        }
+
+        ~any_arena() BOOST_NOEXCEPT
+        {
+            reset();
+            while (blocks)
+            {
+                block * const next = blocks->next;
+                ::operator delete(blocks);
+                blocks = next;
+            }
+        }
+
+    public: // modifiers
+
+        // Destroys all the values, newest first, and releases all the
+        // blocks but the first one. Every `arena_any` bound to this arena
+        // must be destroyed, cleared or reassigned before it is used again.
+        void reset() BOOST_NOEXCEPT
+        {
+            for (; finalizers; finalizers = finalizers->next)
+                finalizers->ops->destroy(finalizers->object);
+
+            while (blocks && blocks->next)
+            {
+                block * const next = blocks->next;
+                ::operator delete(blocks);
+                blocks = next;
+            }
+            current = blocks ? blocks->data() : 0;
+            end = blocks ? current + blocks->size : 0;
+            used = 0;
+        }
+
+    public: // queries
+
+        // Bytes handed out since the last reset, padding included.
+        std::size_t bytes_used() const BOOST_NOEXCEPT
+        {
+            return used;
+        }
+
+        std::size_t block_size() const BOOST_NOEXCEPT
+        {
+            return size;
+        }
+
+    private: // types
+
+        struct block
+        {
+            block * next;
+            std::size_t size;
+
+            char * data() BOOST_NOEXCEPT
+            {
+                return reinterpret_cast<char *>(this) + header_size();
+            }
+        };
+
+        // Kept in the arena itself, next to the values
+        struct finalizer
+        {
+            const detail::value_ops * ops;
+            void * object;
+            finalizer * next;
+        };
+
+        friend class arena_any;
+
+    private: // implementation
+
+        static std::size_t header_size() BOOST_NOEXCEPT
+        {
+            return detail::align_up(sizeof(block), boost::alignment_of<detail::max_align>::value);
+        }
+
+        static std::size_t padding(const char * address, std::size_t alignment) BOOST_NOEXCEPT
+        {
+            const std::size_t value = reinterpret_cast<std::size_t>(address);
+            return detail::align_up(value, alignment) - value;
+        }
+
+        void * allocate(std::size_t bytes, std::size_t alignment)
+        {
+            std::size_t skip = current ? padding(current, alignment) : 0;
+            if (!current || static_cast<std::size_t>(end - current) < skip + bytes)
+            {
+                grow(bytes + alignment - 1);
+                skip = padding(current, alignment);
+            }
+
+            char * const result = current + skip;
+            used += skip + bytes;
+            current = result + bytes;
+            return result;
+        }
+
+        void grow(std::size_t bytes)
+        {
+            const std::size_t block_bytes = bytes > size ? bytes : size;
+            block * const fresh = static_cast<block *>(::operator new(header_size() + block_bytes));
+            fresh->next = blocks;
+            fresh->size = block_bytes;
+            blocks = fresh;
+            current = fresh->data();
+            end = current + block_bytes;
+        }
+
+        template<typename ValueType, typename Arg>
+        ValueType * construct(Arg&& arg)
+        {
+            finalizer * record = 0;
+            if (!boost::has_trivial_destructor<ValueType>::value)
+                record = static_cast<finalizer *>(allocate(sizeof(finalizer), boost::alignment_of<finalizer>::value));
+
+            ValueType * const result = ::new(allocate(sizeof(ValueType), boost::alignment_of<ValueType>::value))
+                ValueType(static_cast<Arg&&>(arg));
+            if (record)
+            {
+                record->ops = &detail::value_ops_of<ValueType>::value;
+                record->object = result;
+                record->next = finalizers;
+                finalizers = record;
+            }
+            return result;
+        }
+
+        void * construct_copy(const detail::value_ops & ops, const void * source)
+        {
+            finalizer * record = 0;
+            if (!ops.trivial)
+                record = static_cast<finalizer *>(allocate(sizeof(finalizer), boost::alignment_of<finalizer>::value));
+
+            void * const result = allocate(ops.size, ops.align);
+            ops.copy(result, source);
+            if (record)
+            {
+                record->ops = &ops;
+                record->object = result;
+                record->next = finalizers;
+                finalizers = record;
+            }
+            return result;
+        }
+
+    private: // representation
+
+        block * blocks; // newest first
+        char * current;
+        char * end;
+        finalizer * finalizers; // newest first
+        std::size_t size;
+        std::size_t used;
+    };
+
+    class arena_any
+    {
+    public: // structors
+
+        BOOST_CONSTEXPR arena_any() BOOST_NOEXCEPT
+          : arena(0), ops(0), value(0)
+        {
+        }
+
+        // Empty, but new values are placed into `a`.
+        explicit arena_any(any_arena & a) BOOST_NOEXCEPT
+          : arena(boost::addressof(a)), ops(0), value(0)
+        {
+        }
+
+        template<typename ValueType>
+        arena_any(any_arena & a, ValueType&& v)
+          : arena(boost::addressof(a)), ops(0), value(0)
+        {
+            emplace(static_cast<ValueType&&>(v));
+        }
+
+        // The copy is placed into the arena of `other`.
+        arena_any(const arena_any & other)
+          : arena(other.arena), ops(0), value(0)
+        {
+            if (other.ops)
+            {
+                value = arena->construct_copy(*other.ops, other.value);
+                ops = other.ops;
+            }
+        }
+
+        arena_any(arena_any&& other) BOOST_NOEXCEPT
+          : arena(other.arena), ops(other.ops), value(other.value)
+        {
+            other.ops = 0;
+            other.value = 0;
+        }
+
+        // Does nothing: the value is destroyed by `any_arena::reset()`.
+        ~arena_any() BOOST_NOEXCEPT
+        {
+        }
+
+    public: // modifiers
+
+        arena_any & swap(arena_any & rhs) BOOST_NOEXCEPT
+        {
+            any_arena * tmp_arena = arena;
+            const detail::value_ops * tmp_ops = ops;
+            void * tmp_value = value;
+            arena = rhs.arena;
+            ops = rhs.ops;
+            value = rhs.value;
+            rhs.arena = tmp_arena;
+            rhs.ops = tmp_ops;
+            rhs.value = tmp_value;
+            return *this;
+        }
+
+        arena_any & operator=(const arena_any& rhs)
+        {
+            arena_any(rhs).swap(*this);
+            return *this;
+        }
+
+        arena_any & operator=(arena_any&& rhs) BOOST_NOEXCEPT
+        {
+            rhs.swap(*this);
+            arena_any().swap(rhs);
+            return *this;
+        }
+
+        // Places the new value into the arena this object is bound to.
+        template <class ValueType>
+        typename boost::disable_if<
+            boost::is_same<BOOST_DEDUCED_TYPENAME decay<ValueType>::type, arena_any>, arena_any &
+        >::type operator=(ValueType&& rhs)
+        {
+            BOOST_ASSERT(arena);
+            emplace(static_cast<ValueType&&>(rhs));
+            return *this;
+        }
+
+        // Forgets the value; it is destroyed by `any_arena::reset()`.
+        void clear() BOOST_NOEXCEPT
+        {
+            ops = 0;
+            value = 0;
+        }
+
+    public: // queries
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return !ops;
+        }
+
+        const boost::typeindex::type_info& type() const BOOST_NOEXCEPT
+        {
+            return ops ? ops->type() : boost::typeindex::type_id<void>().type_info();
+        }
+
+        // Null for a default constructed object.
+        any_arena * get_arena() const BOOST_NOEXCEPT
+        {
+            return arena;
+        }
+
+        // Deep copy of the value into an owning `boost::any`, e.g. to keep
+        // it after the arena is reset.
+        boost::any to_any() const
+        {
+            boost::any result;
+            if (ops)
+                ops->to_any(value, result);
+            return result;
+        }
+
+    private: // implementation
+
+        template<typename ValueType>
+        void emplace(ValueType&& v)
+        {
+            typedef BOOST_DEDUCED_TYPENAME remove_cv<BOOST_DEDUCED_TYPENAME decay<ValueType>::type>::type value_type;
+            value = arena->construct<value_type>(static_cast<ValueType&&>(v));
+            ops = &detail::value_ops_of<value_type>::value;
+        }
+
+    private: // representation
+
+        template<typename ValueType>
+        friend ValueType * any_cast(arena_any *) BOOST_NOEXCEPT;
+
+        any_arena * arena;
+        const detail::value_ops * ops;
+        void * value;
+    };
+
+    inline void swap(arena_any & lhs, arena_any & rhs) BOOST_NOEXCEPT
+    {
+        lhs.swap(rhs);
+    }
+
+    // The ops table of the held type is compared first, the type names only
+    // if the tables differ (e.g. across shared libraries).
+    template<typename ValueType>
+    ValueType * any_cast(arena_any * operand) BOOST_NOEXCEPT
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_cv<ValueType>::type value_type;
+
+        return operand && operand->ops
+            && (operand->ops == &detail::value_ops_of<value_type>::value
+                || operand->type() == boost::typeindex::type_id<ValueType>())
+            ? static_cast<ValueType *>(operand->value)
+            : 0;
+    }
+
+    template<typename ValueType>
+    inline const ValueType * any_cast(const arena_any * operand) BOOST_NOEXCEPT
+    {
+        return anys::any_cast<ValueType>(const_cast<arena_any *>(operand));
+    }
+
+    template<typename ValueType>
+    ValueType any_cast(arena_any & operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+
+        nonref * result = anys::any_cast<nonref>(boost::addressof(operand));
+        if(!result)
+            boost::throw_exception(bad_any_cast());
+
+        typedef BOOST_DEDUCED_TYPENAME boost::conditional<
+            boost::is_reference<ValueType>::value,
+            ValueType,
+            BOOST_DEDUCED_TYPENAME boost::add_reference<ValueType>::type
+        >::type ref_type;
+
+        return static_cast<ref_type>(*result);
+    }
+
+    template<typename ValueType>
+    inline ValueType any_cast(const arena_any & operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+        return anys::any_cast<const nonref &>(const_cast<arena_any &>(operand));
+    }
+
+    template<typename ValueType>
+    inline ValueType any_cast(arena_any&& operand)
+    {
+        BOOST_STATIC_ASSERT_MSG(
+            boost::is_rvalue_reference<ValueType&&>::value /*true if ValueType is rvalue or just a value*/
+            || boost::is_const< typename boost::remove_reference<ValueType>::type >::value,
+            "boost::any_cast shall not be used for getting nonconst references to temporary objects"
+        );
+        return anys::any_cast<ValueType>(operand);
+    }
+} // namespace anys
+
+    using boost::anys::any_arena;
+    using boost::anys::arena_any;
+    using boost::anys::any_cast;
+} // namespace boost
+
+#endif
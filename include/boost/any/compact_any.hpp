@@ -0,0 +1,449 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_COMPACT_ANY_INCLUDED
+#define BOOST_ANY_COMPACT_ANY_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// A variant type like boost::any that is exactly one machine word in size.
+//
+// On 64-bit targets with 48-bit user space addresses the word is NaN-boxed.
+// A `double` is stored as is (NaNs are canonicalized), while `int32_t`,
+// `float`, `bool` and pointers to heap holders of all the other types live
+// in the negative quiet NaN space, told apart by the upper 16 bits:
+//
+//   0x0000 - 0xFFFB  double
+//   0xFFFC           pointer to a holder (null if empty)
+//   0xFFFD           int32_t in the low 32 bits
+//   0xFFFE           float in the low 32 bits
+//   0xFFFF           bool in the low bits
+//
+// On other targets, on targets whose heap pointers carry tags in their upper
+// bits (Android arm64, hardware-assisted AddressSanitizer), or if
+// BOOST_ANY_NO_NAN_BOXING is defined, every value is held on the heap.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+#   error boost::anys::compact_any requires C++11 rvalue references
+#endif
+
+#include <boost/any.hpp>
+#include <boost/assert.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/predef/other/endian.h>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/add_reference.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/is_reference.hpp>
+#include <boost/type_traits/is_rvalue_reference.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <cstring>
+#include <new>
+
+// Heap pointers are tagged in their upper bits on Android arm64 and with the
+// hardware-assisted AddressSanitizer, they do not fit in 48 bits.
+#if defined(__SANITIZE_HWADDRESS__) || ((defined(__aarch64__) || defined(_M_ARM64)) && defined(__ANDROID__))
+#   define BOOST_ANY_DETAIL_TAGGED_POINTERS
+#elif defined(__has_feature)
+#   if __has_feature(hwaddress_sanitizer)
+#       define BOOST_ANY_DETAIL_TAGGED_POINTERS
+#   endif
+#endif
+
+#if !defined(BOOST_ANY_NO_NAN_BOXING) && !defined(BOOST_ANY_DETAIL_TAGGED_POINTERS) \
+    && (defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__) || defined(_M_ARM64) \
+        || defined(__powerpc64__) || (defined(__riscv) && __riscv_xlen == 64))
+#   define BOOST_ANY_DETAIL_NAN_BOXING
+#endif
+
+namespace boost
+{
+namespace anys
+{
+    namespace detail
+    {
+        // Upper 16 bits of the word for values that are not doubles
+        BOOST_STATIC_CONSTEXPR unsigned compact_heap_tag   = 0xFFFC;
+        BOOST_STATIC_CONSTEXPR unsigned compact_int32_tag  = 0xFFFD;
+        BOOST_STATIC_CONSTEXPR unsigned compact_float_tag  = 0xFFFE;
+        BOOST_STATIC_CONSTEXPR unsigned compact_bool_tag   = 0xFFFF;
+        BOOST_STATIC_CONSTEXPR unsigned compact_double_tag = 0;
+
+        // Tag of the types stored inside the word, `compact_heap_tag` for all the others
+        template<typename ValueType>
+        struct compact_tag : boost::integral_constant<unsigned, compact_heap_tag> {};
+
+#ifdef BOOST_ANY_DETAIL_NAN_BOXING
+        template<>
+        struct compact_tag<double> : boost::integral_constant<unsigned, compact_double_tag> {};
+
+        template<>
+        struct compact_tag<boost::int32_t> : boost::integral_constant<unsigned, compact_int32_tag> {};
+
+        template<>
+        struct compact_tag<float> : boost::integral_constant<unsigned, compact_float_tag> {};
+
+        template<>
+        struct compact_tag<bool> : boost::integral_constant<unsigned, compact_bool_tag> {};
+#endif
+    } // namespace detail
+
+    class compact_any
+    {
+    public: // structors
+
+        compact_any() BOOST_NOEXCEPT
+        {
+            set_heap(0);
+        }
+
+        template<typename ValueType>
+        compact_any(const ValueType & value)
+        {
+            emplace<BOOST_DEDUCED_TYPENAME remove_cv<BOOST_DEDUCED_TYPENAME decay<const ValueType>::type>::type>(value);
+        }
+
+        compact_any(const compact_any & other)
+        {
+            if (other.tag() == detail::compact_heap_tag && other.heap())
+                set_heap(other.heap()->clone());
+            else
+                std::memcpy(storage.address(), other.storage.address(), sizeof(storage));
+        }
+
+        compact_any(compact_any&& other) BOOST_NOEXCEPT
+        {
+            std::memcpy(storage.address(), other.storage.address(), sizeof(storage));
+            other.set_heap(0);
+        }
+
+        // Perfect forwarding of ValueType
+        template<typename ValueType>
+        compact_any(ValueType&& value
+            , typename boost::disable_if<boost::is_same<compact_any&, ValueType> >::type* = 0 // disable if value has type `compact_any&`
+            , typename boost::disable_if<boost::is_const<ValueType> >::type* = 0) // disable if value has type `const ValueType&&`
+        {
+            emplace<BOOST_DEDUCED_TYPENAME decay<ValueType>::type>(static_cast<ValueType&&>(value));
+        }
+
+        ~compact_any() BOOST_NOEXCEPT
+        {
+            if (tag() == detail::compact_heap_tag)
+                delete heap();
+        }
+
+    public: // modifiers
+
+        compact_any & swap(compact_any & rhs) BOOST_NOEXCEPT
+        {
+            unsigned char tmp[sizeof(storage)];
+            std::memcpy(tmp, storage.address(), sizeof(storage));
+            std::memcpy(storage.address(), rhs.storage.address(), sizeof(storage));
+            std::memcpy(rhs.storage.address(), tmp, sizeof(storage));
+            return *this;
+        }
+
+        compact_any & operator=(const compact_any& rhs)
+        {
+            compact_any(rhs).swap(*this);
+            return *this;
+        }
+
+        compact_any & operator=(compact_any&& rhs) BOOST_NOEXCEPT
+        {
+            rhs.swap(*this);
+            compact_any().swap(rhs);
+            return *this;
+        }
+
+        // Perfect forwarding of ValueType
+        template <class ValueType>
+        compact_any & operator=(ValueType&& rhs)
+        {
+            compact_any(static_cast<ValueType&&>(rhs)).swap(*this);
+            return *this;
+        }
+
+    public: // queries
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return tag() == detail::compact_heap_tag && !heap();
+        }
+
+        void clear() BOOST_NOEXCEPT
+        {
+            compact_any().swap(*this);
+        }
+
+        const boost::typeindex::type_info& type() const BOOST_NOEXCEPT
+        {
+            switch (tag())
+            {
+            case detail::compact_heap_tag:
+                return heap() ? heap()->type() : boost::typeindex::type_id<void>().type_info();
+            case detail::compact_int32_tag:
+                return boost::typeindex::type_id<boost::int32_t>().type_info();
+            case detail::compact_float_tag:
+                return boost::typeindex::type_id<float>().type_info();
+            case detail::compact_bool_tag:
+                return boost::typeindex::type_id<bool>().type_info();
+            default:
+                return boost::typeindex::type_id<double>().type_info();
+            }
+        }
+
+    private: // types
+
+        class BOOST_SYMBOL_VISIBLE placeholder
+        {
+        public: // structors
+
+            virtual ~placeholder()
+            {
+            }
+
+        public: // queries
+
+            virtual const boost::typeindex::type_info& type() const BOOST_NOEXCEPT = 0;
+
+            virtual placeholder * clone() const = 0;
+
+        };
+
+        template<typename ValueType>
+        class holder
+#ifndef BOOST_NO_CXX11_FINAL
+          final
+#endif
+          : public placeholder
+        {
+        public: // structors
+
+            holder(const ValueType & value)
+              : held(value)
+            {
+            }
+
+            holder(ValueType&& value)
+              : held(static_cast< ValueType&& >(value))
+            {
+            }
+
+        public: // queries
+
+            const boost::typeindex::type_info& type() const BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                return boost::typeindex::type_id<ValueType>().type_info();
+            }
+
+            placeholder * clone() const BOOST_OVERRIDE
+            {
+                return new holder(held);
+            }
+
+        public: // representation
+
+            ValueType held;
+
+        private: // intentionally left unimplemented
+            holder & operator=(const holder &);
+        };
+
+    private: // implementation
+
+        template<typename ValueType, typename Arg>
+        void emplace(Arg&& value)
+        {
+            typedef detail::compact_tag<ValueType> tag_type;
+            emplace_impl<ValueType>(static_cast<Arg&&>(value), boost::integral_constant<bool, tag_type::value == detail::compact_heap_tag>());
+        }
+
+        template<typename ValueType, typename Arg>
+        void emplace_impl(Arg&& value, boost::true_type /*on heap*/)
+        {
+            set_heap(new holder<ValueType>(static_cast<Arg&&>(value)));
+        }
+
+        template<typename ValueType, typename Arg>
+        void emplace_impl(Arg&& value, boost::false_type /*in place*/)
+        {
+            set_word(static_cast<boost::uint64_t>(detail::compact_tag<ValueType>::value) << 48);
+            ::new(payload<ValueType>()) ValueType(static_cast<Arg&&>(value));
+
+            // NaN payloads are not preserved: every NaN is stored as the
+            // canonical quiet NaN, so that none looks like a tag and all of
+            // them have the same bits.
+            if (detail::compact_tag<ValueType>::value == detail::compact_double_tag
+                && (word() & 0x7FFFFFFFFFFFFFFFULL) > 0x7FF0000000000000ULL)
+            {
+                set_word(0x7FF8000000000000ULL);
+            }
+        }
+
+        template<typename ValueType>
+        void * payload() BOOST_NOEXCEPT
+        {
+#if BOOST_ENDIAN_BIG_BYTE
+            return static_cast<unsigned char *>(storage.address()) + sizeof(storage) - sizeof(ValueType);
+#else
+            return storage.address();
+#endif
+        }
+
+        boost::uint64_t word() const BOOST_NOEXCEPT
+        {
+            boost::uint64_t bits = 0;
+            std::memcpy(&bits, storage.address(), sizeof(storage));
+            return bits;
+        }
+
+        void set_word(boost::uint64_t bits) BOOST_NOEXCEPT
+        {
+            std::memcpy(storage.address(), &bits, sizeof(storage));
+        }
+
+#ifdef BOOST_ANY_DETAIL_NAN_BOXING
+        unsigned tag() const BOOST_NOEXCEPT
+        {
+            const unsigned upper = static_cast<unsigned>(word() >> 48);
+            return upper >= detail::compact_heap_tag ? upper : detail::compact_double_tag;
+        }
+
+        placeholder * heap() const BOOST_NOEXCEPT
+        {
+            return reinterpret_cast<placeholder *>(
+                static_cast<std::size_t>(word() & 0x0000FFFFFFFFFFFFULL)
+            );
+        }
+
+        void set_heap(placeholder * content) BOOST_NOEXCEPT
+        {
+            const boost::uint64_t address = reinterpret_cast<std::size_t>(content);
+            BOOST_ASSERT_MSG(!(address >> 48), "boost::anys::compact_any requires 48-bit addresses");
+            set_word((static_cast<boost::uint64_t>(detail::compact_heap_tag) << 48) | address);
+        }
+#else
+        unsigned tag() const BOOST_NOEXCEPT
+        {
+            return detail::compact_heap_tag;
+        }
+
+        placeholder * heap() const BOOST_NOEXCEPT
+        {
+            placeholder * content;
+            std::memcpy(&content, storage.address(), sizeof(content));
+            return content;
+        }
+
+        void set_heap(placeholder * content) BOOST_NOEXCEPT
+        {
+            std::memcpy(storage.address(), &content, sizeof(content));
+        }
+#endif
+
+    private: // representation
+
+        template<typename ValueType>
+        friend ValueType * any_cast(compact_any *) BOOST_NOEXCEPT;
+
+#ifdef BOOST_ANY_DETAIL_NAN_BOXING
+        boost::aligned_storage<sizeof(boost::uint64_t), boost::alignment_of<boost::uint64_t>::value> storage;
+#else
+        boost::aligned_storage<sizeof(void *), boost::alignment_of<void *>::value> storage;
+#endif
+    };
+
+    BOOST_STATIC_ASSERT_MSG(sizeof(compact_any) == sizeof(void *), "compact_any must be one machine word");
+
+    inline void swap(compact_any & lhs, compact_any & rhs) BOOST_NOEXCEPT
+    {
+        lhs.swap(rhs);
+    }
+
+    // For a type stored inside the word the check is a single compare of
+    // the tag; other types are checked as by `boost::any_cast`.
+    template<typename ValueType>
+    ValueType * any_cast(compact_any * operand) BOOST_NOEXCEPT
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_cv<ValueType>::type value_type;
+        typedef detail::compact_tag<value_type> tag_type;
+
+        if (!operand || operand->tag() != tag_type::value)
+            return 0;
+
+        if (tag_type::value != detail::compact_heap_tag)
+            return static_cast<ValueType *>(operand->payload<value_type>());
+
+        compact_any::placeholder * content = operand->heap();
+        return content && content->type() == boost::typeindex::type_id<ValueType>()
+            ? boost::addressof(static_cast<compact_any::holder<value_type> *>(content)->held)
+            : 0;
+    }
+
+    template<typename ValueType>
+    inline const ValueType * any_cast(const compact_any * operand) BOOST_NOEXCEPT
+    {
+        return anys::any_cast<ValueType>(const_cast<compact_any *>(operand));
+    }
+
+    template<typename ValueType>
+    ValueType any_cast(compact_any & operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+
+        nonref * result = anys::any_cast<nonref>(boost::addressof(operand));
+        if(!result)
+            boost::throw_exception(bad_any_cast());
+
+        typedef BOOST_DEDUCED_TYPENAME boost::conditional<
+            boost::is_reference<ValueType>::value,
+            ValueType,
+            BOOST_DEDUCED_TYPENAME boost::add_reference<ValueType>::type
+        >::type ref_type;
+
+        return static_cast<ref_type>(*result);
+    }
+
+    template<typename ValueType>
+    inline ValueType any_cast(const compact_any & operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+        return anys::any_cast<const nonref &>(const_cast<compact_any &>(operand));
+    }
+
+    template<typename ValueType>
+    inline ValueType any_cast(compact_any&& operand)
+    {
+        BOOST_STATIC_ASSERT_MSG(
+            boost::is_rvalue_reference<ValueType&&>::value /*true if ValueType is rvalue or just a value*/
+            || boost::is_const< typename boost::remove_reference<ValueType>::type >::value,
+            "boost::any_cast shall not be used for getting nonconst references to temporary objects"
+        );
+        return anys::any_cast<ValueType>(operand);
+    }
+} // namespace anys
+
+    using boost::anys::compact_any;
+    using boost::anys::any_cast;
+} // namespace boost
+
+#endif
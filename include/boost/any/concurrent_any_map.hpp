@@ -0,0 +1,334 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_CONCURRENT_ANY_MAP_INCLUDED
+#define BOOST_ANY_CONCURRENT_ANY_MAP_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// A thread safe map from strings to `boost::any`, split into shards that are
+// locked independently. Values are held by `std::shared_ptr<const any>`:
+// `find` copies that pointer under a short read lock and returns it, so the
+// caller keeps a consistent snapshot of the value while writers replace it.
+// Lookups take a `string_view` and do not allocate.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_SMART_PTR) \
+    || defined(BOOST_NO_CXX11_HDR_MUTEX)
+#   error boost::anys::concurrent_any_map requires C++11 rvalue references, std::shared_ptr and <mutex>
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/detail/type_hash.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/utility/string_view.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#ifndef BOOST_NO_CXX14_HDR_SHARED_MUTEX
+#   include <shared_mutex>
+#endif
+
+namespace boost
+{
+namespace anys
+{
+    class concurrent_any_map
+      : private boost::noncopyable
+    {
+    public: // types
+
+        // Stays valid and unchanged after the key is reassigned or erased.
+        typedef std::shared_ptr<const boost::any> snapshot;
+
+    public: // structors
+
+        // `shard_count` is rounded up to a power of two.
+        explicit concurrent_any_map(std::size_t shard_count = 16)
+          : shards(round_up_to_power_of_2(shard_count))
+        {
+        }
+
+        ~concurrent_any_map() BOOST_NOEXCEPT
+        {
+            clear();
+        }
+
+    public: // modifiers
+
+        // Inserts `value` unless `key` is present. Returns true if it was
+        // inserted.
+        template<typename ValueType>
+        bool insert(boost::string_view key, ValueType&& value)
+        {
+            const boost::uint64_t hash = hash_of(key);
+            shard & s = shard_of(hash);
+            {
+                read_lock lock(s.guard);
+                if (s.find(hash, key))
+                    return false;
+            }
+
+            snapshot replacement = make_snapshot(static_cast<ValueType&&>(value));
+            write_lock lock(s.guard);
+            if (s.find(hash, key))
+                return false;
+            s.insert(hash, key, replacement);
+            return true;
+        }
+
+        // Sets the value of `key`, readers see either the old or the new
+        // value. The value is constructed before the shard is locked.
+        // Returns true if the key was inserted, false if it was assigned.
+        template<typename ValueType>
+        bool insert_or_assign(boost::string_view key, ValueType&& value)
+        {
+            snapshot replacement = make_snapshot(static_cast<ValueType&&>(value));
+
+            const boost::uint64_t hash = hash_of(key);
+            shard & s = shard_of(hash);
+            write_lock lock(s.guard);
+            if (node * n = s.find(hash, key))
+            {
+                n->value.swap(replacement);
+                lock.unlock(); // the old value is destroyed outside of the lock
+                return false;
+            }
+            s.insert(hash, key, replacement);
+            return true;
+        }
+
+        // Returns true if `key` was present.
+        bool erase(boost::string_view key)
+        {
+            const boost::uint64_t hash = hash_of(key);
+            shard & s = shard_of(hash);
+            node * removed;
+            {
+                write_lock lock(s.guard);
+                removed = s.unlink(hash, key);
+            }
+            delete removed;
+            return removed != 0;
+        }
+
+        void clear() BOOST_NOEXCEPT
+        {
+            for (std::size_t i = 0; i < shards.size(); ++i)
+            {
+                node * removed;
+                {
+                    write_lock lock(shards[i].guard);
+                    removed = shards[i].unlink_all();
+                }
+                while (removed)
+                {
+                    node * next = removed->next;
+                    delete removed;
+                    removed = next;
+                }
+            }
+        }
+
+    public: // queries
+
+        // Null if `key` is not present.
+        snapshot find(boost::string_view key) const
+        {
+            const boost::uint64_t hash = hash_of(key);
+            const shard & s = shard_of(hash);
+            read_lock lock(s.guard);
+            const node * n = s.find(hash, key);
+            return n ? n->value : snapshot();
+        }
+
+        bool contains(boost::string_view key) const
+        {
+            const boost::uint64_t hash = hash_of(key);
+            const shard & s = shard_of(hash);
+            read_lock lock(s.guard);
+            return s.find(hash, key) != 0;
+        }
+
+        // Only a snapshot if other threads are modifying the map.
+        std::size_t size() const
+        {
+            std::size_t result = 0;
+            for (std::size_t i = 0; i < shards.size(); ++i)
+            {
+                read_lock lock(shards[i].guard);
+                result += shards[i].size;
+            }
+            return result;
+        }
+
+        bool empty() const
+        {
+            return !size();
+        }
+
+        std::size_t shard_count() const BOOST_NOEXCEPT
+        {
+            return shards.size();
+        }
+
+    private: // types
+
+#ifndef BOOST_NO_CXX14_HDR_SHARED_MUTEX
+        typedef std::shared_timed_mutex mutex_type;
+        typedef std::shared_lock<mutex_type> read_lock;
+#else
+        typedef std::mutex mutex_type;
+        typedef std::unique_lock<mutex_type> read_lock;
+#endif
+        typedef std::unique_lock<mutex_type> write_lock;
+
+        struct node
+        {
+            node(boost::uint64_t h, boost::string_view k, const snapshot & v)
+              : hash(h), key(k.data(), k.size()), value(v), next(0)
+            {
+            }
+
+            const boost::uint64_t hash;
+            const std::string key;
+            snapshot value;
+            node * next;
+        };
+
+        struct shard
+        {
+            shard()
+              : buckets(8), size(0)
+            {
+            }
+
+            node * find(boost::uint64_t hash, boost::string_view key) const BOOST_NOEXCEPT
+            {
+                for (node * n = buckets[hash & (buckets.size() - 1)]; n; n = n->next)
+                {
+                    if (n->hash == hash && boost::string_view(n->key) == key)
+                        return n;
+                }
+                return 0;
+            }
+
+            void insert(boost::uint64_t hash, boost::string_view key, const snapshot & value)
+            {
+                if (size >= buckets.size())
+                    rehash(buckets.size() * 2);
+
+                node * n = new node(hash, key, value);
+                node *& head = buckets[hash & (buckets.size() - 1)];
+                n->next = head;
+                head = n;
+                ++size;
+            }
+
+            node * unlink(boost::uint64_t hash, boost::string_view key) BOOST_NOEXCEPT
+            {
+                for (node ** link = &buckets[hash & (buckets.size() - 1)]; *link; link = &(*link)->next)
+                {
+                    node * n = *link;
+                    if (n->hash == hash && boost::string_view(n->key) == key)
+                    {
+                        *link = n->next;
+                        --size;
+                        return n;
+                    }
+                }
+                return 0;
+            }
+
+            // Returns all nodes as one list.
+            node * unlink_all() BOOST_NOEXCEPT
+            {
+                node * result = 0;
+                for (std::size_t i = 0; i < buckets.size(); ++i)
+                {
+                    while (node * n = buckets[i])
+                    {
+                        buckets[i] = n->next;
+                        n->next = result;
+                        result = n;
+                    }
+                }
+                size = 0;
+                return result;
+            }
+
+            void rehash(std::size_t bucket_count)
+            {
+                std::vector<node *> rehashed(bucket_count);
+                for (std::size_t i = 0; i < buckets.size(); ++i)
+                {
+                    while (node * n = buckets[i])
+                    {
+                        buckets[i] = n->next;
+                        node *& head = rehashed[n->hash & (bucket_count - 1)];
+                        n->next = head;
+                        head = n;
+                    }
+                }
+                buckets.swap(rehashed);
+            }
+
+            mutable mutex_type guard;
+            std::vector<node *> buckets;
+            std::size_t size;
+
+            // Keeps locks of neighbouring shards on different cache lines
+            char padding[64];
+        };
+
+    private: // implementation
+
+        static std::size_t round_up_to_power_of_2(std::size_t n) BOOST_NOEXCEPT
+        {
+            std::size_t result = 1;
+            while (result < n)
+                result <<= 1;
+            return result;
+        }
+
+        static boost::uint64_t hash_of(boost::string_view key) BOOST_NOEXCEPT
+        {
+            return anys::detail::fnv1a_hash(key.data(), key.size());
+        }
+
+        // The low bits select the bucket, the high bits select the shard.
+        shard & shard_of(boost::uint64_t hash) BOOST_NOEXCEPT
+        {
+            return shards[static_cast<std::size_t>(hash >> 40) & (shards.size() - 1)];
+        }
+
+        const shard & shard_of(boost::uint64_t hash) const BOOST_NOEXCEPT
+        {
+            return shards[static_cast<std::size_t>(hash >> 40) & (shards.size() - 1)];
+        }
+
+        template<typename ValueType>
+        static snapshot make_snapshot(ValueType&& value)
+        {
+            return std::make_shared<const boost::any>(static_cast<ValueType&&>(value));
+        }
+
+    private: // representation
+
+        std::vector<shard> shards;
+    };
+} // namespace anys
+
+    using boost::anys::concurrent_any_map;
+} // namespace boost
+
+#endif
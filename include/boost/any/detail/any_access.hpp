@@ -0,0 +1,136 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_DETAIL_ANY_ACCESS_INCLUDED
+#define BOOST_ANY_DETAIL_ANY_ACCESS_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Type-erased access to the value held by a `boost::any`, for the containers
+// of this library that copy or move held values into storage of their own.
+//
+// Only the holders created by `value_ops::to_any` and `move_to_any` keep the
+// operations on their value; holding one costs no code per type otherwise.
+// Any other non-empty `boost::any` is "boxed": accessed as a value of type
+// `boost::any` itself. `type` and `cast` look through the box.
+
+#include <boost/any.hpp>
+#include <boost/any/detail/type_traits.hpp>
+#include <boost/any/detail/value_ops.hpp>
+#include <boost/config.hpp>
+#include <boost/type_index.hpp>
+
+namespace boost
+{
+namespace anys
+{
+namespace detail
+{
+    template<typename ValueType, bool IsAny = is_same<BOOST_DEDUCED_TYPENAME remove_cv<ValueType>::type, boost::any>::value>
+    struct boxed_cast
+    {
+        static ValueType * get(boost::any * boxed) BOOST_NOEXCEPT
+        {
+            return boost::any_cast<ValueType>(boxed);
+        }
+    };
+
+    // The box itself, for the fields that are of type `boost::any`
+    template<typename ValueType>
+    struct boxed_cast<ValueType, true>
+    {
+        static ValueType * get(boost::any * boxed) BOOST_NOEXCEPT
+        {
+            return boxed;
+        }
+    };
+
+    struct any_access
+    {
+        // Null if `operand` is empty.
+        static const value_ops * ops(const boost::any & operand) BOOST_NOEXCEPT
+        {
+            if (!operand.content)
+                return 0;
+            const value_ops * result;
+            operand.content->value(result);
+            return result ? result : &value_ops_of<boost::any>::value;
+        }
+
+        // The held value, or `&operand` if it is boxed.
+        static void * value(boost::any & operand) BOOST_NOEXCEPT
+        {
+            if (!operand.content)
+                return 0;
+            const value_ops * ops;
+            void * const result = operand.content->value(ops);
+            return ops ? result : &operand;
+        }
+
+        static const void * value(const boost::any & operand) BOOST_NOEXCEPT
+        {
+            return any_access::value(const_cast<boost::any &>(operand));
+        }
+
+        // Whether `operand` refers to a `boost::any::static_storage`.
+        static bool is_static(const boost::any & operand) BOOST_NOEXCEPT
+        {
+            return operand.content && operand.content->is_static();
+        }
+
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+        // `type_hash` of the held type, compared before the type names.
+        // `operand` is not empty.
+        static boost::uint64_t type_hash(const boost::any & operand) BOOST_NOEXCEPT
+        {
+            return operand.content->type_hash;
+        }
+#endif
+
+        // The holder itself, e.g. to be prefetched.
+        static const void * holder(const boost::any & operand) BOOST_NOEXCEPT
+        {
+            return operand.content;
+        }
+
+        static bool boxed(const value_ops * ops) BOOST_NOEXCEPT
+        {
+            return ops == &value_ops_of<boost::any>::value;
+        }
+
+        // Of a value stored with `ops` at `value`; both are null for none.
+        static bool empty(const value_ops * ops, const void * value) BOOST_NOEXCEPT
+        {
+            return !ops || (any_access::boxed(ops) && static_cast<const boost::any *>(value)->empty());
+        }
+
+        static const boost::typeindex::type_info& type(const value_ops * ops, const void * value) BOOST_NOEXCEPT
+        {
+            if (!ops)
+                return boost::typeindex::type_id<void>().type_info();
+            return any_access::boxed(ops) ? static_cast<const boost::any *>(value)->type() : ops->type();
+        }
+
+        // Null if the value is not a `ValueType`.
+        template<typename ValueType>
+        static ValueType * cast(const value_ops * ops, void * value) BOOST_NOEXCEPT
+        {
+            if (!ops)
+                return 0;
+            if (any_access::boxed(ops))
+                return boxed_cast<ValueType>::get(static_cast<boost::any *>(value));
+            return ops->type() == boost::typeindex::type_id<ValueType>()
+                ? static_cast<ValueType *>(value)
+                : 0;
+        }
+    };
+} // namespace detail
+} // namespace anys
+} // namespace boost
+
+#endif
@@ -0,0 +1,168 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_DETAIL_TYPE_CACHE_INCLUDED
+#define BOOST_ANY_DETAIL_TYPE_CACHE_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Lock free open addressing table of immutable entries, keyed by the
+// address of the `type_info` of a held type. Used by the registries that
+// memoize a lookup per held type, so that a memoized lookup takes no lock.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_HDR_ATOMIC)
+#   error boost/any/detail/type_cache.hpp requires C++11 <atomic>
+#endif
+
+#include <boost/core/noncopyable.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/type_index.hpp>
+#include <atomic>
+#include <cstddef>
+
+namespace boost
+{
+namespace anys
+{
+namespace detail
+{
+    // `Entry` has a `const boost::typeindex::type_info * type`. Entries are
+    // published with a compare and exchange on the slot returned by `slot`
+    // and are never removed, so a lookup stops at the first empty slot.
+    //
+    // The table doubles once half full. Entries published to a table that
+    // is being copied may be missing from the new one; they are looked up
+    // again. Replaced tables are kept, linked from the new one, because
+    // other threads may still be reading them; there are no more of them
+    // than doublings.
+    template<typename Entry>
+    class type_cache
+      : private boost::noncopyable
+    {
+    public: // types
+
+        typedef std::atomic<const Entry *> slot_type;
+
+    public: // structors
+
+        BOOST_CONSTEXPR type_cache() BOOST_NOEXCEPT
+          : current(0)
+        {
+        }
+
+    public: // modifiers
+
+        // The slot that holds the entry of `type`, or the empty slot where
+        // to publish it. A null entry may have been replaced by the entry
+        // of another type when the caller looks at it.
+        slot_type & slot(const boost::typeindex::type_info & type)
+        {
+            const table * t = current.load(std::memory_order_acquire);
+            if (!t)
+                t = grow(0);
+
+            for (;;)
+            {
+                for (std::size_t i = hash(&type), n = 0; n <= t->mask; ++i, ++n)
+                {
+                    slot_type & s = t->slots[i & t->mask];
+                    const Entry * const entry = s.load(std::memory_order_acquire);
+                    if (!entry || entry->type == &type)
+                        return s;
+                }
+                t = grow(t); // filled by inserts that raced with a doubling
+            }
+        }
+
+        // To be called once an entry was published to an empty slot
+        void inserted()
+        {
+            const table * const t = current.load(std::memory_order_acquire);
+            if (2 * (t->size.fetch_add(1, std::memory_order_relaxed) + 1) > t->mask + 1)
+                grow(t);
+        }
+
+    private: // types
+
+        struct table
+          : private boost::noncopyable
+        {
+            table(std::size_t capacity, const table * previous)
+              : mask(capacity - 1)
+              , size(0)
+              , previous(previous)
+              , slots(new slot_type[capacity])
+            {
+                for (std::size_t i = 0; i < capacity; ++i)
+                    slots[i].store(0, std::memory_order_relaxed);
+            }
+
+            ~table()
+            {
+                delete[] slots;
+            }
+
+            const std::size_t mask;
+            mutable std::atomic<std::size_t> size;
+            const table * const previous;
+            slot_type * const slots;
+        };
+
+        BOOST_STATIC_CONSTANT(std::size_t, initial_capacity = 64);
+
+    private: // implementation
+
+        // Fibonacci hashing: the low bits of addresses are alignment
+        static std::size_t hash(const void * key) BOOST_NOEXCEPT
+        {
+            const boost::uint64_t h = static_cast<boost::uint64_t>(reinterpret_cast<std::size_t>(key))
+                * 0x9E3779B97F4A7C15ULL;
+            return static_cast<std::size_t>(h >> 32);
+        }
+
+        // Replaces `full` with a table twice as large; the current table if
+        // another thread replaced it first.
+        const table * grow(const table * full)
+        {
+            table * const bigger = new table(full ? 2 * (full->mask + 1) : initial_capacity, full);
+            if (full)
+            {
+                std::size_t copied = 0;
+                for (std::size_t i = 0; i <= full->mask; ++i)
+                {
+                    const Entry * const entry = full->slots[i].load(std::memory_order_acquire);
+                    if (!entry)
+                        continue;
+                    std::size_t j = hash(entry->type);
+                    while (bigger->slots[j & bigger->mask].load(std::memory_order_relaxed))
+                        ++j;
+                    bigger->slots[j & bigger->mask].store(entry, std::memory_order_relaxed);
+                    ++copied;
+                }
+                bigger->size.store(copied, std::memory_order_relaxed);
+            }
+
+            const table * expected = full;
+            if (current.compare_exchange_strong(expected, bigger, std::memory_order_acq_rel))
+                return bigger;
+
+            delete bigger;
+            return expected;
+        }
+
+    private: // representation
+
+        std::atomic<const table *> current;
+    };
+} // namespace detail
+} // namespace anys
+} // namespace boost
+
+#endif
@@ -0,0 +1,119 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_DETAIL_TYPE_HASH_INCLUDED
+#define BOOST_ANY_DETAIL_TYPE_HASH_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// 64-bit FNV-1a hash of the compile time type name. Without RTTI
+// `boost::typeindex::type_index` is `ctti_type_index`, whose comparison is a
+// `strcmp` of the full names; `any_cast` compares these hashes first and only
+// compares the names if the hashes match.
+
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/any/detail/type_traits.hpp>
+#include <boost/type_index/detail/compile_time_type_info.hpp>
+#include <cstddef>
+#include <cstring>
+
+// Same condition that makes `boost/type_index.hpp` select `ctti_type_index`
+#if !defined(BOOST_TYPE_INDEX_USER_TYPEINDEX) && !defined(BOOST_MSVC) \
+    && (defined(BOOST_NO_RTTI) || defined(BOOST_TYPE_INDEX_FORCE_NO_RTTI_COMPATIBILITY))
+#   define BOOST_ANY_DETAIL_USE_TYPE_HASH
+#endif
+
+// Only included by `boost/type_index.hpp` in this case anyway: with RTTI it
+// costs more than all the other includes of `boost/any.hpp` together.
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+#   include <boost/type_index.hpp>
+#   include <boost/type_index/ctti_type_index.hpp>
+#endif
+
+namespace boost
+{
+namespace anys
+{
+namespace detail
+{
+    BOOST_CXX14_CONSTEXPR inline boost::uint64_t fnv1a_hash(const char * name) BOOST_NOEXCEPT
+    {
+        boost::uint64_t hash = 14695981039346656037ULL;
+        for (; *name; ++name)
+        {
+            hash ^= static_cast<unsigned char>(*name);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // Same hash of `size` characters that need not be null terminated.
+    inline boost::uint64_t fnv1a_hash(const char * first, std::size_t size) BOOST_NOEXCEPT
+    {
+        boost::uint64_t hash = 14695981039346656037ULL;
+        for (const char * const last = first + size; first != last; ++first)
+        {
+            hash ^= static_cast<unsigned char>(*first);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // The raw name of `ctti_type_index::type_id<ValueType>()`
+    template<typename ValueType>
+    struct ctti_name
+      : boost::detail::ctti<
+            BOOST_DEDUCED_TYPENAME remove_cv<BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type>::type
+        >
+    {
+    };
+
+    template<typename ValueType>
+    struct type_hash
+    {
+#ifndef BOOST_NO_CXX14_CONSTEXPR
+        static constexpr boost::uint64_t value = anys::detail::fnv1a_hash(ctti_name<ValueType>::n());
+
+        static constexpr boost::uint64_t get() noexcept
+        {
+            return value;
+        }
+#else
+        // Computed on first use: a dynamically initialized static member
+        // could be read by other static initializers before it is set.
+        static boost::uint64_t get() BOOST_NOEXCEPT
+        {
+            static const boost::uint64_t value = anys::detail::fnv1a_hash(ctti_name<ValueType>::n());
+            return value;
+        }
+#endif
+    };
+
+#ifndef BOOST_NO_CXX14_CONSTEXPR
+    template<typename ValueType>
+    constexpr boost::uint64_t type_hash<ValueType>::value;
+#endif
+
+#ifdef BOOST_ANY_DETAIL_USE_TYPE_HASH
+    // To be called once the hashes matched. Names produced by the same
+    // `ctti<T>` instantiation usually share storage, so the address is
+    // checked before the characters.
+    template<typename ValueType>
+    inline bool is_same_type_name(const boost::typeindex::type_info& held) BOOST_NOEXCEPT
+    {
+        const char * const lhs = boost::typeindex::ctti_type_index(held).raw_name();
+        const char * const rhs = boost::typeindex::ctti_type_index::type_id<ValueType>().raw_name();
+        return lhs == rhs || !std::strcmp(lhs, rhs);
+    }
+#endif
+} // namespace detail
+} // namespace anys
+} // namespace boost
+
+#endif
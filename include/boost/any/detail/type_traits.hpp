@@ -0,0 +1,90 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_DETAIL_TYPE_TRAITS_INCLUDED
+#define BOOST_ANY_DETAIL_TYPE_TRAITS_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// The type traits used by `boost/any.hpp`. They come from the standard
+// `<type_traits>` where it is available, which is much cheaper to include
+// than the Boost.TypeTraits headers; define `BOOST_ANY_NO_STD_TYPE_TRAITS`
+// to use Boost.TypeTraits anyway.
+
+#include <boost/config.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_TYPE_TRAITS) && !defined(BOOST_ANY_NO_STD_TYPE_TRAITS)
+#   define BOOST_ANY_DETAIL_STD_TYPE_TRAITS
+#endif
+
+#ifdef BOOST_ANY_DETAIL_STD_TYPE_TRAITS
+#   include <type_traits>
+#else
+#   include <boost/type_traits/add_reference.hpp>
+#   include <boost/type_traits/alignment_of.hpp>
+#   include <boost/type_traits/conditional.hpp>
+#   include <boost/type_traits/decay.hpp>
+#   include <boost/type_traits/has_trivial_copy.hpp>
+#   include <boost/type_traits/has_trivial_destructor.hpp>
+#   include <boost/type_traits/has_trivial_move_constructor.hpp>
+#   include <boost/type_traits/is_const.hpp>
+#   include <boost/type_traits/is_constructible.hpp>
+#   include <boost/type_traits/is_reference.hpp>
+#   include <boost/type_traits/is_rvalue_reference.hpp>
+#   include <boost/type_traits/is_same.hpp>
+#   include <boost/type_traits/remove_cv.hpp>
+#   include <boost/type_traits/remove_reference.hpp>
+#   include <boost/utility/enable_if.hpp>
+#endif
+
+namespace boost
+{
+namespace anys
+{
+namespace detail
+{
+#ifdef BOOST_ANY_DETAIL_STD_TYPE_TRAITS
+    template<typename T> struct add_reference : std::add_lvalue_reference<T> {};
+    template<typename T> struct alignment_of : std::alignment_of<T> {};
+    template<bool Condition, typename T, typename F> struct conditional : std::conditional<Condition, T, F> {};
+    template<typename T> struct decay : std::decay<T> {};
+    template<typename T> struct has_trivial_copy : std::is_trivially_copy_constructible<T> {};
+    template<typename T> struct has_trivial_destructor : std::is_trivially_destructible<T> {};
+    template<typename T> struct has_trivial_move_constructor : std::is_trivially_move_constructible<T> {};
+    template<typename T> struct is_const : std::is_const<T> {};
+    template<typename T> struct is_move_constructible : std::is_move_constructible<T> {};
+    template<typename T> struct is_reference : std::is_reference<T> {};
+    template<typename T> struct is_rvalue_reference : std::is_rvalue_reference<T> {};
+    template<typename T, typename U> struct is_same : std::is_same<T, U> {};
+    template<typename T> struct remove_cv : std::remove_cv<T> {};
+    template<typename T> struct remove_reference : std::remove_reference<T> {};
+    template<typename Condition, typename T = void> struct disable_if : std::enable_if<!Condition::value, T> {};
+#else
+    using boost::add_reference;
+    using boost::alignment_of;
+    using boost::conditional;
+    using boost::decay;
+    using boost::has_trivial_copy;
+    using boost::has_trivial_destructor;
+    using boost::has_trivial_move_constructor;
+    using boost::is_const;
+#   ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    template<typename T> struct is_move_constructible : boost::is_constructible<T, T&&> {};
+#   endif
+    using boost::is_reference;
+    using boost::is_rvalue_reference;
+    using boost::is_same;
+    using boost::remove_cv;
+    using boost::remove_reference;
+    using boost::disable_if;
+#endif
+} // namespace detail
+} // namespace anys
+} // namespace boost
+
+#endif
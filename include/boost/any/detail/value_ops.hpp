@@ -0,0 +1,180 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_DETAIL_VALUE_OPS_INCLUDED
+#define BOOST_ANY_DETAIL_VALUE_OPS_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Type-erased operations on a value that lives in caller-provided storage.
+// Used by the containers that keep payloads in their own blocks instead of
+// allocating one `any::holder` per value.
+
+#include <boost/config.hpp>
+#include <boost/type_index.hpp>
+#include <boost/any/detail/type_traits.hpp>
+#include <cstddef>
+#include <new>
+
+namespace boost
+{
+    // Complete wherever `to_any` and `move_to_any` are instantiated:
+    // `boost/any.hpp` includes this header itself.
+    class any;
+
+namespace anys
+{
+namespace detail
+{
+    enum value_operation
+    {
+        value_type_info,    // `*dst` is set to the `type_info` of the type
+        value_copy,
+        value_move,
+        value_destroy,
+        value_copy_to_any,  // `dst` is a `boost::any`
+        value_move_to_any   // `dst` is a `boost::any`
+    };
+
+    // One static table per stored type. Unlike `any::placeholder` the value
+    // is not owned by the table, so the same table serves every copy. All
+    // the operations go through a single function, which keeps the code
+    // generated for each type small.
+    struct value_ops
+    {
+        void (*manage)(value_operation operation, void * dst, const void * src);
+        std::size_t size;
+        std::size_t align;
+        bool trivial; // `copy` may be replaced by `memcpy`, `destroy` does nothing
+
+        const boost::typeindex::type_info& type() const
+        {
+            const boost::typeindex::type_info * result;
+            manage(value_type_info, &result, 0);
+            return *result;
+        }
+
+        void copy(void * dst, const void * src) const
+        {
+            manage(value_copy, dst, src);
+        }
+
+        void move(void * dst, void * src) const
+        {
+            manage(value_move, dst, src);
+        }
+
+        void destroy(void * value) const
+        {
+            manage(value_destroy, value, 0);
+        }
+
+        void to_any(const void * src, boost::any & dst) const
+        {
+            manage(value_copy_to_any, &dst, src);
+        }
+
+        void move_to_any(void * src, boost::any & dst) const
+        {
+            manage(value_move_to_any, &dst, src);
+        }
+    };
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    // The source of a move, a copy if `ValueType` cannot be moved
+    template<typename ValueType, bool Movable = detail::is_move_constructible<ValueType>::value>
+    struct move_source
+    {
+        static ValueType&& get(const void * src) BOOST_NOEXCEPT
+        {
+            return static_cast<ValueType&&>(*static_cast<ValueType *>(const_cast<void *>(src)));
+        }
+    };
+
+    template<typename ValueType>
+    struct move_source<ValueType, false>
+    {
+        static const ValueType & get(const void * src) BOOST_NOEXCEPT
+        {
+            return *static_cast<const ValueType *>(src);
+        }
+    };
+#else
+    template<typename ValueType>
+    struct move_source
+    {
+        static const ValueType & get(const void * src) BOOST_NOEXCEPT
+        {
+            return *static_cast<const ValueType *>(src);
+        }
+    };
+#endif
+
+    // Assigns to a `boost::any` in a holder that keeps the operations of
+    // `ValueType`, see `any_access`. Defined in `boost/any.hpp`.
+    template<typename ValueType>
+    struct any_assign;
+
+    template<typename ValueType>
+    struct value_ops_of
+    {
+        static void manage(value_operation operation, void * dst, const void * src)
+        {
+            switch (operation)
+            {
+            case value_type_info:
+                *static_cast<const boost::typeindex::type_info **>(dst) = &boost::typeindex::type_id<ValueType>().type_info();
+                break;
+            case value_copy:
+                ::new(dst) ValueType(*static_cast<const ValueType *>(src));
+                break;
+            case value_move:
+                ::new(dst) ValueType(move_source<ValueType>::get(src));
+                break;
+            case value_destroy:
+                static_cast<ValueType *>(dst)->~ValueType();
+                break;
+            case value_copy_to_any:
+                any_assign<ValueType>::copy(*static_cast<boost::any *>(dst), src);
+                break;
+            case value_move_to_any:
+                any_assign<ValueType>::move(*static_cast<boost::any *>(dst), src);
+                break;
+            }
+        }
+
+        static const value_ops value;
+    };
+
+    template<typename ValueType>
+    const value_ops value_ops_of<ValueType>::value = {
+        &value_ops_of<ValueType>::manage,
+        sizeof(ValueType),
+        detail::alignment_of<ValueType>::value,
+        detail::has_trivial_copy<ValueType>::value && detail::has_trivial_destructor<ValueType>::value
+    };
+
+    // Alignment guaranteed by `::operator new`.
+    union max_align
+    {
+        long double ld;
+        long long ll;
+        double d;
+        void * p;
+        void (*fp)();
+    };
+
+    inline std::size_t align_up(std::size_t offset, std::size_t alignment) BOOST_NOEXCEPT
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+} // namespace detail
+} // namespace anys
+} // namespace boost
+
+#endif
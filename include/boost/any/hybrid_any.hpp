@@ -0,0 +1,527 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_HYBRID_ANY_INCLUDED
+#define BOOST_ANY_HYBRID_ANY_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// A variant type like boost::any with a closed set of "hot" types that are
+// stored inline, like in a `boost::variant`, and told apart by an index.
+// Values of the hot types are never allocated and `any_cast` to a hot type
+// is a single compare of the index. Values of all the other types are held
+// by a `boost::any` stored in the same place.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) \
+    || defined(BOOST_NO_CXX11_CONSTEXPR)
+#   error boost::anys::hybrid_any requires C++11 rvalue references, variadic templates and constexpr
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/detail/value_ops.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/add_reference.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/is_nothrow_move_constructible.hpp>
+#include <boost/type_traits/is_reference.hpp>
+#include <boost/type_traits/is_rvalue_reference.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <cstddef>
+
+namespace boost
+{
+namespace anys
+{
+    template<typename... Hot>
+    class hybrid_any;
+
+    namespace detail
+    {
+        // 1-based position of `ValueType` in `Hot...`, 0 if it is not there
+        template<typename ValueType, typename... Hot>
+        struct hot_index
+          : boost::integral_constant<unsigned, 0>
+        {
+        };
+
+        template<typename ValueType, typename First, typename... Rest>
+        struct hot_index<ValueType, First, Rest...>
+          : boost::integral_constant<unsigned,
+                boost::is_same<ValueType, First>::value
+                    ? 1u
+                    : (hot_index<ValueType, Rest...>::value ? hot_index<ValueType, Rest...>::value + 1u : 0u)
+            >
+        {
+        };
+
+        template<typename... Types>
+        struct all_nothrow_move
+          : boost::true_type
+        {
+        };
+
+        template<typename First, typename... Rest>
+        struct all_nothrow_move<First, Rest...>
+          : boost::integral_constant<bool,
+                boost::is_nothrow_move_constructible<First>::value && all_nothrow_move<Rest...>::value
+            >
+        {
+        };
+
+        BOOST_CONSTEXPR inline std::size_t max_of(std::size_t value) BOOST_NOEXCEPT
+        {
+            return value;
+        }
+
+        template<typename... Rest>
+        BOOST_CONSTEXPR std::size_t max_of(std::size_t first, std::size_t second, Rest... rest) BOOST_NOEXCEPT
+        {
+            return detail::max_of(first > second ? first : second, rest...);
+        }
+
+        template<typename... Types>
+        struct type_list
+        {
+        };
+
+        template<typename ValueType>
+        struct is_hybrid_any
+          : boost::false_type
+        {
+        };
+
+        template<typename... Hot>
+        struct is_hybrid_any<hybrid_any<Hot...> >
+          : boost::true_type
+        {
+        };
+    } // namespace detail
+
+    template<typename... Hot>
+    class hybrid_any
+    {
+    public: // types
+
+        template<typename ValueType>
+        struct is_hot
+          : boost::integral_constant<bool, detail::hot_index<ValueType, Hot...>::value != 0>
+        {
+        };
+
+        // `which()` of a value that is not of a hot type
+        BOOST_STATIC_CONSTANT(unsigned, fallback_index = sizeof...(Hot) + 1);
+
+    public: // structors
+
+        BOOST_CONSTEXPR hybrid_any() BOOST_NOEXCEPT
+          : index(0)
+        {
+        }
+
+        // A `boost::any` holding a hot type is unwrapped.
+        template<typename ValueType
+            , typename = BOOST_DEDUCED_TYPENAME boost::disable_if<
+                detail::is_hybrid_any<BOOST_DEDUCED_TYPENAME decay<ValueType>::type>
+            >::type>
+        hybrid_any(ValueType&& value)
+          : index(0)
+        {
+            emplace(static_cast<ValueType&&>(value));
+        }
+
+        hybrid_any(const hybrid_any & other)
+          : index(0)
+        {
+            if (other.index)
+            {
+                hybrid_any::copy_at<0>(other, detail::type_list<Hot...>());
+                index = other.index;
+            }
+        }
+
+        // `other` is left empty
+        hybrid_any(hybrid_any&& other) BOOST_NOEXCEPT_IF(detail::all_nothrow_move<Hot...>::value)
+          : index(0)
+        {
+            if (other.index)
+            {
+                hybrid_any::move_at<0>(other, detail::type_list<Hot...>());
+                index = other.index;
+                other.clear();
+            }
+        }
+
+        ~hybrid_any() BOOST_NOEXCEPT
+        {
+            clear();
+        }
+
+    public: // modifiers
+
+        hybrid_any & swap(hybrid_any & rhs) BOOST_NOEXCEPT_IF(detail::all_nothrow_move<Hot...>::value)
+        {
+            hybrid_any tmp(static_cast<hybrid_any&&>(rhs));
+            rhs = static_cast<hybrid_any&&>(*this);
+            *this = static_cast<hybrid_any&&>(tmp);
+            return *this;
+        }
+
+        hybrid_any & operator=(const hybrid_any& rhs)
+        {
+            if (this != &rhs)
+            {
+                hybrid_any tmp(rhs);
+                *this = static_cast<hybrid_any&&>(tmp);
+            }
+            return *this;
+        }
+
+        hybrid_any & operator=(hybrid_any&& rhs) BOOST_NOEXCEPT_IF(detail::all_nothrow_move<Hot...>::value)
+        {
+            if (this != &rhs)
+            {
+                clear();
+                if (rhs.index)
+                {
+                    hybrid_any::move_at<0>(rhs, detail::type_list<Hot...>());
+                    index = rhs.index;
+                    rhs.clear();
+                }
+            }
+            return *this;
+        }
+
+        template <class ValueType>
+        typename boost::disable_if<
+            detail::is_hybrid_any<BOOST_DEDUCED_TYPENAME decay<ValueType>::type>, hybrid_any &
+        >::type operator=(ValueType&& rhs)
+        {
+            hybrid_any tmp(static_cast<ValueType&&>(rhs));
+            return *this = static_cast<hybrid_any&&>(tmp);
+        }
+
+        void clear() BOOST_NOEXCEPT
+        {
+            if (index)
+            {
+                hybrid_any::destroy_at<0>(detail::type_list<Hot...>());
+                index = 0;
+            }
+        }
+
+    public: // queries
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return !index;
+        }
+
+        // 0 if empty, the 1-based position of the held type in `Hot...`,
+        // or `fallback_index`.
+        unsigned which() const BOOST_NOEXCEPT
+        {
+            return index;
+        }
+
+        const boost::typeindex::type_info& type() const BOOST_NOEXCEPT
+        {
+            if (index == fallback_index)
+                return fallback().type();
+            return index ? ops_of(index).type() : boost::typeindex::type_id<void>().type_info();
+        }
+
+        // Deep copy of the value into a `boost::any`.
+        boost::any to_any() const
+        {
+            boost::any result;
+            if (index == fallback_index)
+                result = fallback();
+            else if (index)
+                ops_of(index).to_any(address(), result);
+            return result;
+        }
+
+        // Calls `visitor` with a reference to the held hot value, or to the
+        // `boost::any` holding any other value. Does nothing if empty.
+        template<typename Visitor>
+        void visit(Visitor & visitor)
+        {
+            hybrid_any::visit_at<0>(*this, visitor, detail::type_list<Hot...>());
+        }
+
+        template<typename Visitor>
+        void visit(Visitor & visitor) const
+        {
+            hybrid_any::visit_at<0>(*this, visitor, detail::type_list<Hot...>());
+        }
+
+    private: // types
+
+        typedef BOOST_DEDUCED_TYPENAME boost::aligned_storage<
+            detail::max_of(sizeof(boost::any), sizeof(Hot)...),
+            detail::max_of(boost::alignment_of<boost::any>::value, boost::alignment_of<Hot>::value...)
+        >::type storage_type;
+
+        BOOST_STATIC_ASSERT_MSG(sizeof...(Hot) < 255, "too many hot types");
+
+    private: // implementation
+
+        // Hot types first, then the `boost::any` of the fallback. Only for
+        // the queries: copies, moves and destruction are inline, see `copy_at`.
+        static const detail::value_ops & ops_of(unsigned i) BOOST_NOEXCEPT
+        {
+            static const detail::value_ops * const table[] = {
+                &detail::value_ops_of<Hot>::value..., &detail::value_ops_of<boost::any>::value
+            };
+            return *table[i - 1];
+        }
+
+        void * address() BOOST_NOEXCEPT
+        {
+            return storage.address();
+        }
+
+        const void * address() const BOOST_NOEXCEPT
+        {
+            return storage.address();
+        }
+
+        boost::any & fallback() BOOST_NOEXCEPT
+        {
+            return *static_cast<boost::any *>(address());
+        }
+
+        const boost::any & fallback() const BOOST_NOEXCEPT
+        {
+            return *static_cast<const boost::any *>(address());
+        }
+
+        template<typename ValueType>
+        void emplace(ValueType&& value)
+        {
+            typedef BOOST_DEDUCED_TYPENAME remove_cv<BOOST_DEDUCED_TYPENAME decay<ValueType>::type>::type value_type;
+            emplace_dispatch<value_type>(static_cast<ValueType&&>(value),
+                boost::integral_constant<int, is_hot<value_type>::value ? 0 : (boost::is_same<value_type, boost::any>::value ? 1 : 2)>());
+        }
+
+        template<typename ValueType, typename Arg>
+        void emplace_dispatch(Arg&& value, boost::integral_constant<int, 0>) // hot type
+        {
+            ::new(address()) ValueType(static_cast<Arg&&>(value));
+            index = detail::hot_index<ValueType, Hot...>::value;
+        }
+
+        template<typename ValueType, typename Arg>
+        void emplace_dispatch(Arg&& value, boost::integral_constant<int, 1>) // boost::any
+        {
+            unwrap(static_cast<Arg&&>(value), detail::type_list<Hot...>());
+        }
+
+        template<typename ValueType, typename Arg>
+        void emplace_dispatch(Arg&& value, boost::integral_constant<int, 2>) // other types
+        {
+            ::new(address()) boost::any(static_cast<Arg&&>(value));
+            index = fallback_index;
+        }
+
+        template<typename Arg>
+        void unwrap(Arg&& value, detail::type_list<>)
+        {
+            if (!value.empty())
+            {
+                ::new(address()) boost::any(static_cast<Arg&&>(value));
+                index = fallback_index;
+            }
+        }
+
+        template<typename Arg, typename First, typename... Rest>
+        void unwrap(Arg&& value, detail::type_list<First, Rest...>)
+        {
+            if (First * hot = boost::any_cast<First>(const_cast<boost::any *>(boost::addressof(value))))
+            {
+                typedef BOOST_DEDUCED_TYPENAME boost::conditional<
+                    boost::is_const<BOOST_DEDUCED_TYPENAME remove_reference<Arg>::type>::value
+                        || !boost::is_rvalue_reference<Arg&&>::value,
+                    const First &,
+                    First&&
+                >::type source_type;
+
+                ::new(address()) First(static_cast<source_type>(*hot));
+                index = detail::hot_index<First, Hot...>::value;
+                return;
+            }
+            unwrap(static_cast<Arg&&>(value), detail::type_list<Rest...>());
+        }
+
+        // Copy, move and destruction of the value at index `I + 1` or after.
+        // A chain of compares of the index with constants, which compilers
+        // turn into a switch, around the inline operations of each type: no
+        // call through `value_ops` for the hot types.
+        template<unsigned I>
+        void copy_at(const hybrid_any & other, detail::type_list<>)
+        {
+            ::new(address()) boost::any(other.fallback());
+        }
+
+        template<unsigned I, typename First, typename... Rest>
+        void copy_at(const hybrid_any & other, detail::type_list<First, Rest...>)
+        {
+            if (other.index == I + 1)
+                ::new(address()) First(*static_cast<const First *>(other.address()));
+            else
+                hybrid_any::copy_at<I + 1>(other, detail::type_list<Rest...>());
+        }
+
+        template<unsigned I>
+        void move_at(hybrid_any & other, detail::type_list<>) BOOST_NOEXCEPT
+        {
+            ::new(address()) boost::any(static_cast<boost::any&&>(other.fallback()));
+        }
+
+        template<unsigned I, typename First, typename... Rest>
+        void move_at(hybrid_any & other, detail::type_list<First, Rest...>)
+            BOOST_NOEXCEPT_IF((detail::all_nothrow_move<First, Rest...>::value))
+        {
+            if (other.index == I + 1)
+                ::new(address()) First(static_cast<First&&>(*static_cast<First *>(other.address())));
+            else
+                hybrid_any::move_at<I + 1>(other, detail::type_list<Rest...>());
+        }
+
+        template<unsigned I>
+        void destroy_at(detail::type_list<>) BOOST_NOEXCEPT
+        {
+            fallback().~any();
+        }
+
+        template<unsigned I, typename First, typename... Rest>
+        void destroy_at(detail::type_list<First, Rest...>) BOOST_NOEXCEPT
+        {
+            if (index == I + 1)
+                static_cast<First *>(address())->~First();
+            else
+                hybrid_any::destroy_at<I + 1>(detail::type_list<Rest...>());
+        }
+
+        template<unsigned I, typename Self, typename Visitor>
+        static void visit_at(Self & self, Visitor & visitor, detail::type_list<>)
+        {
+            if (self.index == fallback_index)
+                visitor(self.fallback());
+        }
+
+        template<unsigned I, typename Self, typename Visitor, typename First, typename... Rest>
+        static void visit_at(Self & self, Visitor & visitor, detail::type_list<First, Rest...>)
+        {
+            typedef BOOST_DEDUCED_TYPENAME boost::conditional<
+                boost::is_const<Self>::value, const First, First
+            >::type value_type;
+
+            if (self.index == I + 1)
+                visitor(*static_cast<value_type *>(self.address()));
+            else
+                hybrid_any::visit_at<I + 1>(self, visitor, detail::type_list<Rest...>());
+        }
+
+    private: // representation
+
+        template<typename ValueType, typename... Types>
+        friend ValueType * any_cast(hybrid_any<Types...> *) BOOST_NOEXCEPT;
+
+        storage_type storage;
+        unsigned char index;
+    };
+
+    template<typename... Hot>
+    inline void swap(hybrid_any<Hot...> & lhs, hybrid_any<Hot...> & rhs)
+        BOOST_NOEXCEPT_IF(detail::all_nothrow_move<Hot...>::value)
+    {
+        lhs.swap(rhs);
+    }
+
+    // For a hot type the check is a single compare of the index; other
+    // types are checked by `boost::any_cast` of the fallback.
+    template<typename ValueType, typename... Hot>
+    ValueType * any_cast(hybrid_any<Hot...> * operand) BOOST_NOEXCEPT
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_cv<ValueType>::type value_type;
+        BOOST_CONSTEXPR_OR_CONST unsigned hot = detail::hot_index<value_type, Hot...>::value;
+
+        if (hot)
+        {
+            return operand && operand->index == hot
+                ? static_cast<ValueType *>(operand->address())
+                : 0;
+        }
+
+        return operand && operand->index == hybrid_any<Hot...>::fallback_index
+            ? boost::any_cast<ValueType>(boost::addressof(operand->fallback()))
+            : 0;
+    }
+
+    template<typename ValueType, typename... Hot>
+    inline const ValueType * any_cast(const hybrid_any<Hot...> * operand) BOOST_NOEXCEPT
+    {
+        return anys::any_cast<ValueType>(const_cast<hybrid_any<Hot...> *>(operand));
+    }
+
+    template<typename ValueType, typename... Hot>
+    ValueType any_cast(hybrid_any<Hot...> & operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+
+        nonref * result = anys::any_cast<nonref>(boost::addressof(operand));
+        if(!result)
+            boost::throw_exception(bad_any_cast());
+
+        typedef BOOST_DEDUCED_TYPENAME boost::conditional<
+            boost::is_reference<ValueType>::value,
+            ValueType,
+            BOOST_DEDUCED_TYPENAME boost::add_reference<ValueType>::type
+        >::type ref_type;
+
+        return static_cast<ref_type>(*result);
+    }
+
+    template<typename ValueType, typename... Hot>
+    inline ValueType any_cast(const hybrid_any<Hot...> & operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+        return anys::any_cast<const nonref &>(const_cast<hybrid_any<Hot...> &>(operand));
+    }
+
+    template<typename ValueType, typename... Hot>
+    inline ValueType any_cast(hybrid_any<Hot...>&& operand)
+    {
+        BOOST_STATIC_ASSERT_MSG(
+            boost::is_rvalue_reference<ValueType&&>::value /*true if ValueType is rvalue or just a value*/
+            || boost::is_const< typename boost::remove_reference<ValueType>::type >::value,
+            "boost::any_cast shall not be used for getting nonconst references to temporary objects"
+        );
+        return anys::any_cast<ValueType>(operand);
+    }
+} // namespace anys
+
+    using boost::anys::hybrid_any;
+    using boost::anys::any_cast;
+} // namespace boost
+
+#endif
@@ -0,0 +1,469 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_INTERNED_ANY_INCLUDED
+#define BOOST_ANY_INTERNED_ANY_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// An immutable variant type like boost::any whose values are hash-consed:
+// equal values of the same type share one reference counted holder in a
+// process wide table. Copies only touch the reference count and equality
+// is a pointer comparison. Held types need `boost::hash` and `operator==`.
+// The table is split into shards that are locked independently; a holder
+// is removed when the last `interned_any` referring to it is destroyed.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_HDR_ATOMIC) \
+    || defined(BOOST_NO_CXX11_HDR_MUTEX)
+#   error boost::anys::interned_any requires C++11 rvalue references, <atomic> and <mutex>
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/detail/value_ops.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace boost
+{
+namespace anys
+{
+    namespace detail
+    {
+        class interned_entry
+          : private boost::noncopyable
+        {
+        public: // structors
+
+            interned_entry(const value_ops & o, boost::uint64_t h) BOOST_NOEXCEPT
+              : ops(&o), hash(h), refs(1), next(0)
+            {
+            }
+
+            virtual ~interned_entry()
+            {
+            }
+
+        public: // queries
+
+            // `other` points to a value of the held type
+            virtual bool equal(const void * other) const = 0;
+
+            virtual const void * value() const BOOST_NOEXCEPT = 0;
+
+        public: // representation
+
+            const value_ops * const ops;
+            const boost::uint64_t hash;
+            std::atomic<std::size_t> refs;
+            interned_entry * next;
+        };
+
+        template<typename ValueType>
+        class interned_holder
+#ifndef BOOST_NO_CXX11_FINAL
+          final
+#endif
+          : public interned_entry
+        {
+        public: // structors
+
+            template<typename Arg>
+            interned_holder(boost::uint64_t h, Arg&& arg)
+              : interned_entry(value_ops_of<ValueType>::value, h)
+              , held(static_cast<Arg&&>(arg))
+            {
+            }
+
+        public: // queries
+
+            bool equal(const void * other) const BOOST_OVERRIDE
+            {
+                return held == *static_cast<const ValueType *>(other);
+            }
+
+            const void * value() const BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                return boost::addressof(held);
+            }
+
+        public: // representation
+
+            const ValueType held;
+        };
+
+        class intern_table
+          : private boost::noncopyable
+        {
+        public: // structors
+
+            // Never destroyed, so that values with static storage duration
+            // can still be released at exit.
+            static intern_table & instance()
+            {
+                static intern_table * const table = new intern_table();
+                return *table;
+            }
+
+        public: // modifiers
+
+            // Returns the holder of a value equal to `value`, adding a
+            // reference, or a new holder.
+            template<typename ValueType, typename Arg>
+            interned_entry * intern(Arg&& arg)
+            {
+                const ValueType & value = arg;
+                const boost::uint64_t hash = hash_of(value);
+                shard & s = shard_of(hash);
+                {
+                    std::lock_guard<std::mutex> lock(s.guard);
+                    if (interned_entry * found = s.find(hash, value_ops_of<ValueType>::value, boost::addressof(value)))
+                        return found;
+                }
+
+                // Constructed outside of the lock, dropped if another thread
+                // interned an equal value meanwhile
+                interned_entry * fresh = new interned_holder<ValueType>(hash, static_cast<Arg&&>(arg));
+                interned_entry * found;
+                {
+                    std::lock_guard<std::mutex> lock(s.guard);
+                    found = s.find(hash, *fresh->ops, fresh->value());
+                    if (!found)
+                    {
+                        BOOST_TRY {
+                            s.insert(fresh);
+                        } BOOST_CATCH(...) {
+                            delete fresh;
+                            BOOST_RETHROW
+                        }
+                        BOOST_CATCH_END
+                    }
+                }
+                if (found)
+                {
+                    delete fresh;
+                    return found;
+                }
+                return fresh;
+            }
+
+            // The count drops to zero only under the lock of the shard,
+            // together with the removal of the holder, so `find` never
+            // revives a holder that is being destroyed.
+            void release(interned_entry * entry) BOOST_NOEXCEPT
+            {
+                std::size_t count = entry->refs.load(std::memory_order_relaxed);
+                while (count > 1)
+                {
+                    if (entry->refs.compare_exchange_weak(count, count - 1, std::memory_order_release, std::memory_order_relaxed))
+                        return;
+                }
+
+                shard & s = shard_of(entry->hash);
+                {
+                    std::lock_guard<std::mutex> lock(s.guard);
+                    if (entry->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                        return;
+                    s.unlink(entry);
+                }
+                delete entry;
+            }
+
+        public: // queries
+
+            // Number of distinct values; a snapshot if other threads intern.
+            std::size_t size() const
+            {
+                std::size_t result = 0;
+                for (std::size_t i = 0; i < shard_count; ++i)
+                {
+                    std::lock_guard<std::mutex> lock(shards[i].guard);
+                    result += shards[i].size;
+                }
+                return result;
+            }
+
+        private: // types
+
+            BOOST_STATIC_CONSTANT(std::size_t, shard_count = 64);
+
+            struct shard
+            {
+                shard()
+                  : buckets(16), size(0)
+                {
+                }
+
+                // Adds a reference to the holder found
+                interned_entry * find(boost::uint64_t hash, const value_ops & ops, const void * value) const
+                {
+                    for (interned_entry * e = buckets[hash & (buckets.size() - 1)]; e; e = e->next)
+                    {
+                        if (e->hash == hash && same_type(*e->ops, ops) && e->equal(value))
+                        {
+                            e->refs.fetch_add(1, std::memory_order_relaxed);
+                            return e;
+                        }
+                    }
+                    return 0;
+                }
+
+                void insert(interned_entry * entry)
+                {
+                    if (size >= buckets.size())
+                        rehash(buckets.size() * 2);
+
+                    interned_entry *& head = buckets[entry->hash & (buckets.size() - 1)];
+                    entry->next = head;
+                    head = entry;
+                    ++size;
+                }
+
+                void unlink(interned_entry * entry) BOOST_NOEXCEPT
+                {
+                    for (interned_entry ** link = &buckets[entry->hash & (buckets.size() - 1)]; *link; link = &(*link)->next)
+                    {
+                        if (*link == entry)
+                        {
+                            *link = entry->next;
+                            --size;
+                            return;
+                        }
+                    }
+                }
+
+                void rehash(std::size_t bucket_count)
+                {
+                    std::vector<interned_entry *> rehashed(bucket_count);
+                    for (std::size_t i = 0; i < buckets.size(); ++i)
+                    {
+                        while (interned_entry * e = buckets[i])
+                        {
+                            buckets[i] = e->next;
+                            interned_entry *& head = rehashed[e->hash & (bucket_count - 1)];
+                            e->next = head;
+                            head = e;
+                        }
+                    }
+                    buckets.swap(rehashed);
+                }
+
+                mutable std::mutex guard;
+                std::vector<interned_entry *> buckets;
+                std::size_t size;
+
+                // Keeps locks of neighbouring shards on different cache lines
+                char padding[64];
+            };
+
+        private: // implementation
+
+            intern_table()
+            {
+            }
+
+            static bool same_type(const value_ops & lhs, const value_ops & rhs) BOOST_NOEXCEPT
+            {
+                // Tables of the same type may differ across shared libraries
+                return &lhs == &rhs
+                    || boost::typeindex::type_index(lhs.type()) == boost::typeindex::type_index(rhs.type());
+            }
+
+            template<typename ValueType>
+            static boost::uint64_t hash_of(const ValueType & value)
+            {
+                // Spreads `boost::hash` over 64 bits, its high bits select the shard
+                return static_cast<boost::uint64_t>(boost::hash<ValueType>()(value)) * 0x9E3779B97F4A7C15ull;
+            }
+
+            shard & shard_of(boost::uint64_t hash) BOOST_NOEXCEPT
+            {
+                return shards[static_cast<std::size_t>(hash >> 58) & (shard_count - 1)];
+            }
+
+        private: // representation
+
+            shard shards[shard_count];
+        };
+    } // namespace detail
+
+    class interned_any
+    {
+    public: // structors
+
+        BOOST_CONSTEXPR interned_any() BOOST_NOEXCEPT
+          : entry(0)
+        {
+        }
+
+        // Shares the holder of an equal value if there is one.
+        template<typename ValueType
+            , typename = BOOST_DEDUCED_TYPENAME boost::disable_if<
+                boost::is_same<BOOST_DEDUCED_TYPENAME decay<ValueType>::type, interned_any>
+            >::type>
+        explicit interned_any(ValueType&& value)
+          : entry(detail::intern_table::instance().intern<
+                BOOST_DEDUCED_TYPENAME remove_cv<BOOST_DEDUCED_TYPENAME decay<ValueType>::type>::type
+            >(static_cast<ValueType&&>(value)))
+        {
+        }
+
+        interned_any(const interned_any & other) BOOST_NOEXCEPT
+          : entry(other.entry)
+        {
+            if (entry)
+                entry->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        interned_any(interned_any&& other) BOOST_NOEXCEPT
+          : entry(other.entry)
+        {
+            other.entry = 0;
+        }
+
+        ~interned_any() BOOST_NOEXCEPT
+        {
+            if (entry)
+                detail::intern_table::instance().release(entry);
+        }
+
+    public: // modifiers
+
+        interned_any & swap(interned_any & rhs) BOOST_NOEXCEPT
+        {
+            detail::interned_entry * tmp = entry;
+            entry = rhs.entry;
+            rhs.entry = tmp;
+            return *this;
+        }
+
+        interned_any & operator=(const interned_any& rhs) BOOST_NOEXCEPT
+        {
+            interned_any(rhs).swap(*this);
+            return *this;
+        }
+
+        interned_any & operator=(interned_any&& rhs) BOOST_NOEXCEPT
+        {
+            rhs.swap(*this);
+            interned_any().swap(rhs);
+            return *this;
+        }
+
+        void clear() BOOST_NOEXCEPT
+        {
+            interned_any().swap(*this);
+        }
+
+    public: // queries
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return !entry;
+        }
+
+        const boost::typeindex::type_info& type() const BOOST_NOEXCEPT
+        {
+            return entry ? entry->ops->type() : boost::typeindex::type_id<void>().type_info();
+        }
+
+        // Number of `interned_any` sharing the holder, zero if empty.
+        std::size_t use_count() const BOOST_NOEXCEPT
+        {
+            return entry ? entry->refs.load(std::memory_order_relaxed) : 0;
+        }
+
+        // Deep copy of the value into an owning `boost::any`.
+        boost::any to_any() const
+        {
+            boost::any result;
+            if (entry)
+                entry->ops->to_any(entry->value(), result);
+            return result;
+        }
+
+        // Number of distinct values interned by the process.
+        static std::size_t table_size()
+        {
+            return detail::intern_table::instance().size();
+        }
+
+    private: // representation
+
+        friend bool operator==(const interned_any & lhs, const interned_any & rhs) BOOST_NOEXCEPT
+        {
+            return lhs.entry == rhs.entry;
+        }
+
+        friend std::size_t hash_value(const interned_any & value) BOOST_NOEXCEPT
+        {
+            return value.entry ? static_cast<std::size_t>(value.entry->hash) : 0;
+        }
+
+        template<typename ValueType>
+        friend const ValueType * any_cast(const interned_any *) BOOST_NOEXCEPT;
+
+        detail::interned_entry * entry;
+    };
+
+    inline bool operator!=(const interned_any & lhs, const interned_any & rhs) BOOST_NOEXCEPT
+    {
+        return !(lhs == rhs);
+    }
+
+    inline void swap(interned_any & lhs, interned_any & rhs) BOOST_NOEXCEPT
+    {
+        lhs.swap(rhs);
+    }
+
+    // Interned values are immutable: only `const` access is provided.
+    template<typename ValueType>
+    const ValueType * any_cast(const interned_any * operand) BOOST_NOEXCEPT
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_cv<ValueType>::type value_type;
+
+        return operand && operand->entry
+            && (operand->entry->ops == &detail::value_ops_of<value_type>::value
+                || operand->type() == boost::typeindex::type_id<ValueType>())
+            ? static_cast<const ValueType *>(operand->entry->value())
+            : 0;
+    }
+
+    template<typename ValueType>
+    ValueType any_cast(const interned_any & operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+
+        const nonref * result = anys::any_cast<nonref>(boost::addressof(operand));
+        if(!result)
+            boost::throw_exception(bad_any_cast());
+
+        return static_cast<const nonref &>(*result);
+    }
+} // namespace anys
+
+    using boost::anys::interned_any;
+    using boost::anys::any_cast;
+} // namespace boost
+
+#endif
@@ -0,0 +1,324 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_LAZY_ANY_INCLUDED
+#define BOOST_ANY_LAZY_ANY_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// An `any`-like holder of a nullary factory. `type()` reports the result type
+// of the factory right away, while the value itself is only built by the
+// first `any_cast`, once, even if several threads cast concurrently.
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_DECLTYPE) \
+    || defined(BOOST_NO_CXX11_HDR_ATOMIC) || defined(BOOST_NO_CXX11_HDR_MUTEX)
+#   error boost::anys::lazy_any requires C++11 rvalue references, decltype, <atomic> and <mutex>
+#endif
+
+#include <boost/any.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/add_reference.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/type_traits/declval.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/is_reference.hpp>
+#include <boost/type_traits/is_rvalue_reference.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_void.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace boost
+{
+namespace anys
+{
+    class lazy_any
+    {
+    public: // structors
+
+        BOOST_CONSTEXPR lazy_any() BOOST_NOEXCEPT
+          : content(0)
+        {
+        }
+
+        // Stores `factory`; the held value will be the result of `factory()`.
+        template<typename Factory>
+        explicit lazy_any(Factory&& factory
+            , typename boost::disable_if<boost::is_same<BOOST_DEDUCED_TYPENAME decay<Factory>::type, lazy_any> >::type* = 0)
+          : content(new holder<
+                BOOST_DEDUCED_TYPENAME decay<Factory>::type,
+                BOOST_DEDUCED_TYPENAME decay<decltype(boost::declval<BOOST_DEDUCED_TYPENAME decay<Factory>::type&>()())>::type
+            >(static_cast<Factory&&>(factory)))
+        {
+        }
+
+        // A copy made before the value is built keeps its own copy of the
+        // factory and builds its own value. Copying waits for a value that
+        // another thread is building.
+        lazy_any(const lazy_any & other)
+          : content(other.content ? other.content->clone() : 0)
+        {
+        }
+
+        lazy_any(lazy_any&& other) BOOST_NOEXCEPT
+          : content(other.content)
+        {
+            other.content = 0;
+        }
+
+        ~lazy_any() BOOST_NOEXCEPT
+        {
+            delete content;
+        }
+
+    public: // modifiers
+
+        lazy_any & swap(lazy_any & rhs) BOOST_NOEXCEPT
+        {
+            placeholder* tmp = content;
+            content = rhs.content;
+            rhs.content = tmp;
+            return *this;
+        }
+
+        lazy_any & operator=(const lazy_any& rhs)
+        {
+            lazy_any(rhs).swap(*this);
+            return *this;
+        }
+
+        lazy_any & operator=(lazy_any&& rhs) BOOST_NOEXCEPT
+        {
+            rhs.swap(*this);
+            lazy_any().swap(rhs);
+            return *this;
+        }
+
+        void clear() BOOST_NOEXCEPT
+        {
+            lazy_any().swap(*this);
+        }
+
+    public: // queries
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return !content;
+        }
+
+        // Type of the value, whether it was already built or not.
+        const boost::typeindex::type_info& type() const BOOST_NOEXCEPT
+        {
+            return content ? content->type() : boost::typeindex::type_id<void>().type_info();
+        }
+
+        bool materialized() const BOOST_NOEXCEPT
+        {
+            return content && content->materialized();
+        }
+
+    private: // types
+
+        class BOOST_SYMBOL_VISIBLE placeholder
+        {
+        public: // structors
+
+            virtual ~placeholder()
+            {
+            }
+
+        public: // queries
+
+            virtual const boost::typeindex::type_info& type() const BOOST_NOEXCEPT = 0;
+
+            virtual placeholder * clone() const = 0;
+
+            virtual bool materialized() const BOOST_NOEXCEPT = 0;
+
+            // Builds the value on the first call.
+            virtual void * value() = 0;
+        };
+
+        template<typename Factory, typename ValueType>
+        class holder
+#ifndef BOOST_NO_CXX11_FINAL
+          final
+#endif
+          : public placeholder
+        {
+            BOOST_STATIC_ASSERT_MSG(!boost::is_void<ValueType>::value,
+                "boost::anys::lazy_any requires a factory that returns a value");
+
+        public: // structors
+
+            template<typename F>
+            explicit holder(F&& f)
+              : factory(static_cast<F&&>(f)), ready(false)
+            {
+            }
+
+            ~holder() BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                if (ready.load(std::memory_order_relaxed))
+                    static_cast<ValueType *>(storage.address())->~ValueType();
+            }
+
+        public: // queries
+
+            const boost::typeindex::type_info& type() const BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                return boost::typeindex::type_id<ValueType>().type_info();
+            }
+
+            placeholder * clone() const BOOST_OVERRIDE
+            {
+                if (!ready.load(std::memory_order_acquire))
+                {
+                    // `value()` may be running a stateful factory, copy it
+                    // either before or after that.
+                    std::lock_guard<std::mutex> lock(guard);
+                    if (!ready.load(std::memory_order_relaxed))
+                        return new holder(factory);
+                }
+
+                holder * copy = new holder(factory);
+                BOOST_TRY {
+                    ::new(copy->storage.address()) ValueType(
+                        *static_cast<const ValueType *>(storage.address())
+                    );
+                } BOOST_CATCH(...) {
+                    delete copy;
+                    BOOST_RETHROW
+                }
+                BOOST_CATCH_END
+                copy->ready.store(true, std::memory_order_relaxed);
+                return copy;
+            }
+
+            bool materialized() const BOOST_NOEXCEPT BOOST_OVERRIDE
+            {
+                return ready.load(std::memory_order_acquire);
+            }
+
+            void * value() BOOST_OVERRIDE
+            {
+                if (!ready.load(std::memory_order_acquire))
+                {
+                    // A failed factory leaves the holder unmaterialized, the
+                    // next cast calls it again.
+                    std::lock_guard<std::mutex> lock(guard);
+                    if (!ready.load(std::memory_order_relaxed))
+                    {
+                        ::new(storage.address()) ValueType(factory());
+                        ready.store(true, std::memory_order_release);
+                    }
+                }
+                return storage.address();
+            }
+
+        private: // representation
+
+            Factory factory;
+            std::atomic<bool> ready;
+            mutable std::mutex guard;
+            boost::aligned_storage<
+                sizeof(ValueType), boost::alignment_of<ValueType>::value
+            > storage;
+        };
+
+    private: // representation
+
+        template<typename ValueType>
+        friend ValueType * any_cast(lazy_any *);
+
+        placeholder * content;
+    };
+
+    inline void swap(lazy_any & lhs, lazy_any & rhs) BOOST_NOEXCEPT
+    {
+        lhs.swap(rhs);
+    }
+
+    template<typename Factory>
+    inline lazy_any make_lazy_any(Factory&& factory)
+    {
+        return lazy_any(static_cast<Factory&&>(factory));
+    }
+
+    // Builds the value if it was not built yet, which may throw whatever the
+    // factory throws.
+    template<typename ValueType>
+    ValueType * any_cast(lazy_any * operand)
+    {
+        return operand && operand->type() == boost::typeindex::type_id<ValueType>()
+            ? static_cast<ValueType *>(operand->content->value())
+            : 0;
+    }
+
+    template<typename ValueType>
+    inline const ValueType * any_cast(const lazy_any * operand)
+    {
+        return anys::any_cast<ValueType>(const_cast<lazy_any *>(operand));
+    }
+
+    template<typename ValueType>
+    ValueType any_cast(lazy_any & operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+
+        nonref * result = anys::any_cast<nonref>(boost::addressof(operand));
+        if(!result)
+            boost::throw_exception(bad_any_cast());
+
+        typedef BOOST_DEDUCED_TYPENAME boost::conditional<
+            boost::is_reference<ValueType>::value,
+            ValueType,
+            BOOST_DEDUCED_TYPENAME boost::add_reference<ValueType>::type
+        >::type ref_type;
+
+        return static_cast<ref_type>(*result);
+    }
+
+    template<typename ValueType>
+    inline ValueType any_cast(const lazy_any & operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+        return anys::any_cast<const nonref &>(const_cast<lazy_any &>(operand));
+    }
+
+    template<typename ValueType>
+    inline ValueType any_cast(lazy_any&& operand)
+    {
+        BOOST_STATIC_ASSERT_MSG(
+            boost::is_rvalue_reference<ValueType&&>::value /*true if ValueType is rvalue or just a value*/
+            || boost::is_const< typename boost::remove_reference<ValueType>::type >::value,
+            "boost::any_cast shall not be used for getting nonconst references to temporary objects"
+        );
+        return anys::any_cast<ValueType>(operand);
+    }
+} // namespace anys
+
+    using boost::anys::lazy_any;
+    using boost::anys::make_lazy_any;
+    using boost::anys::any_cast;
+} // namespace boost
+
+#endif
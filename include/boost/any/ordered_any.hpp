@@ -0,0 +1,327 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_ORDERED_ANY_INCLUDED
+#define BOOST_ANY_ORDERED_ANY_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// A `boost::any` with a total order, for sorted containers and binary
+// search over values of mixed types. Values are ordered by the rank of
+// their type first, a hash of the type name that is the same in every run,
+// and by `operator<` of the type then. The comparison function is captured
+// when the value is stored, so comparing two values is at most one
+// indirect call. Empty values come first.
+//
+//   std::set<boost::ordered_any> keys;
+//   std::sort(values.begin(), values.end(), boost::any_less());
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+#   error boost::anys::ordered_any requires C++11 rvalue references
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/detail/type_hash.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_index.hpp>
+#include <boost/type_traits/add_reference.hpp>
+#include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/is_reference.hpp>
+#include <boost/type_traits/is_rvalue_reference.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <cstring>
+
+namespace boost
+{
+namespace anys
+{
+    namespace detail
+    {
+        // One static table per ordered type
+        struct order_ops
+        {
+            // Three-way comparison of two `boost::any` holding the type
+            int (*compare)(const boost::any & lhs, const boost::any & rhs);
+
+            // Tells the types with the same rank apart
+            const char * (*name)();
+        };
+
+        template<typename ValueType>
+        struct order_ops_of
+        {
+            static int compare(const boost::any & lhs, const boost::any & rhs)
+            {
+                const ValueType & l = *boost::unsafe_any_cast<ValueType>(boost::addressof(lhs));
+                const ValueType & r = *boost::unsafe_any_cast<ValueType>(boost::addressof(rhs));
+                return l < r ? -1 : (r < l ? 1 : 0);
+            }
+
+            static const char * name()
+            {
+                return ctti_name<ValueType>::n();
+            }
+
+            static const order_ops value;
+        };
+
+        template<typename ValueType>
+        const order_ops order_ops_of<ValueType>::value = {
+            &order_ops_of<ValueType>::compare,
+            &order_ops_of<ValueType>::name
+        };
+    } // namespace detail
+
+    class ordered_any
+    {
+    public: // structors
+
+        BOOST_CONSTEXPR ordered_any() BOOST_NOEXCEPT
+          : order(0)
+          , rank(0)
+        {
+        }
+
+        template<typename ValueType>
+        ordered_any(const ValueType & value)
+          : content(value)
+          , order(&detail::order_ops_of<BOOST_DEDUCED_TYPENAME decay<ValueType>::type>::value)
+          , rank(detail::type_hash<BOOST_DEDUCED_TYPENAME decay<ValueType>::type>::get())
+        {
+        }
+
+        template<typename ValueType>
+        ordered_any(ValueType&& value
+            , typename boost::disable_if<boost::is_same<ordered_any&, ValueType> >::type* = 0
+            , typename boost::disable_if<boost::is_const<ValueType> >::type* = 0)
+          : content(static_cast<ValueType&&>(value))
+          , order(&detail::order_ops_of<BOOST_DEDUCED_TYPENAME decay<ValueType>::type>::value)
+          , rank(detail::type_hash<BOOST_DEDUCED_TYPENAME decay<ValueType>::type>::get())
+        {
+        }
+
+        ordered_any(const ordered_any & other)
+          : content(other.content)
+          , order(other.order)
+          , rank(other.rank)
+        {
+        }
+
+        ordered_any(ordered_any&& other) BOOST_NOEXCEPT
+          : content(static_cast<boost::any&&>(other.content))
+          , order(other.order)
+          , rank(other.rank)
+        {
+            other.order = 0;
+            other.rank = 0;
+        }
+
+    public: // modifiers
+
+        ordered_any & swap(ordered_any & rhs) BOOST_NOEXCEPT
+        {
+            content.swap(rhs.content);
+
+            const detail::order_ops * const tmp_order = order;
+            order = rhs.order;
+            rhs.order = tmp_order;
+
+            const boost::uint64_t tmp_rank = rank;
+            rank = rhs.rank;
+            rhs.rank = tmp_rank;
+            return *this;
+        }
+
+        ordered_any & operator=(const ordered_any & rhs)
+        {
+            ordered_any(rhs).swap(*this);
+            return *this;
+        }
+
+        ordered_any & operator=(ordered_any&& rhs) BOOST_NOEXCEPT
+        {
+            rhs.swap(*this);
+            ordered_any().swap(rhs);
+            return *this;
+        }
+
+        template <class ValueType>
+        ordered_any & operator=(ValueType&& rhs)
+        {
+            ordered_any(static_cast<ValueType&&>(rhs)).swap(*this);
+            return *this;
+        }
+
+        void clear() BOOST_NOEXCEPT
+        {
+            ordered_any().swap(*this);
+        }
+
+    public: // queries
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return content.empty();
+        }
+
+        const boost::typeindex::type_info& type() const BOOST_NOEXCEPT
+        {
+            return content.type();
+        }
+
+        // The held value, without its order
+        const boost::any & get() const BOOST_NOEXCEPT
+        {
+            return content;
+        }
+
+        // Negative, zero or positive if `*this` is ordered before, with or
+        // after `other`.
+        int compare(const ordered_any & other) const
+        {
+            if (rank != other.rank)
+                return rank < other.rank ? -1 : 1;
+            if (order == other.order)
+                return order ? order->compare(content, other.content) : 0;
+            if (!order || !other.order)
+                return order ? 1 : -1;
+
+            // A hash collision, or the same type in another shared library
+            const int names = std::strcmp(order->name(), other.order->name());
+            return names ? (names < 0 ? -1 : 1) : order->compare(content, other.content);
+        }
+
+    private: // representation
+
+        template<typename ValueType>
+        friend ValueType * any_cast(ordered_any *) BOOST_NOEXCEPT;
+
+        boost::any content;
+        const detail::order_ops * order; // null if empty
+        boost::uint64_t rank;
+    };
+
+    inline void swap(ordered_any & lhs, ordered_any & rhs) BOOST_NOEXCEPT
+    {
+        lhs.swap(rhs);
+    }
+
+    // Three-way comparison: negative, zero or positive
+    inline int any_compare(const ordered_any & lhs, const ordered_any & rhs)
+    {
+        return lhs.compare(rhs);
+    }
+
+    struct any_less
+    {
+        typedef ordered_any first_argument_type;
+        typedef ordered_any second_argument_type;
+        typedef bool result_type;
+
+        bool operator()(const ordered_any & lhs, const ordered_any & rhs) const
+        {
+            return lhs.compare(rhs) < 0;
+        }
+    };
+
+    inline bool operator==(const ordered_any & lhs, const ordered_any & rhs)
+    {
+        return lhs.compare(rhs) == 0;
+    }
+
+    inline bool operator!=(const ordered_any & lhs, const ordered_any & rhs)
+    {
+        return lhs.compare(rhs) != 0;
+    }
+
+    inline bool operator<(const ordered_any & lhs, const ordered_any & rhs)
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    inline bool operator>(const ordered_any & lhs, const ordered_any & rhs)
+    {
+        return lhs.compare(rhs) > 0;
+    }
+
+    inline bool operator<=(const ordered_any & lhs, const ordered_any & rhs)
+    {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    inline bool operator>=(const ordered_any & lhs, const ordered_any & rhs)
+    {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<typename ValueType>
+    ValueType * any_cast(ordered_any * operand) BOOST_NOEXCEPT
+    {
+        return operand ? boost::any_cast<ValueType>(boost::addressof(operand->content)) : 0;
+    }
+
+    template<typename ValueType>
+    inline const ValueType * any_cast(const ordered_any * operand) BOOST_NOEXCEPT
+    {
+        return anys::any_cast<ValueType>(const_cast<ordered_any *>(operand));
+    }
+
+    template<typename ValueType>
+    ValueType any_cast(ordered_any & operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+
+        nonref * result = anys::any_cast<nonref>(boost::addressof(operand));
+        if(!result)
+            boost::throw_exception(bad_any_cast());
+
+        typedef BOOST_DEDUCED_TYPENAME boost::conditional<
+            boost::is_reference<ValueType>::value,
+            ValueType,
+            BOOST_DEDUCED_TYPENAME boost::add_reference<ValueType>::type
+        >::type ref_type;
+
+        return static_cast<ref_type>(*result);
+    }
+
+    template<typename ValueType>
+    inline ValueType any_cast(const ordered_any & operand)
+    {
+        typedef BOOST_DEDUCED_TYPENAME remove_reference<ValueType>::type nonref;
+        return anys::any_cast<const nonref &>(const_cast<ordered_any &>(operand));
+    }
+
+    template<typename ValueType>
+    inline ValueType any_cast(ordered_any&& operand)
+    {
+        BOOST_STATIC_ASSERT_MSG(
+            boost::is_rvalue_reference<ValueType&&>::value /*true if ValueType is rvalue or just a value*/
+            || boost::is_const< typename boost::remove_reference<ValueType>::type >::value,
+            "boost::any_cast shall not be used for getting nonconst references to temporary objects"
+        );
+        return anys::any_cast<ValueType>(operand);
+    }
+} // namespace anys
+
+    using boost::anys::ordered_any;
+    using boost::anys::any_compare;
+    using boost::anys::any_less;
+    using boost::anys::any_cast;
+} // namespace boost
+
+#endif
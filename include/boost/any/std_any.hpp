@@ -0,0 +1,125 @@
+// Copyright Antony Polukhin, 2013-2021.
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_ANY_STD_ANY_INCLUDED
+#define BOOST_ANY_STD_ANY_INCLUDED
+
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+// Moving held values between `boost::any` and `std::any`. The value is
+// move-constructed into the other container, so large strings and vectors
+// keep their buffers; only a `boost::any::static_storage` value is copied. Both directions are given the
+// list of types that may be held: neither container offers a type-erased
+// move into the other, and `boost/any.hpp` does not include `<any>`, whose
+// `std::any_cast` would be found by argument dependent lookup for
+// `any_cast` calls on standard types.
+
+#include <boost/config.hpp>
+
+// Boost.Config versions without `BOOST_NO_CXX17_HDR_ANY` are told by
+// `<variant>`, which came with it.
+#if defined(BOOST_NO_CXX17_HDR_ANY) || defined(BOOST_NO_CXX17_HDR_VARIANT) \
+    || defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+#   error boost::anys::to_std_any requires C++17 <any>
+#endif
+
+#include <boost/any.hpp>
+#include <boost/any/detail/any_access.hpp>
+#include <boost/throw_exception.hpp>
+#include <any>
+
+namespace boost
+{
+namespace anys
+{
+    namespace detail
+    {
+        template<typename... ValueTypes>
+        struct std_any_mover
+        {
+            static bool to_std(boost::any &, std::any &, bool) BOOST_NOEXCEPT
+            {
+                return false;
+            }
+
+            static bool from_std(std::any &, boost::any &) BOOST_NOEXCEPT
+            {
+                return false;
+            }
+        };
+
+        template<typename ValueType, typename... ValueTypes>
+        struct std_any_mover<ValueType, ValueTypes...>
+        {
+            // The value of a static storage is copied, other `any`s share it
+            static bool to_std(boost::any & from, std::any & to, bool is_static)
+            {
+                if (ValueType * const value = boost::any_cast<ValueType>(&from))
+                {
+                    if (is_static)
+                        to.emplace<ValueType>(*value);
+                    else
+                        to.emplace<ValueType>(static_cast<ValueType&&>(*value));
+                    return true;
+                }
+                return std_any_mover<ValueTypes...>::to_std(from, to, is_static);
+            }
+
+            static bool from_std(std::any & from, boost::any & to)
+            {
+                if (ValueType * const value = std::any_cast<ValueType>(&from))
+                {
+                    to = static_cast<ValueType&&>(*value);
+                    return true;
+                }
+                return std_any_mover<ValueTypes...>::from_std(from, to);
+            }
+        };
+    } // namespace detail
+
+    // Moves the value held by `operand` into a `std::any` and leaves
+    // `operand` empty. The held type is looked up in `ValueTypes`, in order;
+    // if it is none of them `bad_any_cast` is thrown and `operand` is left
+    // unchanged. The value of a `boost::any::static_storage` that `operand`
+    // refers to is copied, since other `any`s refer to it too.
+    template<typename... ValueTypes>
+    std::any to_std_any(boost::any&& operand)
+    {
+        std::any result;
+        if (operand.empty())
+            return result;
+
+        if (!detail::std_any_mover<ValueTypes...>::to_std(operand, result, detail::any_access::is_static(operand)))
+            boost::throw_exception(bad_any_cast());
+
+        operand.clear();
+        return result;
+    }
+
+    // Moves the value held by `operand` into a `boost::any` and leaves
+    // `operand` empty, like `to_std_any`.
+    template<typename... ValueTypes>
+    boost::any from_std_any(std::any&& operand)
+    {
+        boost::any result;
+        if (!operand.has_value())
+            return result;
+
+        if (!detail::std_any_mover<ValueTypes...>::from_std(operand, result))
+            boost::throw_exception(bad_any_cast());
+
+        operand.reset();
+        return result;
+    }
+} // namespace anys
+
+    using boost::anys::to_std_any;
+    using boost::anys::from_std_any;
+} // namespace boost
+
+#endif
@@ -0,0 +1,228 @@
+//  Unit test for boost::anys::adaptive_any_dispatcher.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_HDR_ATOMIC) || defined(BOOST_NO_CXX11_HDR_MUTEX) \
+    || defined(BOOST_NO_CXX11_HDR_FUNCTIONAL) || defined(BOOST_NO_CXX11_THREAD_LOCAL) \
+    || defined(BOOST_NO_CXX11_LAMBDAS) || defined(BOOST_NO_CXX11_HDR_THREAD)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/adaptive_any_dispatcher.hpp>
+#include <atomic>
+#include <thread>
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_dispatch();
+    void test_empty_and_unknown();
+    void test_replaced_handler();
+    void test_sample_period();
+    void test_reorder_by_hits();
+    void test_shifting_workload();
+    void test_concurrent_dispatch();
+
+    const test_case test_cases[] =
+    {
+        { "dispatch to the handler of the type",  test_dispatch            },
+        { "empty any and unknown types",          test_empty_and_unknown   },
+        { "handler added again",                  test_replaced_handler    },
+        { "sample period",                        test_sample_period       },
+        { "probe order follows the hits",         test_reorder_by_hits     },
+        { "shifting workload",                    test_shifting_workload   },
+        { "concurrent dispatch",                  test_concurrent_dispatch }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    // Adds int, long, double and std::string, in this order
+    void add_counters(boost::adaptive_any_dispatcher & dispatcher, std::atomic<int> * counts)
+    {
+        dispatcher.add<int>([counts](int &) { ++counts[0]; });
+        dispatcher.add<long>([counts](long &) { ++counts[1]; });
+        dispatcher.add<double>([counts](double &) { ++counts[2]; });
+        dispatcher.add<std::string>([counts](std::string &) { ++counts[3]; });
+    }
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_dispatch()
+    {
+        adaptive_any_dispatcher dispatcher;
+        int sum = 0;
+        std::string text;
+
+        check_equal(dispatcher.add<int>([&sum](int & value) { sum += value; ++value; }), 0u, "index of int");
+        check_equal(dispatcher.add<std::string>([&text](std::string & value) { text += value; }), 1u, "index of std::string");
+        check_equal(dispatcher.size(), 2u, "size");
+
+        any i = 2, s = std::string("text");
+        check_true(dispatcher.dispatch(i), "int dispatched");
+        check_true(dispatcher.dispatch(s), "std::string dispatched");
+        check_true(dispatcher.dispatch(i), "int dispatched again");
+
+        check_equal(sum, 5, "int handler");
+        check_equal(any_cast<int>(i), 4, "modification through the handler");
+        check_equal(text, "text", "std::string handler");
+        check_equal(dispatcher.index_of(s), 1u, "index_of");
+    }
+
+    void test_empty_and_unknown()
+    {
+        adaptive_any_dispatcher dispatcher;
+        int calls = 0;
+        dispatcher.add<int>([&calls](int &) { ++calls; });
+
+        any empty, unknown = 1.0;
+        check_false(dispatcher.dispatch(empty), "empty any");
+        check_false(dispatcher.dispatch(unknown), "unknown type");
+        check_equal(dispatcher.index_of(unknown), any_npos, "index_of unknown type");
+        check_equal(calls, 0, "no calls");
+
+        const adaptive_any_dispatcher none;
+        check_equal(none.index_of(unknown), any_npos, "no candidates");
+    }
+
+    void test_replaced_handler()
+    {
+        adaptive_any_dispatcher dispatcher;
+        int first = 0, second = 0;
+        dispatcher.add<int>([&first](int &) { ++first; });
+        check_equal(dispatcher.add<const int>([&second](int &) { ++second; }), 0u, "same index");
+        check_equal(dispatcher.size(), 1u, "size");
+
+        any value = 1;
+        dispatcher.dispatch(value);
+        check_equal(first, 0, "old handler");
+        check_equal(second, 1, "new handler");
+    }
+
+    void test_sample_period()
+    {
+        adaptive_any_dispatcher dispatcher(5, 1000000);
+        check_equal(dispatcher.sample_period(), 8u, "rounded up to a power of two");
+        check_equal(dispatcher.reorder_samples(), 1000000u, "reorder_samples");
+
+        dispatcher.add<int>([](int &) {});
+        any value = 1;
+        for (int i = 0; i < 800; ++i)
+            dispatcher.dispatch(value);
+        check_equal(dispatcher.hits(0), 100u, "every 8th dispatch is sampled");
+    }
+
+    void test_reorder_by_hits()
+    {
+        adaptive_any_dispatcher dispatcher(1, 1000000);
+        std::atomic<int> counts[4] = {};
+        add_counters(dispatcher, counts);
+
+        any d = 1.0, s = std::string("text");
+        for (int i = 0; i < 10; ++i)
+            dispatcher.dispatch(d);
+        for (int i = 0; i < 5; ++i)
+            dispatcher.dispatch(s);
+
+        std::vector<std::size_t> order = dispatcher.probe_order();
+        check_equal(order[0], 0u, "registration order before reordering");
+        check_equal(order[3], 3u, "std::string last before reordering");
+
+        dispatcher.reorder();
+        order = dispatcher.probe_order();
+        check_equal(order[0], 2u, "double first");
+        check_equal(order[1], 3u, "std::string second");
+        check_equal(order[2], 0u, "ties keep their order");
+        check_equal(dispatcher.hits(2), 5u, "hits are halved");
+        check_equal(counts[2].load(), 10, "double handler");
+    }
+
+    void test_shifting_workload()
+    {
+        adaptive_any_dispatcher dispatcher(1, 64);
+        std::atomic<int> counts[4] = {};
+        add_counters(dispatcher, counts);
+
+        any s = std::string("text"), l = 1L;
+        for (int i = 0; i < 1000; ++i)
+            dispatcher.dispatch(s);
+        const std::size_t first_phase = dispatcher.probe_order()[0];
+
+        for (int i = 0; i < 1000; ++i)
+            dispatcher.dispatch(l);
+        const std::size_t second_phase = dispatcher.probe_order()[0];
+
+        check_equal(first_phase, 3u, "std::string promoted");
+        check_equal(second_phase, 1u, "long promoted after the shift");
+        check_equal(counts[3].load(), 1000, "std::string handler");
+        check_equal(counts[1].load(), 1000, "long handler");
+    }
+
+    void test_concurrent_dispatch()
+    {
+        adaptive_any_dispatcher dispatcher(1, 16);
+        std::atomic<int> counts[4] = {};
+        add_counters(dispatcher, counts);
+
+        const int rounds = 20000;
+        std::atomic<int> missed(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.push_back(std::thread([&dispatcher, &missed, t, rounds]() {
+                any values[] = { 1, 2L, 3.0, std::string("text") };
+                for (int i = 0; i < rounds; ++i)
+                {
+                    // Each thread shifts from its own type to the next one
+                    any & value = values[(t + (i < rounds / 2 ? 0 : 1)) % 4];
+                    if (!dispatcher.dispatch(value))
+                        ++missed;
+                }
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+
+        check_equal(missed.load(), 0, "no missed dispatches");
+        for (int i = 0; i < 4; ++i)
+            check_equal(counts[i].load(), rounds, "dispatches of each type");
+    }
+}
+
+#endif
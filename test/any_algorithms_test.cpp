@@ -0,0 +1,200 @@
+//  Unit test for the bulk algorithms over ranges of boost::any.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_HDR_THREAD) || defined(BOOST_NO_CXX11_HDR_EXCEPTION) \
+    || defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_LAMBDAS) \
+    || defined(BOOST_NO_CXX11_DECLTYPE) || defined(BOOST_NO_CXX11_HDR_TYPE_TRAITS)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/any_algorithms.hpp>
+#include <iterator>
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_empty_range();
+    void test_count_by_type();
+    void test_extract();
+    void test_transform_if();
+    void test_partition_by_type();
+    void test_exception_from_transform();
+
+    const test_case test_cases[] =
+    {
+        { "empty range",                          test_empty_range               },
+        { "count_by_type",                        test_count_by_type             },
+        { "extract",                              test_extract                   },
+        { "transform_if",                         test_transform_if              },
+        { "partition_by_type",                    test_partition_by_type         },
+        { "exception from a transform",           test_exception_from_transform  }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    // Every third element is a double, every fifth a string, one in seven
+    // is empty, the rest are ints. Large enough to be split between threads.
+    std::vector<boost::any> make_values()
+    {
+        std::vector<boost::any> values(3 * boost::anys::any_algorithms_serial_limit + 17);
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            if (i % 7 == 0)
+                continue;
+            else if (i % 3 == 0)
+                values[i] = static_cast<double>(i);
+            else if (i % 5 == 0)
+                values[i] = std::string(1, 'a');
+            else
+                values[i] = static_cast<int>(i);
+        }
+        return values;
+    }
+
+    std::size_t expected_count(std::size_t size, int kind)
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const int k = i % 7 == 0 ? 0 : i % 3 == 0 ? 1 : i % 5 == 0 ? 2 : 3;
+            count += k == kind;
+        }
+        return count;
+    }
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_empty_range()
+    {
+        std::vector<any> values;
+        check_true(anys::count_by_type(values.begin(), values.end()).empty(), "count_by_type");
+
+        std::vector<int> ints;
+        anys::extract<int>(values.begin(), values.end(), std::back_inserter(ints));
+        check_true(ints.empty(), "extract");
+        check_true(anys::partition_by_type<int>(values.begin(), values.end()) == values.end(), "partition_by_type");
+    }
+
+    void test_count_by_type()
+    {
+        const std::vector<any> values = make_values();
+        const std::size_t threads[] = { 1, 4, 0 };
+        for (std::size_t t = 0; t < 3; ++t)
+        {
+            std::map<typeindex::type_index, std::size_t> counts = anys::count_by_type(values.begin(), values.end(), threads[t]);
+            check_equal(counts.size(), 4u, "number of types");
+            check_equal(counts[typeindex::type_id<void>()], expected_count(values.size(), 0), "empty elements");
+            check_equal(counts[typeindex::type_id<double>()], expected_count(values.size(), 1), "doubles");
+            check_equal(counts[typeindex::type_id<std::string>()], expected_count(values.size(), 2), "strings");
+            check_equal(counts[typeindex::type_id<int>()], expected_count(values.size(), 3), "ints");
+        }
+    }
+
+    void test_extract()
+    {
+        const std::vector<any> values = make_values();
+
+        std::vector<double> serial;
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            if (const double * d = any_cast<double>(&values[i]))
+                serial.push_back(*d);
+        }
+
+        std::vector<double> parallel;
+        anys::extract<double>(values.begin(), values.end(), std::back_inserter(parallel), 4);
+        check_true(parallel == serial, "same values in the same order");
+
+        std::vector<double> one_thread;
+        anys::extract<double>(values.begin(), values.end(), std::back_inserter(one_thread), 1);
+        check_true(one_thread == serial, "same values with one thread");
+    }
+
+    void test_transform_if()
+    {
+        const std::vector<any> values = make_values();
+
+        std::vector<long> lengths;
+        anys::transform_if<std::string>(values.begin(), values.end(), std::back_inserter(lengths),
+            [](const std::string & s) { return static_cast<long>(s.size()); }, 3);
+        check_equal(lengths.size(), expected_count(values.size(), 2), "one result per string");
+
+        std::vector<int> halves;
+        anys::transform_if<int>(values.begin(), values.end(), std::back_inserter(halves),
+            [](int i) { return i / 2; });
+        bool in_order = true;
+        for (std::size_t i = 1; i < halves.size(); ++i)
+            in_order = in_order && halves[i - 1] <= halves[i];
+        check_true(in_order, "results are in the order of the range");
+    }
+
+    void test_partition_by_type()
+    {
+        std::vector<any> values = make_values();
+        const std::size_t doubles = expected_count(values.size(), 1);
+
+        const std::vector<any>::iterator middle = anys::partition_by_type<double>(values.begin(), values.end(), 4);
+        check_equal(static_cast<std::size_t>(middle - values.begin()), doubles, "size of the first group");
+
+        bool partitioned = true;
+        for (std::size_t i = 0; i < values.size(); ++i)
+            partitioned = partitioned && (any_cast<double>(&values[i]) != 0) == (i < doubles);
+        check_true(partitioned, "doubles come first");
+
+        std::map<typeindex::type_index, std::size_t> counts = anys::count_by_type(values.begin(), values.end());
+        check_equal(counts[typeindex::type_id<int>()], expected_count(values.size(), 3), "no element is lost");
+    }
+
+    void test_exception_from_transform()
+    {
+        const std::vector<any> values = make_values();
+        std::vector<int> out;
+        TEST_CHECK_THROW(
+            anys::transform_if<int>(values.begin(), values.end(), std::back_inserter(out),
+                [](int i) -> int { if (i > 1000) throw std::runtime_error("fails"); return i; }, 4),
+            std::runtime_error,
+            "exception from a worker thread");
+        check_true(out.empty(), "nothing is written");
+    }
+}
+
+#endif
@@ -0,0 +1,315 @@
+//  Unit test for boost::anys::any_base_cast.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) || defined(BOOST_NO_CXX11_VARIADIC_MACROS) \
+    || defined(BOOST_NO_CXX11_HDR_ATOMIC) || defined(BOOST_NO_CXX11_HDR_MUTEX) \
+    || defined(BOOST_NO_CXX11_HDR_THREAD) || defined(BOOST_NO_CXX11_LAMBDAS)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/any_base_cast.hpp>
+#include <thread>
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_held_type();
+    void test_direct_bases();
+    void test_indirect_bases();
+    void test_virtual_bases();
+    void test_unrelated_types();
+    void test_references();
+    void test_late_registration();
+    void test_concurrent_casts();
+    void test_many_types();
+
+    const test_case test_cases[] =
+    {
+        { "held type itself",                     test_held_type         },
+        { "direct bases",                         test_direct_bases      },
+        { "bases of bases",                       test_indirect_bases    },
+        { "virtual bases",                        test_virtual_bases     },
+        { "unrelated types",                      test_unrelated_types   },
+        { "casts to references",                  test_references        },
+        { "registration after a failed cast",     test_late_registration },
+        { "concurrent casts",                     test_concurrent_casts  },
+        { "more held types than cache slots",     test_many_types        }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    struct shape
+    {
+        virtual ~shape() {}
+        virtual int sides() const { return 0; }
+        int id;
+    };
+
+    struct named
+    {
+        std::string name;
+    };
+
+    struct square : shape, named
+    {
+        int sides() const { return 4; }
+        double side;
+    };
+
+    struct colored_square : square
+    {
+        int color;
+    };
+
+    struct node
+    {
+        int value;
+    };
+
+    struct left : virtual node
+    {
+        int l;
+    };
+
+    struct right : virtual node
+    {
+        int r;
+    };
+
+    struct diamond : left, right
+    {
+        int d;
+    };
+
+    struct late : named
+    {
+        int x;
+    };
+
+    template<int N>
+    struct numbered : shape
+    {
+    };
+
+    // `numbered<1>` to `numbered<N>`, the even ones registered as shapes
+    template<int N>
+    struct numbered_values
+    {
+        static void add(std::vector<boost::any> & values)
+        {
+            numbered_values<N - 1>::add(values);
+            if (N % 2 == 0)
+            {
+                const boost::anys::detail::base_registrar<numbered<N>, shape> registration;
+                (void)registration;
+            }
+            values.push_back(numbered<N>());
+        }
+    };
+
+    template<>
+    struct numbered_values<0>
+    {
+        static void add(std::vector<boost::any> &)
+        {
+        }
+    };
+}
+
+BOOST_ANY_REGISTER_BASES(any_tests::square, any_tests::shape, any_tests::named)
+BOOST_ANY_REGISTER_BASES(any_tests::colored_square, any_tests::square)
+BOOST_ANY_REGISTER_BASES(any_tests::left, any_tests::node)
+BOOST_ANY_REGISTER_BASES(any_tests::right, any_tests::node)
+BOOST_ANY_REGISTER_BASES(any_tests::diamond, any_tests::left, any_tests::right)
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_held_type()
+    {
+        any value = square();
+
+        check_equal(any_base_cast<square>(&value), any_cast<square>(&value), "square");
+        check_null(any_base_cast<square>(static_cast<any *>(0)), "null any");
+
+        any empty;
+        check_null(any_base_cast<shape>(&empty), "empty any");
+    }
+
+    void test_direct_bases()
+    {
+        any value = square();
+        square * const held = any_cast<square>(&value);
+        held->name = "square";
+
+        shape * const as_shape = any_base_cast<shape>(&value);
+        named * const as_named = any_base_cast<named>(&value);
+
+        check_equal(as_shape, static_cast<shape *>(held), "shape");
+        check_equal(as_named, static_cast<named *>(held), "named is adjusted");
+        check_unequal(static_cast<void *>(as_named), static_cast<void *>(held), "address of the second base");
+        check_equal(as_shape->sides(), 4, "virtual call through the base");
+        check_equal(as_named->name, "square", "member of the second base");
+        check_equal(any_base_cast<named>(&value), as_named, "cached path");
+    }
+
+    void test_indirect_bases()
+    {
+        any value = colored_square();
+        colored_square * const held = any_cast<colored_square>(&value);
+
+        check_equal(any_base_cast<square>(&value), static_cast<square *>(held), "square");
+        check_equal(any_base_cast<shape>(&value), static_cast<shape *>(held), "shape");
+        check_equal(any_base_cast<named>(&value), static_cast<named *>(held), "named");
+        check_null(any_base_cast<colored_square>(static_cast<any *>(0)), "null any");
+
+        const any square_value = square();
+        check_null(any_base_cast<colored_square>(&square_value), "no downcasts");
+    }
+
+    void test_virtual_bases()
+    {
+        any value = diamond();
+        diamond * const held = any_cast<diamond>(&value);
+        held->value = 7;
+
+        check_equal(any_base_cast<node>(&value), static_cast<node *>(held), "virtual base");
+        check_equal(any_base_cast<node>(&value)->value, 7, "member of the virtual base");
+        check_equal(any_base_cast<right>(&value), static_cast<right *>(held), "second base");
+    }
+
+    void test_unrelated_types()
+    {
+        any i = 1, s = std::string("text"), sq = square();
+
+        check_null(any_base_cast<shape>(&i), "int");
+        check_null(any_base_cast<shape>(&s), "std::string");
+        check_null(any_base_cast<node>(&sq), "unrelated base");
+        check_null(any_base_cast<shape>(&i), "cached miss");
+    }
+
+    void test_references()
+    {
+        any value = square();
+        any_cast<square&>(value).id = 3;
+
+        check_equal(any_base_cast<shape>(value).id, 3, "reference");
+
+        const any constant = value;
+        const shape & base = any_base_cast<shape>(constant);
+        check_equal(base.id, 3, "const reference");
+        check_equal(any_base_cast<const named>(&constant), static_cast<const named *>(any_cast<square>(&constant)), "const pointer");
+
+        TEST_CHECK_THROW(
+            any_base_cast<node>(value),
+            bad_any_cast,
+            "any_base_cast to an unrelated type");
+    }
+
+    void test_late_registration()
+    {
+        any value = late();
+        check_null(any_base_cast<named>(&value), "before registration");
+
+        const anys::detail::base_registrar<late, named> registration;
+        (void)registration;
+        check_equal(any_base_cast<named>(&value), static_cast<named *>(any_cast<late>(&value)), "after registration");
+    }
+
+    void test_concurrent_casts()
+    {
+        std::vector<std::thread> threads;
+        std::vector<int> wrong(4, 0);
+        for (std::size_t t = 0; t < wrong.size(); ++t)
+        {
+            threads.push_back(std::thread([&wrong, t]() {
+                any values[] = { square(), colored_square(), diamond(), 1 };
+                for (int i = 0; i < 10000; ++i)
+                {
+                    // Only the square types are named, only diamond is a node
+                    const std::size_t kind = (i + t) % 4;
+                    const bool is_named = any_base_cast<named>(&values[kind]) != 0;
+                    const bool is_node = any_base_cast<node>(&values[kind]) != 0;
+                    if (is_named != (kind < 2) || is_node != (kind == 2))
+                        ++wrong[t];
+                }
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+
+        for (std::size_t i = 0; i < wrong.size(); ++i)
+            check_equal(wrong[i], 0, "casts on each thread");
+    }
+
+    void test_many_types()
+    {
+        // Several times the initial capacity of the cache, which grows
+        // while the threads cast
+        std::vector<any> values;
+        numbered_values<200>::add(values);
+
+        std::vector<std::thread> threads;
+        std::vector<int> wrong(4, 0);
+        for (std::size_t t = 0; t < wrong.size(); ++t)
+        {
+            threads.push_back(std::thread([&values, &wrong, t]() {
+                for (int pass = 0; pass < 3; ++pass)
+                {
+                    for (std::size_t i = 0; i < values.size(); ++i)
+                    {
+                        const std::size_t k = (i + t * 50) % values.size();
+                        shape * const base = any_base_cast<shape>(&values[k]);
+                        if ((base != 0) != (k % 2 == 1))
+                            ++wrong[t];
+                    }
+                }
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+
+        for (std::size_t i = 0; i < wrong.size(); ++i)
+            check_equal(wrong[i], 0, "casts on each thread");
+        check_equal(any_base_cast<shape>(&values[199]), static_cast<shape *>(any_cast<numbered<200> >(&values[199])),
+            "path of the last type");
+    }
+}
+
+#endif
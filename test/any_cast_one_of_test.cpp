@@ -0,0 +1,163 @@
+//  Unit test for boost::anys::any_index_of and boost::anys::any_cast_one_of.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) || defined(BOOST_NO_CXX11_EXPLICIT_CONVERSION_OPERATORS)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/any_cast_one_of.hpp>
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_short_list();
+    void test_long_list();
+    void test_duplicates();
+    void test_empty();
+    void test_cast_one_of();
+    void test_cast_one_of_const();
+
+    const test_case test_cases[] =
+    {
+        { "index in a short candidate list",    test_short_list        },
+        { "index in a long candidate list",     test_long_list         },
+        { "duplicate candidates",               test_duplicates        },
+        { "empty any and null pointers",        test_empty             },
+        { "any_cast_one_of on any*",            test_cast_one_of       },
+        { "any_cast_one_of on const any*",      test_cast_one_of_const }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    template<int N>
+    struct tag
+    {
+        int value;
+    };
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_short_list()
+    {
+        const any i = 1, l = 2L, d = 3.0, s = std::string("text");
+
+        check_equal(any_index_of<int, long, double>(i), 0u, "int");
+        check_equal(any_index_of<int, long, double>(l), 1u, "long");
+        check_equal(any_index_of<int, long, double>(d), 2u, "double");
+        check_equal(any_index_of<int, long, double>(s), any_npos, "std::string is not a candidate");
+        check_equal(any_index_of<const int, volatile long>(l), 1u, "cv-qualifiers are ignored");
+    }
+
+    void test_long_list()
+    {
+        const any values[] = {
+            tag<0>(), tag<5>(), tag<11>(), 1.0f, std::string("text"), 'c'
+        };
+
+        typedef std::size_t (*index_of)(const any &);
+        const index_of find = &any_index_of<
+            tag<0>, tag<1>, tag<2>, tag<3>, tag<4>, tag<5>,
+            tag<6>, tag<7>, tag<8>, tag<9>, tag<10>, tag<11>, std::string
+        >;
+
+        check_equal(find(values[0]), 0u, "tag<0>");
+        check_equal(find(values[1]), 5u, "tag<5>");
+        check_equal(find(values[2]), 11u, "tag<11>");
+        check_equal(find(values[3]), any_npos, "float is not a candidate");
+        check_equal(find(values[4]), 12u, "std::string");
+        check_equal(find(values[5]), any_npos, "char is not a candidate");
+    }
+
+    void test_duplicates()
+    {
+        const any l = 2L;
+        check_equal((any_index_of<int, long, long>(l)), 1u, "first duplicate wins in a short list");
+        check_equal((any_index_of<
+                tag<0>, tag<1>, tag<2>, tag<3>, tag<4>, tag<5>,
+                tag<6>, tag<7>, long, tag<9>, long, long
+            >(l)), 8u, "first duplicate wins in a long list");
+    }
+
+    void test_empty()
+    {
+        const any empty;
+        check_equal(any_index_of<int, long>(empty), any_npos, "short list");
+        check_equal((any_index_of<
+                tag<0>, tag<1>, tag<2>, tag<3>, tag<4>, tag<5>,
+                tag<6>, tag<7>, tag<8>, tag<9>, void
+            >(empty)), any_npos, "long list with void");
+
+        any * null = 0;
+        check_false(!!any_cast_one_of<int, long>(null), "null pointer");
+        check_equal(any_cast_one_of<int, long>(null).index(), any_npos, "index of null pointer");
+    }
+
+    void test_cast_one_of()
+    {
+        any value = std::vector<int>(3, 7);
+
+        any_one_of_ptr<int, std::vector<int>, double> result =
+            any_cast_one_of<int, std::vector<int>, double>(&value);
+
+        check_true(!!result, "matched");
+        check_equal(result.index(), 1u, "index");
+        check_null(result.get<0>(), "pointer for a candidate that did not match");
+        check_equal(result.get<1>(), any_cast<std::vector<int> >(&value), "pointer to the held value");
+
+        result.get<1>()->push_back(8);
+        check_equal(any_cast<std::vector<int>&>(value).size(), 4u, "modification through the pointer");
+
+        value = 'c';
+        check_false(!!any_cast_one_of<int, std::vector<int>, double>(&value), "no match");
+    }
+
+    void test_cast_one_of_const()
+    {
+        const any value = 42;
+
+        any_one_of_ptr<const long, const int> result = any_cast_one_of<long, int>(&value);
+        check_equal(result.index(), 1u, "index");
+        check_equal(*result.get<1>(), 42, "value");
+        check_equal(result.get<1>(), any_cast<int>(&value), "pointer to the held value");
+    }
+}
+
+#endif
@@ -0,0 +1,285 @@
+//  Unit test for boost::anys::any_columnizer.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/any/any_columnizer.hpp>
+#include "test.hpp"
+
+void * operator new(std::size_t size)
+{
+    any_tests::allocations::instance().allocation();
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+BOOST_NOINLINE void operator delete(void * p) BOOST_NOEXCEPT
+{
+    if (p)
+        any_tests::allocations::instance().deallocation();
+    std::free(p);
+}
+
+#ifndef BOOST_NO_CXX14_SIZED_DEALLOCATION
+void operator delete(void * p, std::size_t) BOOST_NOEXCEPT
+{
+    operator delete(p);
+}
+#endif
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_type_inference();
+    void test_mismatches_are_null();
+    void test_short_and_long_rows();
+    void test_chunks();
+    void test_fixed_column_type();
+    void test_no_allocations_per_cell();
+    void test_alignment();
+    void test_throwing_copy();
+
+    const test_case test_cases[] =
+    {
+        { "column type inference",                test_type_inference          },
+        { "mismatching cells are null",           test_mismatches_are_null     },
+        { "short and long rows",                  test_short_and_long_rows     },
+        { "chunks",                               test_chunks                  },
+        { "fixed column type",                    test_fixed_column_type       },
+        { "no allocations per cell",              test_no_allocations_per_cell },
+        { "alignment of the columns",             test_alignment               },
+        { "copy of a cell that throws",           test_throwing_copy           }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    typedef std::vector<boost::any> row;
+    typedef std::vector<row> table;
+
+    row make_row(const boost::any & a, const boost::any & b, const boost::any & c)
+    {
+        row result;
+        result.push_back(a);
+        result.push_back(b);
+        result.push_back(c);
+        return result;
+    }
+
+    struct throwing_copy
+    {
+        static bool fail;
+
+        throwing_copy() {}
+        throwing_copy(const throwing_copy &)
+        {
+            if (fail)
+                throw std::bad_alloc();
+        }
+    };
+
+    bool throwing_copy::fail = false;
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_type_inference()
+    {
+        table rows;
+        rows.push_back(make_row(any(), std::string("a"), 1.5));
+        rows.push_back(make_row(2, std::string("b"), 2.5));
+        rows.push_back(make_row(3, any(), 3.5));
+
+        any_columnizer columns(3, 16);
+        check_true(columns.append(rows.begin(), rows.end()) == rows.end(), "all rows appended");
+        check_equal(columns.rows(), 3u, "rows");
+
+        check_true(columns.column_type(0) == typeindex::type_id<int>(), "first column type");
+        check_true(columns.column_type(1) == typeindex::type_id<std::string>(), "second column type");
+        check_true(columns.column_type(2) == typeindex::type_id<double>(), "third column type");
+
+        const any_columnizer & const_columns = columns;
+        check_null(const_columns.column<int>(0), "cells are not converted by a const columnizer");
+
+        const int * ints = columns.column<int>(0);
+        check_equal(const_columns.column<int>(0), ints, "converted column");
+        check_non_null(ints, "int column");
+        check_true(columns.is_null(0, 0), "leading empty cell");
+        check_equal(ints[0], 0, "null rows are zero");
+        check_equal(ints[1], 2, "second int");
+        check_equal(ints[2], 3, "third int");
+        check_equal(columns.column<std::string>(1)[1], "b", "string");
+        check_true(columns.is_null(1, 2), "empty string cell");
+        check_equal(columns.column<double>(2)[2], 3.5, "double");
+        check_equal(columns.null_count(2), 0u, "no nulls in the double column");
+        check_null(columns.column<long>(0), "column of another type");
+    }
+
+    void test_mismatches_are_null()
+    {
+        table rows;
+        for (int i = 0; i < 100; ++i)
+            rows.push_back(make_row(i, i % 10 != 5 ? any(i * 0.5) : any(i), std::string(1, 'x')));
+
+        any_columnizer columns(3, 128);
+        columns.append(rows.begin(), rows.end());
+
+        check_equal(columns.null_count(0), 0u, "int column");
+        check_equal(columns.null_count(1), 10u, "ints in the double column");
+        check_equal(columns.null_bitmap(1)[0] & 0x20u, 0x20u, "row 5 is null");
+        check_false(columns.is_null(1, 99), "row 99 is not null");
+        check_equal(columns.column<double>(1)[99], 49.5, "value of row 99");
+    }
+
+    void test_short_and_long_rows()
+    {
+        table rows(2);
+        rows[0].push_back(1);
+        rows[1] = make_row(2, 2.0, std::string("ignored"));
+
+        any_columnizer columns(2, 8);
+        columns.append(rows.begin(), rows.end());
+        check_true(columns.is_null(1, 0), "missing cell");
+        check_false(columns.is_null(1, 1), "present cell");
+        check_equal(columns.column<double>(1)[1], 2.0, "value after the short row");
+    }
+
+    void test_chunks()
+    {
+        table rows;
+        for (int i = 0; i < 10; ++i)
+            rows.push_back(make_row(i, std::string(1, static_cast<char>('0' + i)), any()));
+
+        any_columnizer columns(3, 4);
+        int sum = 0;
+        std::size_t chunks = 0;
+        for (table::iterator it = rows.begin(); it != rows.end(); ++chunks)
+        {
+            it = columns.append(it, rows.end());
+            check_true(columns.full() || it == rows.end(), "chunk is filled");
+            for (std::size_t r = 0; r < columns.rows(); ++r)
+                sum += columns.column<int>(0)[r];
+            columns.clear();
+        }
+
+        check_equal(chunks, 3u, "number of chunks");
+        check_equal(sum, 45, "every row is seen once");
+        check_true(columns.column_type(1) == typeindex::type_id<std::string>(), "type is kept");
+        check_true(columns.column_type(2) == typeindex::type_id<void>(), "all empty column");
+    }
+
+    void test_fixed_column_type()
+    {
+        table rows;
+        rows.push_back(make_row(1, 1, 1));
+
+        any_columnizer columns(3, 4);
+        columns.set_column_type<double>(1);
+        columns.append(rows.begin(), rows.end());
+        check_true(columns.is_null(1, 0), "int in a double column");
+        check_false(columns.is_null(0, 0), "inferred column");
+    }
+
+    void test_no_allocations_per_cell()
+    {
+        table rows;
+        for (int i = 0; i < 1000; ++i)
+            rows.push_back(make_row(i, i * 2.0, static_cast<long>(i)));
+
+        any_columnizer columns(3, 256);
+        columns.append(rows.begin(), rows.begin() + 1);
+        columns.column<int>(0);
+        columns.column<double>(1);
+        columns.column<long>(2);
+        columns.clear();
+
+        const unsigned long before = allocations::instance().allocated();
+        long total = 0;
+        for (table::iterator it = rows.begin(); it != rows.end(); columns.clear())
+        {
+            it = columns.append(it, rows.end());
+            const long * longs = columns.column<long>(2);
+            for (std::size_t r = 0; r < columns.rows(); ++r)
+                total += longs[r];
+        }
+        const unsigned long allocated = allocations::instance().allocated() - before;
+
+        check_equal(allocated, 0ul, "no allocations once the types are known");
+        check_equal(total, 499500l, "sum of the long column");
+    }
+
+    void test_alignment()
+    {
+        table rows;
+        rows.push_back(make_row('c', 1.0, std::string()));
+
+        any_columnizer columns(3, 5);
+        columns.append(rows.begin(), rows.end());
+        const std::size_t address = reinterpret_cast<std::size_t>(columns.column<char>(0));
+        check_equal(address % any_columnizer::column_alignment, 0u, "char column");
+        check_equal(reinterpret_cast<std::size_t>(columns.column<double>(1)) % 64, 0u, "double column");
+    }
+
+    void test_throwing_copy()
+    {
+        table rows;
+        rows.push_back(make_row(std::string("first"), 1, throwing_copy()));
+        rows.push_back(make_row(std::string("second"), 2, throwing_copy()));
+
+        any_columnizer columns(3, 4);
+        columns.append(rows.begin(), rows.begin() + 1);
+
+        throwing_copy::fail = true;
+        TEST_CHECK_THROW(
+            columns.append(rows.begin() + 1, rows.end()),
+            std::bad_alloc,
+            "append a row with a throwing cell");
+        throwing_copy::fail = false;
+
+        check_equal(columns.rows(), 1u, "row is not appended");
+        check_equal(columns.column<std::string>(0)[0], "first", "previous row is kept");
+
+        columns.append(rows.begin() + 1, rows.end());
+        check_equal(columns.column<std::string>(0)[1], "second", "row appended after the failure");
+
+        throwing_copy::fail = true;
+        TEST_CHECK_THROW(
+            columns.column<throwing_copy>(2),
+            std::bad_alloc,
+            "convert the copies of throwing cells");
+        throwing_copy::fail = false;
+
+        const any_columnizer & const_columns = columns;
+        check_null(const_columns.column<throwing_copy>(2), "column is not converted");
+        check_non_null(columns.column<throwing_copy>(2), "converted after the failure");
+        check_equal(columns.null_count(2), 0u, "no cell is lost");
+    }
+}
@@ -0,0 +1,364 @@
+//  Allocation, copy and move counts of boost::any operations.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include <boost/any.hpp>
+#include "test.hpp"
+
+void * operator new(std::size_t size)
+{
+    any_tests::allocations::instance().allocation();
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+BOOST_NOINLINE void operator delete(void * p) BOOST_NOEXCEPT
+{
+    if (p)
+        any_tests::allocations::instance().deallocation();
+    std::free(p);
+}
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+void operator delete(void * p, std::size_t) BOOST_NOEXCEPT
+{
+    operator delete(p);
+}
+#endif
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_empty();
+    void test_construction();
+    void test_copy_construction();
+    void test_move_construction();
+    void test_copy_assignment();
+    void test_move_assignment();
+    void test_value_assignment();
+    void test_swap();
+    void test_casts();
+    void test_clear();
+    void test_static_storage();
+
+    const test_case test_cases[] =
+    {
+        { "empty any",                            test_empty             },
+        { "construction from a value",            test_construction      },
+        { "copy construction",                    test_copy_construction },
+        { "move construction",                    test_move_construction },
+        { "copy assignment",                      test_copy_assignment   },
+        { "move assignment",                      test_move_assignment   },
+        { "assignment of a value",                test_value_assignment  },
+        { "swap",                                 test_swap              },
+        { "casts",                                test_casts             },
+        { "clear and destruction",                test_clear             },
+        { "static storage",                       test_static_storage    }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    // Counts its copies, moves and destructions
+    struct counted
+    {
+        counted() BOOST_NOEXCEPT
+          : value(0)
+        {
+        }
+
+        counted(const counted & other) BOOST_NOEXCEPT
+          : value(other.value)
+        {
+            ++copies;
+        }
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+        counted(counted&& other) BOOST_NOEXCEPT
+          : value(other.value)
+        {
+            ++moves;
+        }
+#endif
+
+        counted & operator=(const counted & other) BOOST_NOEXCEPT
+        {
+            value = other.value;
+            ++copies;
+            return *this;
+        }
+
+        ~counted() BOOST_NOEXCEPT
+        {
+            ++destructions;
+        }
+
+        int value;
+
+        static unsigned long copies, moves, destructions;
+    };
+
+    unsigned long counted::copies = 0;
+    unsigned long counted::moves = 0;
+    unsigned long counted::destructions = 0;
+
+    // Counts since construction. Read into locals before checking them:
+    // the descriptions of the checks allocate.
+    class counts
+    {
+    public:
+        counts() BOOST_NOEXCEPT
+          : allocated(allocations::instance().allocated())
+          , deallocated(allocations::instance().deallocated())
+          , copies(counted::copies)
+          , moves(counted::moves)
+          , destructions(counted::destructions)
+        {
+        }
+
+        counts since() const BOOST_NOEXCEPT
+        {
+            counts result;
+            result.allocated -= allocated;
+            result.deallocated -= deallocated;
+            result.copies -= copies;
+            result.moves -= moves;
+            result.destructions -= destructions;
+            return result;
+        }
+
+        unsigned long allocated, deallocated, copies, moves, destructions;
+    };
+
+    void check_counts(const counts & measured,
+        unsigned long allocated, unsigned long deallocated,
+        unsigned long copies, unsigned long moves,
+        const char * operation)
+    {
+        const std::string prefix = operation;
+        check_equal(measured.allocated, allocated, prefix + ": allocations");
+        check_equal(measured.deallocated, deallocated, prefix + ": deallocations");
+        check_equal(measured.copies, copies, prefix + ": copies");
+        check_equal(measured.moves, moves, prefix + ": moves");
+    }
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_empty()
+    {
+        counts before;
+        bool found = true;
+        {
+            any value;
+            any copy(value);
+            copy = value;
+            value.swap(copy);
+            value.clear();
+            found = any_cast<counted>(&value) != 0;
+        }
+        before = before.since();
+        check_counts(before, 0, 0, 0, 0, "empty any");
+        check_false(found, "any_cast of an empty any");
+    }
+
+    void test_construction()
+    {
+        const counted payload;
+
+        counts before;
+        {
+            const any value(payload);
+            before = before.since();
+        }
+        check_counts(before, 1, 0, 1, 0, "any(const T&)");
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+        counted source;
+        counts moved;
+        {
+            const any value(static_cast<counted&&>(source));
+            moved = moved.since();
+        }
+        check_counts(moved, 1, 0, 0, 1, "any(T&&)");
+#endif
+    }
+
+    void test_copy_construction()
+    {
+        const any original = counted();
+
+        counts before;
+        {
+            const any copy(original);
+            before = before.since();
+        }
+        check_counts(before, 1, 0, 1, 0, "any(const any&)");
+    }
+
+    void test_move_construction()
+    {
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+        any original = counted();
+
+        counts before;
+        {
+            const any moved(static_cast<any&&>(original));
+            before = before.since();
+        }
+        check_counts(before, 0, 0, 0, 0, "any(any&&)");
+#endif
+    }
+
+    void test_copy_assignment()
+    {
+        const any original = counted();
+        any target = counted();
+
+        counts before;
+        target = original;
+        before = before.since();
+        check_counts(before, 1, 1, 1, 0, "operator=(const any&)");
+    }
+
+    void test_move_assignment()
+    {
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+        any original = counted();
+        any target = counted();
+
+        counts before;
+        target = static_cast<any&&>(original);
+        before = before.since();
+        check_counts(before, 0, 1, 0, 0, "operator=(any&&)");
+        check_equal(before.destructions, 1u, "operator=(any&&): destructions");
+#endif
+    }
+
+    void test_value_assignment()
+    {
+        const counted payload;
+        any target = counted();
+
+        counts before;
+        target = payload;
+        before = before.since();
+        check_counts(before, 1, 1, 1, 0, "operator=(const T&)");
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+        counted source;
+        counts moved;
+        target = static_cast<counted&&>(source);
+        moved = moved.since();
+        check_counts(moved, 1, 1, 0, 1, "operator=(T&&)");
+#endif
+    }
+
+    void test_swap()
+    {
+        any lhs = counted(), rhs = counted(), empty;
+
+        counts before;
+        lhs.swap(rhs);
+        swap(lhs, rhs);
+        lhs.swap(empty);
+        before = before.since();
+        check_counts(before, 0, 0, 0, 0, "swap");
+        check_equal(before.destructions, 0u, "swap: destructions");
+    }
+
+    void test_casts()
+    {
+        any value = counted();
+        const any & constant = value;
+
+        counts references;
+        counted * const pointer = any_cast<counted>(&value);
+        const counted * const const_pointer = any_cast<counted>(&constant);
+        counted & reference = any_cast<counted&>(value);
+        const counted & const_reference = any_cast<const counted&>(constant);
+        const bool miss = any_cast<int>(&value) == 0;
+        references = references.since();
+        check_counts(references, 0, 0, 0, 0, "any_cast to pointers and references");
+        check_true(pointer == &reference && const_pointer == &const_reference && miss, "results");
+
+        counts copied;
+        {
+            const counted copy = any_cast<counted>(value);
+            (void)copy;
+        }
+        copied = copied.since();
+        check_counts(copied, 0, 0, 1, 0, "any_cast<T>(any&)");
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+        counts moved;
+        {
+            const counted stolen = any_cast<counted&&>(static_cast<any&&>(value));
+            (void)stolen;
+        }
+        moved = moved.since();
+        check_counts(moved, 0, 0, 0, 1, "any_cast<T&&>(any&&)");
+#endif
+    }
+
+    void test_clear()
+    {
+        any value = counted(), other = counted();
+
+        counts before;
+        value.clear();
+        before = before.since();
+        check_counts(before, 0, 1, 0, 0, "clear");
+        check_equal(before.destructions, 1u, "clear: destructions");
+
+        counts destroyed;
+        {
+            const any local(static_cast<const any &>(other));
+        }
+        destroyed = destroyed.since();
+        check_equal(destroyed.allocated, destroyed.deallocated, "destruction frees the holder");
+        check_equal(destroyed.destructions, 1u, "destruction: destructions");
+    }
+
+    void test_static_storage()
+    {
+        static any::static_storage<int> storage(42);
+
+        counts before;
+        {
+            const any value(storage);
+            const bool found = any_cast<int>(&value) != 0;
+            (void)found;
+        }
+        before = before.since();
+        check_counts(before, 0, 0, 0, 0, "any(static_storage&)");
+    }
+}
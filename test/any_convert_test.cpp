@@ -0,0 +1,243 @@
+//  Unit test for boost::anys::any_convert.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_HDR_MUTEX) || defined(BOOST_NO_CXX11_HDR_UNORDERED_MAP) \
+    || defined(BOOST_NO_CXX11_HDR_THREAD) || defined(BOOST_NO_CXX11_HDR_ATOMIC) \
+    || defined(BOOST_NO_CXX11_LAMBDAS)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/any_convert.hpp>
+#include <atomic>
+#include <thread>
+
+// The conversion tables allocate on first use and are never freed, so the
+// balanced counter of test.hpp is not used
+static std::atomic<unsigned long> heap_allocations(0);
+
+void * operator new(std::size_t size)
+{
+    ++heap_allocations;
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+BOOST_NOINLINE void operator delete(void * p) BOOST_NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) BOOST_NOEXCEPT
+{
+    operator delete(p);
+}
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_identity();
+    void test_numeric_widening();
+    void test_narrowing_is_not_built_in();
+    void test_string_conversions();
+    void test_registered_conversion();
+    void test_empty_and_unknown();
+    void test_memoized_lookup();
+    void test_concurrent_conversions();
+
+    const test_case test_cases[] =
+    {
+        { "identity",                             test_identity                  },
+        { "numeric widening",                     test_numeric_widening          },
+        { "narrowing is not built in",            test_narrowing_is_not_built_in },
+        { "string conversions",                   test_string_conversions        },
+        { "registered conversion",                test_registered_conversion     },
+        { "empty and unknown types",              test_empty_and_unknown         },
+        { "memoized lookup",                      test_memoized_lookup           },
+        { "concurrent conversions",               test_concurrent_conversions    }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    struct celsius
+    {
+        double degrees;
+    };
+
+    struct point
+    {
+        int x, y;
+    };
+
+    double to_fahrenheit(const celsius & value)
+    {
+        return value.degrees * 9 / 5 + 32;
+    }
+
+    double to_kelvin(const celsius & value)
+    {
+        return value.degrees + 273.15;
+    }
+
+    std::string point_to_string(const point & value)
+    {
+        return "(" + std::to_string(value.x) + ", " + std::to_string(value.y) + ")";
+    }
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_identity()
+    {
+        check_equal(any_convert<double>(any(2.5)), 2.5, "double");
+        check_equal(any_convert<std::string>(any(std::string("text"))), "text", "string");
+    }
+
+    void test_numeric_widening()
+    {
+        check_equal(any_convert<double>(any(static_cast<short>(-3))), -3.0, "short to double");
+        check_equal(any_convert<double>(any(7)), 7.0, "int to double");
+        check_equal(any_convert<double>(any(1.5f)), 1.5, "float to double");
+        check_equal(any_convert<int>(any(static_cast<unsigned char>(200))), 200, "unsigned char to int");
+        check_equal(any_convert<long long>(any(-5)), -5ll, "int to long long");
+        check_equal(any_convert<unsigned long>(any(5u)), 5ul, "unsigned to unsigned long");
+        check_equal(any_convert<int>(any(true)), 1, "bool to int");
+    }
+
+    void test_narrowing_is_not_built_in()
+    {
+        int result = 0;
+        check_false(try_any_convert(any(2.5), result), "double to int");
+        unsigned int u = 0;
+        check_false(try_any_convert(any(-1), u), "int to unsigned");
+        short s = 0;
+        check_false(try_any_convert(any(1), s), "int to short");
+        float f = 0;
+        check_false(try_any_convert(any(1.0), f), "double to float");
+        check_false(try_any_convert(any(16777217), f), "int to float");
+        double d = 0;
+        check_false(try_any_convert(any(9007199254740993ll), d), "long long to double");
+        TEST_CHECK_THROW(any_convert<int>(any(2.5)), bad_any_cast, "any_convert of double to int");
+    }
+
+    void test_string_conversions()
+    {
+        check_equal(any_convert<std::string>(any(42)), "42", "int to string");
+        check_equal(any_convert<std::string>(any(-1.5)), "-1.5", "double to string");
+        check_equal(any_convert<std::string>(any("literal")), "literal", "C string to string");
+        check_equal(any_convert<double>(any(std::string("3.25"))), 3.25, "string to double");
+        check_equal(any_convert<int>(any(std::string("-12"))), -12, "string to int");
+        TEST_CHECK_THROW(any_convert<int>(any(std::string("twelve"))), bad_lexical_cast, "string that is not a number");
+    }
+
+    void test_registered_conversion()
+    {
+        const celsius boiling = { 100.0 };
+        double result = 0;
+        check_false(try_any_convert(any(boiling), result), "not registered yet");
+
+        register_any_conversion<celsius, double>(&to_fahrenheit);
+        check_equal(any_convert<double>(any(boiling)), 212.0, "registered converter");
+
+        register_any_conversion<celsius, double>(&to_kelvin);
+        check_equal(any_convert<double>(any(boiling)), 373.15, "replaced converter");
+
+        const point p = { 1, 2 };
+        register_any_conversion<point, std::string>(&point_to_string);
+        check_equal(any_convert<std::string>(any(p)), "(1, 2)", "user type to string");
+        check_equal(any_convert<std::string>(any(3)), "3", "built in conversions are kept");
+    }
+
+    void test_empty_and_unknown()
+    {
+        double result = 1.0;
+        check_false(try_any_convert(any(), result), "empty");
+        check_false(try_any_convert(any(std::vector<int>()), result), "unknown type");
+        check_equal(result, 1.0, "result is unchanged");
+        TEST_CHECK_THROW(any_convert<double>(any()), bad_any_cast, "any_convert of empty");
+    }
+
+    void test_memoized_lookup()
+    {
+        std::vector<any> values;
+        for (int i = 0; i < 1000; ++i)
+            values.push_back(i % 2 ? any(static_cast<short>(i)) : any(static_cast<float>(i)));
+
+        double warm_up = 0;
+        try_any_convert(values[0], warm_up);
+        try_any_convert(values[1], warm_up);
+
+        const unsigned long before = heap_allocations;
+        double sum = 0;
+        for (std::size_t i = 0; i < values.size(); ++i)
+            sum += any_convert<double>(values[i]);
+        const unsigned long allocated = heap_allocations - before;
+
+        check_equal(allocated, 0ul, "memoized lookups do not allocate");
+        check_equal(sum, 499500.0, "sum");
+    }
+
+    void test_concurrent_conversions()
+    {
+        std::atomic<bool> wrong(false);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.push_back(std::thread([&wrong, t]() {
+                const any value(t);
+                const any text(std::to_string(t));
+                for (int i = 0; i < 2000; ++i)
+                {
+                    if (any_convert<double>(value) != t || any_convert<long long>(text) != t)
+                        wrong = true;
+                }
+            }));
+        }
+        for (int i = 0; i < 100; ++i)
+            register_any_conversion<celsius, double>(i % 2 ? &to_kelvin : &to_fahrenheit);
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+
+        check_false(wrong.load(), "conversions while converters are registered");
+    }
+}
+
+#endif
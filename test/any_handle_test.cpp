@@ -0,0 +1,178 @@
+//  Unit test for boost::anys::any_handle.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <string>
+
+#include <boost/any/any_handle.hpp>
+#include "test.hpp"
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_default_ctor();
+    void test_bound_handle();
+    void test_wrong_type();
+    void test_reassignment();
+    void test_swap_and_clear();
+    void test_refresh();
+    void test_const_handle();
+
+    const test_case test_cases[] =
+    {
+        { "default construction",                 test_default_ctor   },
+        { "handle to the held value",             test_bound_handle   },
+        { "handle to another type",               test_wrong_type     },
+        { "reassignment invalidates",             test_reassignment   },
+        { "swap and clear invalidate",            test_swap_and_clear },
+        { "refresh",                              test_refresh        },
+        { "handle to a const value",              test_const_handle   }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_default_ctor()
+    {
+        any_handle<int> handle;
+
+        check_false(static_cast<bool>(handle), "empty");
+        check_false(handle.valid(), "not valid");
+        check_null(handle.get(), "get");
+        check_null(handle.any_ptr(), "any_ptr");
+        check_false(handle.refresh(), "refresh");
+    }
+
+    void test_bound_handle()
+    {
+        any value = std::string("text");
+        any_handle<std::string> handle(value);
+
+        check_true(static_cast<bool>(handle), "bound");
+        check_true(handle.valid(), "valid");
+        check_equal(handle.get(), any_cast<std::string>(&value), "address of the held value");
+        check_equal(handle.any_ptr(), &value, "any_ptr");
+        check_equal(*handle, "text", "value");
+        check_equal(handle->size(), 4u, "member access");
+
+        *handle += " message";
+        check_equal(any_cast<std::string>(value), "text message", "modification through the handle");
+        check_true(handle.valid(), "valid after modification of the value");
+
+        handle.reset();
+        check_false(static_cast<bool>(handle), "empty after reset");
+    }
+
+    void test_wrong_type()
+    {
+        any value = 1;
+        any_handle<long> handle(value);
+
+        check_false(static_cast<bool>(handle), "int is not a long");
+        check_false(handle.valid(), "not valid");
+        check_null(handle.get(), "get");
+        check_equal(handle.any_ptr(), &value, "any_ptr");
+
+        any empty;
+        check_false(static_cast<bool>(make_any_handle<int>(empty)), "empty any");
+    }
+
+    void test_reassignment()
+    {
+        any value = 1;
+        any_handle<int> handle = make_any_handle<int>(value);
+        check_true(handle.valid(), "valid");
+
+        value = 2;
+        check_false(handle.valid(), "new value of the same type");
+        check_true(static_cast<bool>(handle), "still bound");
+
+        value = std::string("text");
+        check_false(handle.valid(), "value of another type");
+
+        // A new holder of the same type may reuse the address of the old one
+        any other = 3;
+        value = other;
+        check_true(!handle.valid() || *handle == 3, "copy assigned");
+    }
+
+    void test_swap_and_clear()
+    {
+        any value = 1, other = 2;
+        any_handle<int> handle(value);
+
+        value.swap(other);
+        check_false(handle.valid(), "swap");
+
+        handle.refresh();
+        check_equal(*handle, 2, "value after swap");
+        check_true(handle.valid(), "valid after refresh");
+
+        value.clear();
+        check_false(handle.valid(), "clear");
+    }
+
+    void test_refresh()
+    {
+        any value = 1;
+        any_handle<int> handle(value);
+
+        check_true(handle.refresh(), "refresh of a valid handle");
+        check_equal(*handle, 1, "value");
+
+        value = 5;
+        check_true(handle.refresh(), "refresh after reassignment");
+        check_true(handle.valid(), "valid after refresh");
+        check_equal(*handle, 5, "new value");
+
+        value = 1.5;
+        check_false(handle.refresh(), "refresh to another type");
+        check_false(static_cast<bool>(handle), "empty after refresh");
+        check_null(handle.get(), "get after refresh");
+
+        value = 7;
+        check_true(handle.refresh(), "refresh back to the type");
+        check_equal(*handle, 7, "value after refresh back");
+    }
+
+    void test_const_handle()
+    {
+        const any value = std::string("text");
+        any_handle<const std::string> handle = make_any_handle<std::string>(value);
+
+        check_true(handle.valid(), "valid");
+        check_equal(*handle, "text", "value");
+        check_equal(handle.get(), any_cast<std::string>(&value), "address");
+
+        any mutable_value = 1;
+        any_handle<const int> from_mutable(mutable_value);
+        check_equal(*from_mutable, 1, "const handle to a mutable any");
+    }
+}
@@ -0,0 +1,451 @@
+//  Unit test for boost::anys::any_log_writer and boost::anys::any_log_reader.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <string>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_HDR_MUTEX) || defined(BOOST_NO_CXX11_HDR_UNORDERED_MAP)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/any_log.hpp>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_round_trip();
+    void test_empty_values();
+    void test_random_access();
+    void test_iteration();
+    void test_views();
+    void test_user_types();
+    void test_append_to_existing();
+    void test_unregistered_type();
+    void test_incomplete_tail();
+    void test_not_a_log();
+    void test_header_is_written_at_once();
+    void test_empty_file();
+    void test_file_size();
+
+    const test_case test_cases[] =
+    {
+        { "values round trip",                    test_round_trip          },
+        { "empty values",                         test_empty_values        },
+        { "random access",                        test_random_access       },
+        { "iteration",                            test_iteration           },
+        { "records are views of the file",        test_views               },
+        { "registered types",                     test_user_types          },
+        { "appending to an existing log",         test_append_to_existing  },
+        { "types without a codec",                test_unregistered_type   },
+        { "incomplete record at the end",         test_incomplete_tail     },
+        { "files that are not logs",              test_not_a_log           },
+        { "header is written by the constructor", test_header_is_written_at_once },
+        { "empty files",                          test_empty_file          },
+        { "file sizes",                           test_file_size           }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    const char * const path = "any_log_test.log";
+
+    // Removes the log before and after a test
+    struct scoped_log
+    {
+        scoped_log()
+        {
+            std::remove(path);
+        }
+
+        ~scoped_log()
+        {
+            std::remove(path);
+        }
+    };
+
+    std::string file_bytes()
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    struct point
+    {
+        int x, y;
+    };
+
+    struct name_list
+    {
+        std::vector<std::string> names;
+    };
+
+    void encode_names(const name_list & value, std::string & out)
+    {
+        for (std::size_t i = 0; i < value.names.size(); ++i)
+            out.append(value.names[i]).push_back('\0');
+    }
+
+    name_list decode_names(const char * data, std::size_t size)
+    {
+        name_list value;
+        for (const char * end = data + size; data != end; data += value.names.back().size() + 1)
+            value.names.push_back(std::string(data));
+        return value;
+    }
+
+    struct unregistered
+    {
+        int value;
+    };
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_round_trip()
+    {
+        const scoped_log log;
+        {
+            any_log_writer writer(path);
+            writer.append(42);
+            writer.append(std::string("text"));
+            writer.append(2.5);
+            writer.append(any(static_cast<unsigned char>(7)));
+            writer.append(std::string());
+            check_equal(writer.size(), 5u, "writer size");
+        }
+
+        const any_log_reader reader(path);
+        check_equal(reader.size(), 5u, "reader size");
+        check_equal(reader.type_count(), 4u, "each type is defined once");
+        check_equal(any_cast<int>(reader[0].to_any()), 42, "int");
+        check_equal(any_cast<std::string>(reader[1].to_any()), "text", "std::string");
+        check_equal(any_cast<double>(reader[2].to_any()), 2.5, "double");
+        check_equal(any_cast<unsigned char>(reader[3].to_any()), 7, "boost::any");
+        check_equal(any_cast<std::string>(reader[4].to_any()), "", "empty std::string");
+        check_equal(reader[1].type_name(), "std::string", "type name");
+    }
+
+    void test_empty_values()
+    {
+        const scoped_log log;
+        {
+            any_log_writer writer(path);
+            writer.append(any());
+            writer.append(1);
+        }
+
+        const any_log_reader reader(path);
+        check_equal(reader.size(), 2u, "size");
+        check_true(reader[0].empty(), "empty record");
+        check_true(reader[0].to_any().empty(), "empty any");
+        check_equal(reader[0].type_name(), "", "no type name");
+        check_false(reader[0].is<int>(), "not an int");
+        check_false(reader[1].empty(), "value");
+    }
+
+    void test_random_access()
+    {
+        const scoped_log log;
+        {
+            any_log_writer writer(path);
+            for (int i = 0; i < 1000; ++i)
+            {
+                if (i % 3)
+                    writer.append(i);
+                else
+                    writer.append(std::string(static_cast<std::size_t>(i % 17), 'x'));
+            }
+        }
+
+        const any_log_reader reader(path, 16);
+        check_equal(reader.size(), 1000u, "size");
+
+        bool all = true;
+        for (std::size_t i = 999; i < 1000; --i)
+        {
+            const any value = reader[i].to_any();
+            if (i % 3)
+                all = all && any_cast<int>(value) == static_cast<int>(i);
+            else
+                all = all && any_cast<const std::string&>(value).size() == i % 17;
+        }
+        check_true(all, "every record, backwards");
+        check_equal(*reader.at(998).get<int>(), 998, "at");
+
+        TEST_CHECK_THROW(
+            reader.at(1000),
+            std::out_of_range,
+            "at past the end");
+    }
+
+    void test_iteration()
+    {
+        const scoped_log log;
+        {
+            any_log_writer writer(path);
+            for (int i = 0; i < 100; ++i)
+            {
+                writer.append(i);
+                writer.append(static_cast<double>(i));
+            }
+        }
+
+        const any_log_reader reader(path);
+        int ints = 0;
+        double sum = 0;
+        std::size_t count = 0;
+        for (any_log_reader::const_iterator it = reader.begin(); it != reader.end(); ++it, ++count)
+        {
+            const any_log_record record = *it;
+            if (const int * value = record.get<int>())
+            {
+                check_equal(*value, ints, "ints in order");
+                ++ints;
+            }
+            else if (const double * real = record.get<double>())
+            {
+                sum += *real;
+            }
+        }
+
+        check_equal(count, reader.size(), "every record");
+        check_equal(ints, 100, "ints");
+        check_equal(sum, 4950.0, "doubles");
+    }
+
+    void test_views()
+    {
+        const scoped_log log;
+        {
+            any_log_writer writer(path);
+            writer.append(std::string("view"));
+            writer.append(12345L);
+        }
+
+        const any_log_reader reader(path);
+        const any_log_record text = reader[0];
+        check_equal(std::string(text.data(), text.size()), "view", "bytes of a string");
+        check_true(text.is<std::string>(), "is std::string");
+        check_false(text.is<int>(), "is not int");
+
+        const any_log_record number = reader[1];
+        check_non_null(number.get<long>(), "get");
+        check_equal(*number.get<long>(), 12345L, "value");
+        check_null(number.get<int>(), "get of another type");
+        check_equal(number.get<long>(), reader[1].get<long>(), "same address every time");
+        check_equal(reinterpret_cast<std::size_t>(number.data()) % 8, 0u, "aligned");
+    }
+
+    void test_user_types()
+    {
+        register_any_log_type<point>("any_tests::point");
+        register_any_log_type<name_list>("any_tests::name_list", &encode_names, &decode_names);
+
+        const scoped_log log;
+        {
+            any_log_writer writer(path);
+            const point p = { 3, 4 };
+            writer.append(p);
+
+            name_list names;
+            names.names.push_back("first");
+            names.names.push_back("second");
+            writer.append(any(names));
+        }
+
+        const any_log_reader reader(path);
+        check_equal(reader[0].type_name(), "any_tests::point", "name of a trivial type");
+        check_equal(reader[0].get<point>()->y, 4, "view of a trivial type");
+        check_equal(any_cast<point>(reader[0].to_any()).x, 3, "trivial type");
+
+        const any names = reader[1].to_any();
+        check_equal(any_cast<const name_list&>(names).names.size(), 2u, "encoded type");
+        check_equal(any_cast<const name_list&>(names).names[1], "second", "encoded value");
+    }
+
+    void test_append_to_existing()
+    {
+        const scoped_log log;
+        {
+            any_log_writer writer(path);
+            writer.append(1);
+            writer.append(std::string("one"));
+        }
+        {
+            any_log_writer writer(path);
+            check_equal(writer.size(), 2u, "existing records");
+            writer.append(2);
+            writer.append(2.0);
+            writer.flush();
+
+            const any_log_reader flushed(path);
+            check_equal(flushed.size(), 4u, "flushed records are visible");
+        }
+
+        const any_log_reader reader(path);
+        check_equal(reader.size(), 4u, "size");
+        check_equal(reader.type_count(), 3u, "types are not defined again");
+        check_equal(any_cast<int>(reader[2].to_any()), 2, "appended int");
+        check_equal(any_cast<double>(reader[3].to_any()), 2.0, "appended double");
+    }
+
+    void test_unregistered_type()
+    {
+        const scoped_log log;
+        any_log_writer writer(path);
+        const unregistered value = { 1 };
+        TEST_CHECK_THROW(
+            writer.append(value),
+            any_log_error,
+            "append of a type without a codec");
+        TEST_CHECK_THROW(
+            writer.append(any(value)),
+            any_log_error,
+            "append of a boost::any holding it");
+
+        writer.append(1);
+        check_equal(writer.size(), 1u, "nothing was appended");
+    }
+
+    void test_incomplete_tail()
+    {
+        const scoped_log log;
+        {
+            any_log_writer writer(path);
+            writer.append(1);
+            writer.append(std::string(100, 'x'));
+        }
+        {
+            // Half of the last record
+            std::string bytes = file_bytes();
+            bytes.resize(bytes.size() - 50);
+            std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+
+        const any_log_reader reader(path);
+        check_equal(reader.size(), 1u, "incomplete record is ignored");
+        check_equal(any_cast<int>(reader[0].to_any()), 1, "complete record");
+
+        const std::string bytes = file_bytes();
+        TEST_CHECK_THROW(
+            any_log_writer writer(path),
+            any_log_error,
+            "append after an incomplete record");
+        check_true(file_bytes() == bytes, "the file is left as it was");
+    }
+
+    void test_not_a_log()
+    {
+        const scoped_log log;
+        std::ofstream(path, std::ios::binary) << "not a log of boost::any values";
+
+        TEST_CHECK_THROW(
+            any_log_reader reader(path),
+            any_log_error,
+            "reader");
+        TEST_CHECK_THROW(
+            any_log_writer writer(path),
+            any_log_error,
+            "writer");
+        check_true(file_bytes() == "not a log of boost::any values", "the file is not truncated");
+        TEST_CHECK_THROW(
+            any_log_reader reader("any_log_test.missing"),
+            any_log_error,
+            "missing file");
+    }
+
+    void test_header_is_written_at_once()
+    {
+        const scoped_log log;
+        any_log_writer writer(path);
+
+        const any_log_reader reader(path);
+        check_true(reader.empty(), "a new log is empty");
+        check_true(reader.begin() == reader.end(), "no records");
+        check_equal(reader.valid_size(), 16u, "only the header");
+    }
+
+    void test_empty_file()
+    {
+        const scoped_log log;
+        std::ofstream(path, std::ios::binary);
+        {
+            const any_log_reader reader(path);
+            check_true(reader.empty(), "an empty file is an empty log");
+            check_true(reader.begin() == reader.end(), "no records");
+        }
+        {
+            any_log_writer writer(path);
+            check_equal(writer.size(), 0u, "no records to append to");
+            writer.append(1);
+        }
+
+        const any_log_reader reader(path);
+        check_equal(reader.size(), 1u, "size");
+        check_equal(any_cast<int>(reader[0].to_any()), 1, "value");
+    }
+
+    void test_file_size()
+    {
+        const scoped_log log;
+        check_true(anys::detail::log_file_size(path) == -1, "no file");
+
+        std::ofstream(path, std::ios::binary);
+        check_true(anys::detail::log_file_size(path) == 0, "empty file");
+
+        {
+            any_log_writer writer(path);
+            writer.append(1);
+            writer.flush();
+            check_true(anys::detail::log_file_size(path) == static_cast<boost::int64_t>(any_log_reader(path).valid_size()),
+                "header and one record");
+        }
+        {
+            // Appends at the end, whatever the position "ab" reports
+            any_log_writer writer(path);
+            writer.append(2);
+        }
+
+        const any_log_reader reader(path);
+        check_equal(reader.size(), 2u, "appended to");
+        check_true(anys::detail::log_file_size(path) == static_cast<boost::int64_t>(reader.valid_size()),
+            "size of the log");
+    }
+}
+
+#endif
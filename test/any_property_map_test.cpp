@@ -0,0 +1,350 @@
+//  Unit test for boost::anys::any_property_map.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_HDR_MUTEX) \
+    || defined(BOOST_NO_CXX11_HDR_ATOMIC)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/any_property_map.hpp>
+#include <boost/move/move.hpp>
+
+void * operator new(std::size_t size)
+{
+    any_tests::allocations::instance().allocation();
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+BOOST_NOINLINE void operator delete(void * p) BOOST_NOEXCEPT
+{
+    if (p)
+        any_tests::allocations::instance().deallocation();
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) BOOST_NOEXCEPT
+{
+    operator delete(p);
+}
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+
+    void intern_keys();
+}
+
+int main()
+{
+    using namespace any_tests;
+    intern_keys();
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_key_interning();
+    void test_default_ctor();
+    void test_insert_and_find();
+    void test_assign();
+    void test_string_view_lookup();
+    void test_many_keys();
+    void test_erase();
+    void test_copy();
+    void test_move();
+    void test_throwing_copy();
+    void test_any_values();
+
+    const test_case test_cases[] =
+    {
+        { "key interning",                        test_key_interning       },
+        { "default construction",                 test_default_ctor        },
+        { "insert and find",                      test_insert_and_find     },
+        { "assign existing keys",                 test_assign              },
+        { "lookup by name",                       test_string_view_lookup  },
+        { "many keys",                            test_many_keys           },
+        { "erase",                                test_erase               },
+        { "copy",                                 test_copy                },
+        { "move",                                 test_move                },
+        { "copy of a value that throws",          test_throwing_copy       },
+        { "boost::any values",                    test_any_values          }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    struct large
+    {
+        char data[100];
+    };
+
+    struct throwing_copy
+    {
+        static bool fail;
+
+        throwing_copy() {}
+        throwing_copy(const throwing_copy &)
+        {
+            if (fail)
+                throw std::bad_alloc();
+        }
+    };
+
+    bool throwing_copy::fail = false;
+
+    // Interned names stay allocated for the lifetime of the process, so
+    // they are interned before the allocations are checked.
+    void intern_keys()
+    {
+        const char * const names[] = {
+            "property_map.a", "property_map.b", "x", "id", "name", "payload", "value", "color",
+            "erase.a", "erase.b", "copy.large", "move.key", "throwing.a", "throwing.b", "throwing.c",
+            "any.small", "any.large", "any.empty"
+        };
+        for (std::size_t i = 0; i < sizeof names / sizeof *names; ++i)
+            boost::property_key key(names[i]);
+        for (int i = 0; i < 30; ++i)
+        {
+            boost::property_key many("many." + std::to_string(i));
+            boost::property_key copy("copy." + std::to_string(i));
+        }
+    }
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_key_interning()
+    {
+        const property_key a("property_map.a");
+        const property_key b("property_map.b");
+        const property_key a2(std::string("property_map.a"));
+
+        check_true(a == a2, "same name, same key");
+        check_true(a != b, "different names, different keys");
+        check_equal(a.id(), a2.id(), "ids");
+        check_true(a.name() == "property_map.a", "name");
+
+        property_key found = b;
+        check_true(property_key::find("property_map.a", found), "find interned name");
+        check_true(found == a, "found key");
+        check_false(property_key::find("property_map.never_interned", found), "find unknown name");
+    }
+
+    void test_default_ctor()
+    {
+        const any_property_map map;
+
+        check_true(map.empty(), "empty");
+        check_equal(map.size(), 0u, "size");
+        check_true(map.find(property_key("x")).empty(), "find");
+    }
+
+    void test_insert_and_find()
+    {
+        any_property_map map;
+        const property_key id("id"), name("name"), payload("payload");
+
+        check_true(map.insert_or_assign(name, std::string("record")), "insert string");
+        check_true(map.insert_or_assign(id, 42), "insert int");
+        check_true(map.insert_or_assign(payload, large()), "insert large value");
+        check_equal(map.size(), 3u, "size");
+
+        check_equal(any_cast<int>(map.find(id)), 42, "int");
+        check_equal(any_cast<std::string>(map.find(name)), "record", "string");
+        any_view value = map.find(payload);
+        check_non_null(any_cast<large>(&value), "large value");
+        value = map.find(id);
+        check_null(any_cast<long>(&value), "wrong type");
+
+        check_true(any_property_map::is_stored_inline<int>::value, "int is stored inline");
+        check_false(any_property_map::is_stored_inline<large>::value, "large value is boxed");
+
+        // Keys are kept in order of their ids
+        for (std::size_t i = 1; i < map.size(); ++i)
+            check_true(map.key_at(i - 1) < map.key_at(i), "keys are sorted");
+    }
+
+    void test_assign()
+    {
+        any_property_map map;
+        const property_key key("value");
+
+        map.insert_or_assign(key, 1);
+        check_false(map.insert_or_assign(key, 2), "assign same type");
+        check_equal(any_cast<int>(map.find(key)), 2, "value after assignment");
+        check_false(map.insert_or_assign(key, std::string("three")), "assign other type");
+        check_equal(any_cast<std::string>(map.find(key)), "three", "value of other type");
+        check_false(map.insert_or_assign(key, large()), "assign boxed type");
+        check_false(map.insert_or_assign(key, 4.0), "assign inline type again");
+        check_equal(any_cast<double>(map.find(key)), 4.0, "value after several assignments");
+        check_equal(map.size(), 1u, "size");
+    }
+
+    void test_string_view_lookup()
+    {
+        any_property_map map;
+        map.insert_or_assign("color", std::string("red"));
+
+        const char text[] = "colorful";
+        check_equal(any_cast<std::string>(map.find(string_view(text, 5))), "red", "find by name");
+        check_true(map.contains("color"), "contains");
+        check_false(map.contains("colour"), "contains unknown name");
+        property_key key("color");
+        check_false(property_key::find("colour", key), "lookup does not intern");
+    }
+
+    void test_many_keys()
+    {
+        any_property_map map;
+        std::vector<property_key> keys;
+        for (int i = 0; i < 30; ++i)
+            keys.push_back(property_key("many." + std::to_string(i)));
+
+        // Insert in reverse order to exercise the sorted insertion
+        for (int i = 29; i >= 0; --i)
+            map.insert_or_assign(keys[static_cast<std::size_t>(i)], i);
+        for (int i = 0; i < 30; ++i)
+            map.insert_or_assign(keys[static_cast<std::size_t>(i)], i % 3 ? std::to_string(i) : std::string("#"));
+
+        bool all_found = true;
+        for (int i = 0; i < 30; ++i)
+        {
+            const_any_view view = static_cast<const any_property_map&>(map).find(keys[static_cast<std::size_t>(i)]);
+            const std::string * value = any_cast<std::string>(&view);
+            all_found = all_found && value && *value == (i % 3 ? std::to_string(i) : std::string("#"));
+        }
+        check_true(all_found, "all values are found");
+        check_equal(map.size(), 30u, "size");
+    }
+
+    void test_erase()
+    {
+        any_property_map map;
+        const property_key a("erase.a"), b("erase.b");
+        map.insert_or_assign(a, std::string("a"));
+        map.insert_or_assign(b, large());
+
+        check_true(map.erase(a), "erase existing key");
+        check_false(map.erase(a), "erase missing key");
+        check_true(map.find(a).empty(), "erased value");
+        check_false(map.find(b).empty(), "value left");
+        map.clear();
+        check_true(map.empty(), "empty after clear");
+    }
+
+    void test_copy()
+    {
+        any_property_map original;
+        for (int i = 0; i < 10; ++i)
+            original.insert_or_assign("copy." + std::to_string(i), i);
+        original.insert_or_assign("copy.large", large());
+
+        const unsigned long before = allocations::instance().allocated();
+        any_property_map copy(original);
+        const unsigned long allocated = allocations::instance().allocated() - before;
+
+        check_equal(allocated, 3ul, "keys, arena and the boxed value");
+        check_equal(copy.size(), original.size(), "size");
+        check_equal(any_cast<int>(copy.find("copy.7")), 7, "copied value");
+        any_cast<int&>(copy.find("copy.7")) = 70;
+        check_equal(any_cast<int>(original.find("copy.7")), 7, "copies are independent");
+
+        original = copy;
+        check_equal(any_cast<int>(original.find("copy.7")), 70, "assigned value");
+    }
+
+    void test_move()
+    {
+        any_property_map original;
+        original.insert_or_assign("move.key", std::string("value"));
+        any_view view = original.find("move.key");
+        const std::string * address = any_cast<std::string>(&view);
+
+        any_property_map moved(boost::move(original));
+        check_true(original.empty(), "moved away map is empty");
+        view = moved.find("move.key");
+        check_equal(any_cast<std::string>(&view), address, "value is not moved");
+
+        any_property_map assigned;
+        assigned = boost::move(moved);
+        check_true(moved.empty(), "moved away map is empty after assignment");
+        check_equal(assigned.size(), 1u, "size after move assignment");
+    }
+
+    void test_throwing_copy()
+    {
+        any_property_map original;
+        original.insert_or_assign("throwing.a", std::string("a"));
+        original.insert_or_assign("throwing.b", throwing_copy());
+        original.insert_or_assign("throwing.c", std::string("c"));
+
+        throwing_copy::fail = true;
+        TEST_CHECK_THROW(
+            any_property_map copy(original),
+            std::bad_alloc,
+            "copy of a map with a throwing value");
+        TEST_CHECK_THROW(
+            original.insert_or_assign("throwing.a", throwing_copy()),
+            std::bad_alloc,
+            "insert a throwing value");
+        throwing_copy::fail = false;
+
+        check_equal(any_cast<std::string>(original.find("throwing.a")), "a", "value is unchanged");
+        check_equal(original.size(), 3u, "size is unchanged");
+    }
+
+    void test_any_values()
+    {
+        any_property_map map;
+        const property_key small("any.small"), boxed("any.large"), empty("any.empty");
+
+        check_true(map.insert_or_assign(small, any(5)), "insert boost::any");
+        check_true(map.insert_or_assign(boxed, any(large())), "insert boost::any of a large value");
+        check_true(map.insert_or_assign(empty, any()), "insert empty boost::any");
+
+        check_equal(any_cast<int>(map.find(small)), 5, "value held by the boost::any");
+        any_view value = map.find(boxed);
+        check_non_null(any_cast<large>(&value), "large value held by the boost::any");
+        check_true(map.find(empty).empty(), "empty boost::any");
+        check_true(map.contains(empty), "key of an empty boost::any");
+
+        check_false(map.insert_or_assign(small, std::string("text")), "assign a value over a boost::any");
+        check_equal(any_cast<std::string>(map.find(small)), "text", "assigned value");
+        check_false(map.insert_or_assign(small, any(6)), "assign a boost::any over a value");
+        check_equal(any_cast<int>(map.find(small)), 6, "assigned boost::any");
+
+        const any_property_map copy(map);
+        check_equal(any_cast<int>(copy.find(small)), 6, "copied boost::any");
+    }
+}
+
+#endif
@@ -0,0 +1,378 @@
+//  Unit test for boost::anys::any_queue.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_HDR_ATOMIC) \
+    || defined(BOOST_NO_CXX11_HDR_TYPE_TRAITS) || defined(BOOST_NO_CXX11_HDR_THREAD) \
+    || defined(BOOST_NO_CXX11_LAMBDAS)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/any_queue.hpp>
+#include <atomic>
+#include <thread>
+
+// The allocation counter of test.hpp is not thread safe
+static std::atomic<unsigned long> heap_allocations(0);
+
+void * operator new(std::size_t size)
+{
+    ++heap_allocations;
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+BOOST_NOINLINE void operator delete(void * p) BOOST_NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) BOOST_NOEXCEPT
+{
+    operator delete(p);
+}
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_capacity();
+    void test_fifo_order();
+    void test_full_and_empty();
+    void test_inline_storage();
+    void test_large_values();
+    void test_batch_consume();
+    void test_any_is_unwrapped();
+    void test_throwing_visitor();
+    void test_destructor_drains();
+    void test_concurrent_producers_consumers();
+
+    const test_case test_cases[] =
+    {
+        { "capacity is a power of two",           test_capacity                        },
+        { "values come out in FIFO order",        test_fifo_order                      },
+        { "full and empty queue",                 test_full_and_empty                  },
+        { "small values do not allocate",         test_inline_storage                  },
+        { "large values are stored as any",       test_large_values                    },
+        { "batch consume",                        test_batch_consume                   },
+        { "pushed any is unwrapped",              test_any_is_unwrapped                },
+        { "visitor that throws",                  test_throwing_visitor                },
+        { "destructor destroys queued values",    test_destructor_drains               },
+        { "concurrent producers and consumers",   test_concurrent_producers_consumers  }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    struct large
+    {
+        char data[128];
+    };
+
+    struct counted
+    {
+        static int alive;
+
+        counted() { ++alive; }
+        counted(const counted &) { ++alive; }
+        ~counted() { --alive; }
+    };
+
+    int counted::alive = 0;
+
+    struct many_counted
+    {
+        counted items[3];
+        large padding;
+    };
+
+    template<typename ValueType>
+    struct sum_of
+    {
+        long * sum;
+
+        void operator()(boost::any_view value) const
+        {
+            *sum += *boost::any_cast<ValueType>(&value);
+        }
+    };
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_capacity()
+    {
+        check_equal(any_queue(1).capacity(), 2u, "capacity 1");
+        check_equal(any_queue(8).capacity(), 8u, "capacity 8");
+        check_equal(any_queue(9).capacity(), 16u, "capacity 9");
+    }
+
+    void test_fifo_order()
+    {
+        any_queue queue(8);
+        check_true(queue.try_push(1), "push int");
+        check_true(queue.try_push(std::string("two")), "push string");
+        check_true(queue.try_push(3.0), "push double");
+
+        any value;
+        check_true(queue.try_pop(value), "pop int");
+        check_equal(any_cast<int>(value), 1, "int");
+        check_true(queue.try_pop(value), "pop string");
+        check_equal(any_cast<std::string>(value), "two", "string");
+        check_true(queue.try_pop(value), "pop double");
+        check_equal(any_cast<double>(value), 3.0, "double");
+        check_false(queue.try_pop(value), "pop from an empty queue");
+        check_equal(any_cast<double>(value), 3.0, "failed pop leaves the target unchanged");
+    }
+
+    void test_full_and_empty()
+    {
+        any_queue queue(4);
+        check_true(queue.empty(), "new queue is empty");
+        for (int i = 0; i < 4; ++i)
+            check_true(queue.try_push(i), "push into a queue with room");
+        check_false(queue.try_push(4), "push into a full queue");
+        check_false(queue.empty(), "full queue is not empty");
+
+        // The ring wraps around
+        any value;
+        for (int round = 0; round < 3; ++round)
+        {
+            check_true(queue.try_pop(value), "pop after wrap around");
+            check_true(queue.try_push(10 + round), "push after wrap around");
+        }
+
+        std::vector<int> seen;
+        while (queue.try_pop(value))
+            seen.push_back(any_cast<int>(value));
+        check_equal(seen.size(), 4u, "values left");
+        check_equal(seen[0], 3, "first value left");
+        check_equal(seen[3], 12, "last value left");
+        check_true(queue.empty(), "drained queue is empty");
+    }
+
+    void test_inline_storage()
+    {
+        check_true(any_queue::is_stored_inline<int>::value, "int is stored inline");
+        check_true(any_queue::is_stored_inline<std::string>::value == (sizeof(std::string) <= 3 * sizeof(void *)),
+            "std::string is stored inline if it fits");
+        check_false(any_queue::is_stored_inline<large>::value, "large struct is not stored inline");
+        check_true(basic_any_queue<sizeof(large)>::is_stored_inline<large>::value, "large struct fits a larger slot");
+
+        any_queue queue(16);
+        long sum = 0;
+        const unsigned long before = heap_allocations;
+        for (int i = 1; i <= 10; ++i)
+            queue.try_push(i);
+        while (queue.try_consume(sum_of<int>{ &sum }))
+        {
+        }
+        const unsigned long after = heap_allocations;
+
+        check_equal(sum, 55l, "sum of consumed values");
+        check_equal(after, before, "no allocations for inline values");
+    }
+
+    void test_large_values()
+    {
+        any_queue queue(4);
+        large value;
+        value.data[0] = 'a';
+        value.data[127] = 'z';
+
+        any result;
+        const unsigned long before = heap_allocations;
+        const bool pushed = queue.try_push(value);
+        const unsigned long after_push = heap_allocations;
+        const bool popped = queue.try_pop(result);
+        const unsigned long after_pop = heap_allocations;
+
+        check_true(pushed, "push large value");
+        check_true(popped, "pop large value");
+        check_equal(after_push - before, 1ul, "one holder allocation on push");
+        check_equal(after_pop, after_push, "no allocation on pop");
+        check_equal(any_cast<large&>(result).data[0], 'a', "first byte");
+        check_equal(any_cast<large&>(result).data[127], 'z', "last byte");
+    }
+
+    void test_batch_consume()
+    {
+        any_queue queue(8);
+        for (int i = 1; i <= 6; ++i)
+            queue.try_push(i);
+
+        long sum = 0;
+        check_equal(queue.try_consume_batch(sum_of<int>{ &sum }, 4), 4u, "first batch");
+        check_equal(sum, 10l, "sum of the first batch");
+        check_equal(queue.try_consume_batch(sum_of<int>{ &sum }, 4), 2u, "second batch");
+        check_equal(sum, 21l, "sum of both batches");
+        check_equal(queue.try_consume_batch(sum_of<int>{ &sum }, 4), 0u, "batch from an empty queue");
+
+        queue.try_push(7);
+        check_equal(queue.try_consume_batch(sum_of<int>{ &sum }, 0), 0u, "batch of no values");
+        check_false(queue.empty(), "batch of no values leaves the queue unchanged");
+        check_equal(queue.try_consume_batch(sum_of<int>{ &sum }, 4), 1u, "batch after a batch of no values");
+        check_equal(sum, 28l, "sum after a batch of no values");
+    }
+
+    void test_any_is_unwrapped()
+    {
+        any_queue queue(8);
+        const any text = std::string("text");
+        check_true(queue.try_push(any(42)), "push a boost::any rvalue");
+        check_true(queue.try_push(text), "push a const boost::any");
+        check_true(queue.try_push(any()), "push an empty boost::any");
+
+        long sum = 0;
+        check_true(queue.try_consume(sum_of<int>{ &sum }), "consume");
+        check_equal(sum, 42l, "visitor sees the held int");
+
+        any value;
+        check_true(queue.try_pop(value), "pop");
+        check_equal(any_cast<std::string>(value), "text", "held std::string");
+        check_equal(any_cast<std::string>(text), "text", "pushed boost::any is copied");
+
+        bool empty_seen = false;
+        check_true(queue.try_consume([&empty_seen](any_view view) { empty_seen = view.empty(); }), "consume empty");
+        check_true(empty_seen, "visitor sees an empty view");
+
+        queue.try_push(any(5));
+        check_true(queue.try_pop(value), "pop int");
+        check_equal(any_cast<int>(value), 5, "any_cast to the pushed type");
+    }
+
+    void test_throwing_visitor()
+    {
+        {
+            any_queue queue(8);
+            for (int i = 0; i < 4; ++i)
+                queue.try_push(counted());
+            check_equal(counted::alive, 4, "queued values");
+
+            int calls = 0;
+            TEST_CHECK_THROW(
+                queue.try_consume_batch([&calls](any_view) {
+                    if (++calls == 2)
+                        throw std::runtime_error("second value fails");
+                }, 3),
+                std::runtime_error,
+                "exception from the visitor");
+            check_equal(counted::alive, 1, "claimed values are destroyed");
+
+            any value;
+            check_true(queue.try_pop(value), "value after the batch is still queued");
+            check_false(queue.try_pop(value), "queue is empty");
+        }
+        check_equal(counted::alive, 0, "values destroyed");
+    }
+
+    void test_destructor_drains()
+    {
+        {
+            any_queue queue(4);
+            queue.try_push(counted());
+            queue.try_push(many_counted());
+            check_equal(counted::alive, 4, "queued values");
+        }
+        check_equal(counted::alive, 0, "values destroyed by the destructor");
+    }
+
+    void test_concurrent_producers_consumers()
+    {
+        const int producers = 4, consumers = 4, per_producer = 20000;
+        any_queue queue(64);
+        std::atomic<long> sum(0);
+        std::atomic<int> consumed(0);
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.push_back(std::thread([&queue, p]() {
+                for (int i = 1; i <= per_producer; ++i)
+                {
+                    if (i % 2)
+                    {
+                        while (!queue.try_push(i))
+                            std::this_thread::yield();
+                    }
+                    else
+                    {
+                        while (!queue.try_push(std::string(static_cast<std::size_t>(p + 1), 'x')))
+                            std::this_thread::yield();
+                    }
+                }
+            }));
+        }
+        for (int c = 0; c < consumers; ++c)
+        {
+            threads.push_back(std::thread([&queue, &sum, &consumed, c]() {
+                const auto visitor = [&sum](any_view value) {
+                    if (const int * i = any_cast<int>(&value))
+                        sum += *i;
+                    else
+                        sum += static_cast<long>(any_cast<std::string>(value).size());
+                };
+                while (consumed.load() < producers * per_producer)
+                {
+                    const std::size_t n = c % 2
+                        ? queue.try_consume_batch(visitor, 8)
+                        : static_cast<std::size_t>(queue.try_consume(visitor));
+                    if (n)
+                        consumed += static_cast<int>(n);
+                    else
+                        std::this_thread::yield();
+                }
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+
+        // Odd numbers 1..per_producer-1 from each producer plus string sizes
+        long expected = 0;
+        for (int p = 0; p < producers; ++p)
+            expected += static_cast<long>(per_producer / 2) * (per_producer / 2) + (per_producer / 2) * (p + 1);
+
+        check_equal(consumed.load(), producers * per_producer, "values consumed");
+        check_equal(sum.load(), expected, "sum of consumed values");
+        check_true(queue.empty(), "queue is empty");
+    }
+}
+
+#endif
@@ -0,0 +1,176 @@
+//  Unit test for boost::any::static_storage.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include <boost/any.hpp>
+#include <boost/move/move.hpp>
+#include "test.hpp"
+
+void * operator new(std::size_t size)
+{
+    any_tests::allocations::instance().allocation();
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+BOOST_NOINLINE void operator delete(void * p) BOOST_NOEXCEPT
+{
+    if (p)
+        any_tests::allocations::instance().deallocation();
+    std::free(p);
+}
+
+#ifndef BOOST_NO_CXX14_SIZED_DEALLOCATION
+void operator delete(void * p, std::size_t) BOOST_NOEXCEPT
+{
+    operator delete(p);
+}
+#endif
+
+// `constinit` where available, otherwise the check is done at run time by
+// `seen_by_dynamic_initializer` below.
+#if defined(__cpp_constinit) && __cpp_constinit >= 201907L
+#   define TEST_CONSTINIT constinit
+#else
+#   define TEST_CONSTINIT
+#endif
+
+// The hash of the type names is only a constant expression since C++14
+#if !defined(BOOST_NO_CXX11_CONSTEXPR) \
+    && !(defined(BOOST_ANY_DETAIL_USE_TYPE_HASH) && defined(BOOST_NO_CXX14_CONSTEXPR))
+#   define TEST_CONSTANT_INITIALIZATION
+#else
+#   undef TEST_CONSTINIT
+#   define TEST_CONSTINIT
+#endif
+
+namespace any_tests
+{
+    struct point
+    {
+        BOOST_CONSTEXPR point(int x_, int y_)
+          : x(x_), y(y_)
+        {
+        }
+
+        int x, y;
+    };
+
+    extern boost::any answer;
+
+    // Dynamically initialized before `answer` is defined: sees its value
+    // only if `answer` was constant-initialized.
+    const bool seen_by_dynamic_initializer = boost::any_cast<int>(&answer) != 0;
+
+    boost::any::static_storage<int> answer_storage(42);
+    TEST_CONSTINIT boost::any answer(answer_storage);
+
+    boost::any::static_storage<point> origin_storage(point(0, 0));
+    TEST_CONSTINIT boost::any origin(origin_storage);
+
+    boost::any::static_storage<const char *> name_storage("name");
+    TEST_CONSTINIT boost::any name = name_storage;
+
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_constant_initialization();
+    void test_values();
+    void test_copy_is_allocated();
+    void test_move_and_assign();
+
+    const test_case test_cases[] =
+    {
+        { "constant initialization",              test_constant_initialization },
+        { "values",                               test_values                  },
+        { "copy is allocated",                    test_copy_is_allocated       },
+        { "move and assignment",                  test_move_and_assign         }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_constant_initialization()
+    {
+#ifdef TEST_CONSTANT_INITIALIZATION
+        check_true(seen_by_dynamic_initializer, "value is set before dynamic initialization");
+#endif
+        check_equal(any_cast<int>(answer), 42, "value");
+    }
+
+    void test_values()
+    {
+        check_equal(any_cast<const point &>(origin).y, 0, "literal class");
+        check_equal(std::string(any_cast<const char *>(name)), "name", "pointer");
+        check_null(any_cast<long>(&answer), "wrong type");
+        check_true(answer.type() == typeindex::type_id<int>(), "type");
+
+        any_cast<int &>(answer) = 43;
+        check_equal(any_cast<int>(answer_storage.held), 43, "value is held by the storage");
+        any_cast<int &>(answer) = 42;
+    }
+
+    void test_copy_is_allocated()
+    {
+        const unsigned long before = allocations::instance().allocated();
+        int original = 0;
+        {
+            any copy(answer);
+            any_cast<int &>(copy) = 7;
+            original = any_cast<int>(answer);
+        }
+        const unsigned long allocated = allocations::instance().allocated() - before;
+
+        check_equal(allocated, 1ul, "copy allocates a holder");
+        check_equal(original, 42, "copies are independent");
+    }
+
+    void test_move_and_assign()
+    {
+        any::static_storage<std::string> storage(std::string("static"));
+        {
+            any value(storage);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+            any moved(boost::move(value));
+            check_true(value.empty(), "moved away value");
+#else
+            any moved;
+            moved.swap(value);
+#endif
+            check_equal(any_cast<std::string>(moved), "static", "moved value");
+
+            moved = 1;
+            check_equal(any_cast<std::string>(storage.held), "static", "storage outlives the reassignment");
+        }
+        check_equal(storage.held, "static", "storage is not destroyed with the any");
+    }
+}
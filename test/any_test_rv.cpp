@@ -53,6 +53,7 @@ namespace any_tests // test suite
     void test_copy_assignment_from_value();
     void test_construction_from_const_any_rv();
     void test_cast_to_rv();
+    void test_copyable_without_move();
     
 
     const test_case test_cases[] =
@@ -67,7 +68,8 @@ namespace any_tests // test suite
         { "copy construction from value",         test_copy_construction_from_value },
         { "copy assignment from value",           test_copy_assignment_from_value },
         { "constructing from const any&&",        test_construction_from_const_any_rv },
-        { "casting to rvalue reference",          test_cast_to_rv }
+        { "casting to rvalue reference",          test_cast_to_rv },
+        { "copyable type without a move",         test_copyable_without_move }
     };
 
     const test_case_iterator begin = test_cases;
@@ -75,6 +77,21 @@ namespace any_tests // test suite
         test_cases + (sizeof test_cases / sizeof *test_cases);
 
     
+    class copy_only_class {
+    public:
+        copy_only_class() : value(7) {}
+        copy_only_class(const copy_only_class& other) : value(other.value) {}
+        copy_only_class& operator=(const copy_only_class& other) {
+            value = other.value;
+            return *this;
+        }
+
+        int value;
+
+    private:
+        BOOST_DELETED_FUNCTION(copy_only_class(copy_only_class&&))
+    };
+
     class move_copy_conting_class {
     public:
         static unsigned int moves_count;
@@ -325,7 +342,18 @@ namespace any_tests // test definitions
 */
     }
     
+
+    void test_copyable_without_move()
+    {
+        const copy_only_class value;
+        any held = value;
+        any copied = held;
+        any moved(boost::move(copied));
+
+        check_equal(any_cast<const copy_only_class&>(held).value, 7, "held value");
+        check_equal(any_cast<const copy_only_class&>(moved).value, 7, "moved any");
+        check_true(copied.empty(), "moved from any is empty");
+    }
 }
 
 #endif
-
@@ -0,0 +1,364 @@
+//  Unit test for boost::anys::any_tuple.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/any_tuple.hpp>
+#include <boost/move/move.hpp>
+
+void * operator new(std::size_t size)
+{
+    any_tests::allocations::instance().allocation();
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) BOOST_NOEXCEPT
+{
+    if (p)
+        any_tests::allocations::instance().deallocation();
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) BOOST_NOEXCEPT
+{
+    operator delete(p);
+}
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_default_ctor();
+    void test_construction();
+    void test_single_allocation();
+    void test_alignment();
+    void test_bad_get();
+    void test_copy();
+    void test_move();
+    void test_views();
+    void test_throwing_copy();
+    void test_clone_range();
+    void test_clone_range_allocations();
+    void test_clone_range_throwing_copy();
+
+    const test_case test_cases[] =
+    {
+        { "default construction",            test_default_ctor       },
+        { "construction from values",        test_construction       },
+        { "single allocation for all fields",test_single_allocation  },
+        { "per-field alignment",             test_alignment          },
+        { "get<T>() with a wrong type",      test_bad_get            },
+        { "copy construction and assignment",test_copy               },
+        { "move construction and assignment",test_move               },
+        { "per-field views",                 test_views              },
+        { "exception during copy",           test_throwing_copy      },
+        { "clone_range of any",              test_clone_range        },
+        { "clone_range allocates once",      test_clone_range_allocations },
+        { "exception during clone_range",    test_clone_range_throwing_copy }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    struct BOOST_ALIGNMENT(64) overaligned
+    {
+        char c;
+    };
+
+    struct throwing_copy
+    {
+        static int instances;
+        static int copies_before_throw;
+
+        throwing_copy() { ++instances; }
+        throwing_copy(const throwing_copy&)
+        {
+            if (!copies_before_throw--)
+                throw std::bad_alloc();
+            ++instances;
+        }
+        ~throwing_copy() { --instances; }
+    };
+
+    int throwing_copy::instances = 0;
+    int throwing_copy::copies_before_throw = 100;
+
+    // A `boost::any` made by the library, whose value `clone_range` copies
+    // into its block
+    template<typename ValueType>
+    boost::any make_any(const ValueType & value)
+    {
+        return boost::any_tuple(value)[0].to_any();
+    }
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_default_ctor()
+    {
+        const unsigned long before = allocations::instance().allocated();
+        const any_tuple value;
+        const unsigned long after = allocations::instance().allocated();
+
+        check_true(value.empty(), "empty");
+        check_equal(value.size(), 0u, "size");
+        check_equal(after, before, "no allocation");
+    }
+
+    void test_construction()
+    {
+        std::string text = "test message";
+        any_tuple value(42, text, 3.5, "literal");
+
+        check_false(value.empty(), "empty");
+        check_equal(value.size(), 4u, "size");
+        check_equal(value.type(0), typeindex::type_id<int>(), "type of field 0");
+        check_equal(value.type(1), typeindex::type_id<std::string>(), "type of field 1");
+        check_equal(value.type(2), typeindex::type_id<double>(), "type of field 2");
+        check_equal(value.type(3), typeindex::type_id<const char*>(), "type of field 3");
+
+        check_equal(value.get<int>(0), 42, "get<int>(0)");
+        check_equal(value.get<std::string>(1), text, "get<std::string>(1)");
+        check_equal(value.get<double>(2), 3.5, "get<double>(2)");
+        check_equal(std::string(value.get<const char*>(3)), "literal", "get<const char*>(3)");
+
+        value.get<int>(0) = 7;
+        const any_tuple & cref = value;
+        check_equal(cref.get<int>(0), 7, "modification through get<int>(0)");
+    }
+
+    void test_single_allocation()
+    {
+        const unsigned long before = allocations::instance().allocated();
+        any_tuple value(1, 2.0, 'c', 4L, 5u);
+        const unsigned long constructed = allocations::instance().allocated();
+        any_tuple copy(value);
+        const unsigned long copied = allocations::instance().allocated();
+
+        check_equal(constructed - before, 1u, "one allocation for five fields");
+        check_equal(copied - constructed, 1u, "one allocation for the copy");
+        check_equal(copy.get<long>(3), 4L, "copied field");
+    }
+
+    void test_alignment()
+    {
+        any_tuple value('a', overaligned(), 'b', 1.0, overaligned());
+
+        check_equal(reinterpret_cast<std::size_t>(&value.get<overaligned>(1)) % 64, 0u, "alignment of field 1");
+        check_equal(reinterpret_cast<std::size_t>(&value.get<double>(3)) % sizeof(double), 0u, "alignment of field 3");
+        check_equal(reinterpret_cast<std::size_t>(&value.get<overaligned>(4)) % 64, 0u, "alignment of field 4");
+
+        any_tuple copy(value);
+        check_equal(reinterpret_cast<std::size_t>(&copy.get<overaligned>(4)) % 64, 0u, "alignment of copied field 4");
+        check_equal(copy.get<char>(2), 'b', "copied field 2");
+    }
+
+    void test_bad_get()
+    {
+        any_tuple value(1, std::string("text"));
+
+        TEST_CHECK_THROW(
+            value.get<long>(0),
+            bad_any_cast,
+            "get<long>() of an int field");
+
+        TEST_CHECK_THROW(
+            value.get<const char*>(1),
+            bad_any_cast,
+            "get<const char*>() of a std::string field");
+    }
+
+    void test_copy()
+    {
+        any_tuple original(std::string("first"), 2), copy;
+        any_tuple * assign_result = &(copy = original);
+
+        check_equal(assign_result, &copy, "address of assignment result");
+        check_equal(copy.size(), 2u, "size of copy");
+        check_equal(copy.get<std::string>(0), "first", "copied string");
+        check_unequal(&copy.get<std::string>(0), &original.get<std::string>(0), "copies hold different objects");
+
+        copy.get<std::string>(0) = "changed";
+        check_equal(original.get<std::string>(0), "first", "original is untouched");
+    }
+
+    void test_move()
+    {
+        any_tuple original(std::string("first"), 2);
+        const std::string * address = &original.get<std::string>(0);
+        const unsigned long allocated = allocations::instance().allocated();
+
+        any_tuple moved(boost::move(original));
+        any_tuple assigned;
+        assigned = boost::move(moved);
+        const unsigned long after_move = allocations::instance().allocated();
+
+        check_equal(after_move, allocated, "no allocations on move");
+        check_true(original.empty(), "moved away value is empty");
+        check_true(moved.empty(), "moved away value is empty after assignment");
+        check_equal(&assigned.get<std::string>(0), address, "payload was not relocated");
+
+        any_tuple swapped(1);
+        swap(assigned, swapped);
+        check_equal(swapped.size(), 2u, "size after swap");
+        check_equal(assigned.get<int>(0), 1, "value after swap");
+    }
+
+    void test_views()
+    {
+        any_tuple value(42, std::string("text"));
+
+        any_view field = value[0];
+        check_false(field.empty(), "empty view");
+        check_equal(field.type(), typeindex::type_id<int>(), "type of view");
+        check_non_null(any_cast<int>(&field), "any_cast<int>(&view)");
+        check_null(any_cast<long>(&field), "any_cast<long>(&view)");
+        any_cast<int&>(field) = 43;
+        check_equal(value.get<int>(0), 43, "modification through a view");
+
+        const any_tuple & cref = value;
+        const_any_view cfield = cref[1];
+        check_equal(any_cast<const std::string&>(cfield), "text", "any_cast<const std::string&>(view)");
+        TEST_CHECK_THROW(
+            any_cast<int>(cfield),
+            bad_any_cast,
+            "any_cast<int>() of a std::string view");
+
+        const any copy = cfield.to_any();
+        check_equal(any_cast<std::string>(copy), "text", "to_any() copies the value");
+
+        check_true(any_view().empty(), "default constructed view is empty");
+        check_equal(any_view().type(), typeindex::type_id<void>(), "type of empty view");
+    }
+
+    void test_throwing_copy()
+    {
+        any_tuple original(throwing_copy(), std::string("text"), throwing_copy());
+        check_equal(throwing_copy::instances, 2, "instances after construction");
+
+        throwing_copy::copies_before_throw = 1;
+        TEST_CHECK_THROW(
+            any_tuple copy(original),
+            std::bad_alloc,
+            "copy of a field throws");
+        check_equal(throwing_copy::instances, 2, "partially copied fields are destroyed");
+    }
+
+    void test_clone_range()
+    {
+        std::vector<any> values;
+        values.push_back(1);
+        values.push_back(any());
+        values.push_back(std::string("text"));
+        values.push_back(make_any(overaligned()));
+
+        any_tuple snapshot = clone_range(values);
+        check_equal(snapshot.size(), 4u, "size");
+        check_equal(snapshot.get<int>(0), 1, "int");
+        check_equal(snapshot[0].type(), typeindex::type_id<int>(), "type of a view of an element");
+        check_equal(any_cast<int>(snapshot[0]), 1, "view of an element");
+        check_equal(any_cast<int>(snapshot[0].to_any()), 1, "copy of an element");
+        check_true(snapshot[1].empty(), "empty element");
+        check_equal(snapshot.type(1), typeindex::type_id<void>(), "type of empty element");
+        TEST_CHECK_THROW(
+            snapshot.get<int>(1),
+            bad_any_cast,
+            "get<T>() of an empty element");
+        check_equal(snapshot.get<std::string>(2), "text", "string");
+        check_equal(reinterpret_cast<std::size_t>(&snapshot.get<overaligned>(3)) % 64, 0u, "alignment");
+
+        any_cast<std::string&>(values[2]) = "changed";
+        check_equal(snapshot.get<std::string>(2), "text", "snapshot is a deep copy");
+
+        const any_tuple copy(snapshot);
+        check_true(copy[1].empty(), "copy of an empty element");
+        check_equal(copy.get<std::string>(2), "text", "copy of a snapshot");
+        check_true(clone_range(values.begin(), values.begin()).empty(), "empty range");
+    }
+
+    void test_clone_range_allocations()
+    {
+        std::vector<any> values;
+        for (int i = 0; i < 100; ++i)
+            values.push_back(i % 2 ? make_any(i) : make_any(static_cast<double>(i)));
+
+        unsigned long before = allocations::instance().allocated();
+        any_tuple snapshot = clone_range(values.begin(), values.end());
+        unsigned long allocated = allocations::instance().allocated() - before;
+
+        check_equal(allocated, 1ul, "one allocation for the whole range");
+        check_equal(snapshot.get<int>(99), 99, "last value");
+        check_equal(snapshot.get<double>(98), 98.0, "last but one value");
+
+        std::vector<any> plain;
+        for (int i = 0; i < 100; ++i)
+            plain.push_back(std::string(1, 'x'));
+
+        before = allocations::instance().allocated();
+        snapshot = clone_range(plain.begin(), plain.end());
+        allocated = allocations::instance().allocated() - before;
+
+        check_equal(allocated, 101ul, "elements made by any are cloned");
+        check_equal(snapshot.get<std::string>(99), "x", "cloned value");
+        check_equal(snapshot.type(99), typeindex::type_id<std::string>(), "type of a cloned value");
+    }
+
+    void test_clone_range_throwing_copy()
+    {
+        std::vector<any> values;
+        values.push_back(throwing_copy());
+        values.push_back(std::string("text"));
+        values.push_back(throwing_copy());
+        const int instances = throwing_copy::instances;
+
+        throwing_copy::copies_before_throw = 1;
+        TEST_CHECK_THROW(
+            clone_range(values),
+            std::bad_alloc,
+            "copy of an element throws");
+        throwing_copy::copies_before_throw = 100;
+        check_equal(throwing_copy::instances, instances, "copied elements are destroyed");
+    }
+}
+
+#endif
@@ -0,0 +1,118 @@
+//  Unit test for the type name hashes used by boost::any_cast without RTTI.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <string>
+
+#include <boost/any.hpp>
+#include "test.hpp"
+
+namespace any_tests
+{
+    struct colliding_a {};
+    struct colliding_b {};
+}
+
+// Force a hash collision, so that only the name comparison tells the types apart
+namespace boost { namespace anys { namespace detail {
+    template<>
+    struct type_hash<any_tests::colliding_a>
+    {
+        static boost::uint64_t get() BOOST_NOEXCEPT
+        {
+            return type_hash<any_tests::colliding_b>::get();
+        }
+    };
+}}}
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_distinct_hashes();
+    void test_cv_qualified_hashes();
+    void test_constexpr_hashes();
+    void test_cast_with_colliding_hashes();
+
+    const test_case test_cases[] =
+    {
+        { "distinct types have distinct hashes",   test_distinct_hashes            },
+        { "cv-qualifiers do not change the hash",  test_cv_qualified_hashes        },
+        { "hashes are compile time constants",     test_constexpr_hashes           },
+        { "any_cast with colliding hashes",        test_cast_with_colliding_hashes }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+    using boost::anys::detail::type_hash;
+
+    void test_distinct_hashes()
+    {
+        check_unequal(type_hash<int>::get(), type_hash<long>::get(), "int and long");
+        check_unequal(type_hash<int>::get(), type_hash<unsigned int>::get(), "int and unsigned int");
+        check_unequal(type_hash<std::string>::get(), type_hash<const char*>::get(), "std::string and const char*");
+        check_unequal(type_hash<int*>::get(), type_hash<int**>::get(), "int* and int**");
+    }
+
+    void test_cv_qualified_hashes()
+    {
+        check_equal(type_hash<int>::get(), type_hash<const int>::get(), "int and const int");
+        check_equal(type_hash<int>::get(), type_hash<volatile int>::get(), "int and volatile int");
+
+        const any value = 7;
+        check_non_null(any_cast<const int>(&value), "any_cast<const int>");
+        check_true(any_cast<const volatile int>(&value) != 0, "any_cast<const volatile int>");
+        check_null(any_cast<const long>(&value), "any_cast<const long>");
+    }
+
+    void test_constexpr_hashes()
+    {
+#ifndef BOOST_NO_CXX14_CONSTEXPR
+        BOOST_STATIC_ASSERT(type_hash<int>::value != type_hash<long>::value);
+        BOOST_STATIC_ASSERT(type_hash<int>::value == type_hash<const int>::value);
+#endif
+    }
+
+    void test_cast_with_colliding_hashes()
+    {
+        check_equal(type_hash<colliding_a>::get(), type_hash<colliding_b>::get(), "hashes collide");
+
+        any value = colliding_b();
+        check_null(any_cast<colliding_a>(&value), "any_cast<colliding_a> of a colliding_b");
+        check_non_null(any_cast<colliding_b>(&value), "any_cast<colliding_b> of a colliding_b");
+        TEST_CHECK_THROW(
+            any_cast<colliding_a>(value),
+            bad_any_cast,
+            "any_cast to a type with the same hash");
+
+        value = colliding_a();
+        check_non_null(any_cast<colliding_a>(&value), "any_cast<colliding_a> of a colliding_a");
+        check_null(any_cast<colliding_b>(&value), "any_cast<colliding_b> of a colliding_a");
+    }
+}
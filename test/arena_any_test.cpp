@@ -0,0 +1,265 @@
+//  Unit test for boost::anys::arena_any.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/arena_any.hpp>
+#include <boost/move/move.hpp>
+
+void * operator new(std::size_t size)
+{
+    any_tests::allocations::instance().allocation();
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+BOOST_NOINLINE void operator delete(void * p) BOOST_NOEXCEPT
+{
+    if (p)
+        any_tests::allocations::instance().deallocation();
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) BOOST_NOEXCEPT
+{
+    operator delete(p);
+}
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_default_ctor();
+    void test_values();
+    void test_copy_and_assign();
+    void test_destructors_on_reset();
+    void test_trivial_values_are_not_registered();
+    void test_allocations_per_request();
+    void test_large_value();
+    void test_to_any_after_reset();
+    void test_throwing_ctor();
+
+    const test_case test_cases[] =
+    {
+        { "default construction",                 test_default_ctor                      },
+        { "values",                               test_values                            },
+        { "copy and assignment",                  test_copy_and_assign                   },
+        { "destructors run on reset",             test_destructors_on_reset              },
+        { "trivial values have no finalizer",     test_trivial_values_are_not_registered },
+        { "allocations per request",              test_allocations_per_request           },
+        { "value larger than a block",            test_large_value                       },
+        { "to_any outlives a reset",              test_to_any_after_reset                },
+        { "constructor that throws",              test_throwing_ctor                     }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    // Records the order of destruction
+    struct tracked
+    {
+        tracked(std::vector<int> & log, int id)
+          : log(&log), id(id)
+        {
+        }
+
+        ~tracked()
+        {
+            log->push_back(id);
+        }
+
+        std::vector<int> * log;
+        int id;
+    };
+
+    struct throwing_ctor
+    {
+        throwing_ctor() {}
+        throwing_ctor(const throwing_ctor &)
+        {
+            throw std::bad_alloc();
+        }
+
+        ~throwing_ctor() {}
+    };
+
+    struct large
+    {
+        char data[10000];
+    };
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_default_ctor()
+    {
+        const arena_any value;
+
+        check_true(value.empty(), "empty");
+        check_null(value.get_arena(), "no arena");
+        check_true(value.type() == typeindex::type_id<void>(), "type");
+        check_null(any_cast<int>(&value), "any_cast");
+    }
+
+    void test_values()
+    {
+        any_arena arena;
+        arena_any number(arena, 42);
+        arena_any text(arena, std::string("text"));
+
+        check_false(number.empty(), "not empty");
+        check_equal(number.get_arena(), &arena, "arena");
+        check_equal(any_cast<int>(number), 42, "int");
+        check_equal(any_cast<const std::string &>(text), "text", "string");
+        check_null(any_cast<long>(&number), "wrong type");
+        TEST_CHECK_THROW(any_cast<double>(number), bad_any_cast, "any_cast to a wrong type");
+
+        number = std::string("replaced");
+        check_equal(any_cast<std::string>(number), "replaced", "reassigned");
+        number.clear();
+        check_true(number.empty(), "cleared");
+        number = 7;
+        check_equal(any_cast<int>(number), 7, "assigned after clear");
+    }
+
+    void test_copy_and_assign()
+    {
+        any_arena arena;
+        arena_any original(arena, std::string("value"));
+
+        arena_any copy(original);
+        check_equal(copy.get_arena(), &arena, "copy uses the same arena");
+        any_cast<std::string &>(copy) = "changed";
+        check_equal(any_cast<std::string>(original), "value", "copies are independent");
+
+        arena_any moved(boost::move(copy));
+        check_true(copy.empty(), "moved away value");
+        check_equal(any_cast<std::string>(moved), "changed", "moved value");
+
+        arena_any assigned(arena);
+        assigned = original;
+        check_equal(any_cast<std::string>(assigned), "value", "assigned value");
+        swap(assigned, moved);
+        check_equal(any_cast<std::string>(assigned), "changed", "swapped value");
+    }
+
+    void test_destructors_on_reset()
+    {
+        std::vector<int> log;
+        any_arena arena;
+        {
+            arena_any first(arena, tracked(log, 1));
+            arena_any second(arena, tracked(log, 2));
+            log.clear(); // destructors of the temporaries
+        }
+        check_true(log.empty(), "arena_any does not destroy its value");
+
+        arena.reset();
+        check_equal(log.size(), 2u, "both values destroyed");
+        check_equal(log[0], 2, "newest first");
+        check_equal(log[1], 1, "oldest last");
+        check_equal(arena.bytes_used(), 0u, "nothing used after reset");
+    }
+
+    void test_trivial_values_are_not_registered()
+    {
+        any_arena arena;
+        for (int i = 0; i < 100; ++i)
+            arena_any value(arena, i);
+
+        check_equal(arena.bytes_used(), 100 * sizeof(int), "only the values are stored");
+    }
+
+    void test_allocations_per_request()
+    {
+        any_arena arena(64 * 1024);
+        std::vector<arena_any> values;
+        values.reserve(1000);
+
+        for (int request = 0; request < 3; ++request)
+        {
+            const unsigned long before = allocations::instance().allocated();
+            for (int i = 0; i < 1000; ++i)
+                values.push_back(i % 2 ? arena_any(arena, i) : arena_any(arena, std::string(1, 'x')));
+            values.clear();
+            arena.reset();
+            const unsigned long allocated = allocations::instance().allocated() - before;
+
+            check_equal(allocated, request ? 0ul : 1ul, "one block for the first request only");
+        }
+    }
+
+    void test_large_value()
+    {
+        any_arena arena(256);
+        arena_any small(arena, 1);
+        arena_any big(arena, large());
+        arena_any after(arena, 2);
+
+        check_equal(arena.block_size(), 256u, "block size");
+        check_non_null(any_cast<large>(&big), "large value");
+        check_equal(any_cast<int>(small) + any_cast<int>(after), 3, "neighbours");
+    }
+
+    void test_to_any_after_reset()
+    {
+        any kept;
+        {
+            any_arena arena;
+            arena_any value(arena, std::string("kept"));
+            kept = value.to_any();
+        }
+        check_equal(any_cast<std::string>(kept), "kept", "value outlives the arena");
+    }
+
+    void test_throwing_ctor()
+    {
+        any_arena arena;
+        arena_any value(arena, 1);
+        const throwing_ctor source = throwing_ctor();
+        TEST_CHECK_THROW(value = source, std::bad_alloc, "assignment that throws");
+        check_equal(any_cast<int>(value), 1, "value is unchanged");
+        arena.reset(); // must not destroy the failed value
+    }
+}
+
+#endif
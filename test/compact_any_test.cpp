@@ -0,0 +1,307 @@
+//  Unit test for boost::anys::compact_any.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/compact_any.hpp>
+#include <boost/move/move.hpp>
+
+void * operator new(std::size_t size)
+{
+    any_tests::allocations::instance().allocation();
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) BOOST_NOEXCEPT
+{
+    if (p)
+        any_tests::allocations::instance().deallocation();
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) BOOST_NOEXCEPT
+{
+    operator delete(p);
+}
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_size();
+    void test_default_ctor();
+    void test_scalars();
+    void test_scalars_inline();
+    void test_doubles();
+    void test_heap_values();
+    void test_bad_cast();
+    void test_copy_move_swap();
+    void test_modification_through_cast();
+
+    const test_case test_cases[] =
+    {
+        { "one machine word",                test_size                      },
+        { "default construction",            test_default_ctor              },
+        { "scalar values",                   test_scalars                   },
+        { "scalars do not allocate",         test_scalars_inline            },
+        { "special double values",           test_doubles                   },
+        { "values held on the heap",         test_heap_values               },
+        { "failed casts",                    test_bad_cast                  },
+        { "copy, move and swap",             test_copy_move_swap            },
+        { "modification through any_cast",   test_modification_through_cast }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_size()
+    {
+        check_equal(sizeof(compact_any), sizeof(void *), "sizeof");
+    }
+
+    void test_default_ctor()
+    {
+        const compact_any value;
+
+        check_true(value.empty(), "empty");
+        check_null(any_cast<int>(&value), "any_cast<int>");
+        check_null(any_cast<double>(&value), "any_cast<double>");
+        check_equal(value.type(), typeindex::type_id<void>(), "type");
+    }
+
+    void test_scalars()
+    {
+        const compact_any i = 42, f = 1.5f, d = 2.5, b = true;
+
+        check_false(i.empty(), "empty int");
+        check_equal(i.type(), typeindex::type_id<boost::int32_t>(), "type of int");
+        check_equal(f.type(), typeindex::type_id<float>(), "type of float");
+        check_equal(d.type(), typeindex::type_id<double>(), "type of double");
+        check_equal(b.type(), typeindex::type_id<bool>(), "type of bool");
+
+        check_equal(any_cast<int>(i), 42, "int");
+        check_equal(any_cast<float>(f), 1.5f, "float");
+        check_equal(any_cast<double>(d), 2.5, "double");
+        check_equal(any_cast<bool>(b), true, "bool");
+        check_equal(any_cast<bool>(compact_any(false)), false, "false");
+        check_equal(any_cast<int>(compact_any(-1)), -1, "negative int");
+        check_equal(any_cast<const int&>(i), 42, "cast to const reference");
+    }
+
+    void test_scalars_inline()
+    {
+#ifdef BOOST_ANY_DETAIL_NAN_BOXING
+        const unsigned long before = allocations::instance().allocated();
+        {
+            compact_any values[] = { 1, 2.0f, 3.0, false, compact_any() };
+            compact_any copy = values[2];
+            copy = values[0];
+            values[4] = values[1];
+        }
+        const unsigned long after = allocations::instance().allocated();
+        check_equal(after, before, "no allocations");
+#endif
+    }
+
+    void test_doubles()
+    {
+        const double special[] = {
+            0.0, -0.0, 1e308, -1e-308,
+            std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::denorm_min()
+        };
+        for (std::size_t i = 0; i < sizeof(special) / sizeof(*special); ++i)
+        {
+            const compact_any value = special[i];
+            check_equal(value.type(), typeindex::type_id<double>(), "type of a special double");
+            check_equal(any_cast<double>(value), special[i], "special double");
+        }
+
+        const compact_any negative_zero = -0.0;
+        check_true(1.0 / any_cast<double>(negative_zero) < 0, "sign of negative zero");
+
+        const double nans[] = {
+            std::numeric_limits<double>::quiet_NaN(),
+            -std::numeric_limits<double>::quiet_NaN(),
+            std::numeric_limits<double>::signaling_NaN()
+        };
+        for (std::size_t i = 0; i < sizeof(nans) / sizeof(*nans); ++i)
+        {
+            const compact_any value = nans[i];
+            check_equal(value.type(), typeindex::type_id<double>(), "type of a NaN");
+            const double stored = any_cast<double>(value);
+            check_true(stored != stored, "NaN");
+        }
+
+        // Payloads that look like the int32_t tag, and a positive signaling NaN
+        const boost::uint64_t nan_bits[] = {
+            0xFFFD000000000001ULL,
+            0x7FF0000000000001ULL,
+            0x7FF8000000000001ULL
+        };
+        boost::uint64_t canonical = 0;
+        {
+            const double quiet = std::numeric_limits<double>::quiet_NaN();
+            const compact_any value = quiet;
+            std::memcpy(&canonical, any_cast<double>(&value), sizeof(canonical));
+        }
+        for (std::size_t i = 0; i < sizeof(nan_bits) / sizeof(*nan_bits); ++i)
+        {
+            double nan;
+            std::memcpy(&nan, &nan_bits[i], sizeof(nan));
+            const compact_any value = nan;
+            check_equal(value.type(), typeindex::type_id<double>(), "type of a NaN payload");
+            boost::uint64_t stored = 0;
+            std::memcpy(&stored, any_cast<double>(&value), sizeof(stored));
+#ifdef BOOST_ANY_DETAIL_NAN_BOXING
+            check_equal(stored, canonical, "canonical NaN");
+#else
+            check_equal(stored, nan_bits[i], "NaN on the heap");
+#endif
+        }
+
+#ifdef BOOST_ANY_DETAIL_NAN_BOXING
+        const compact_any signaling = std::numeric_limits<double>::signaling_NaN();
+        boost::uint64_t signaling_bits = 0;
+        std::memcpy(&signaling_bits, any_cast<double>(&signaling), sizeof(signaling_bits));
+        check_equal(signaling_bits, canonical, "signaling NaN is stored as the canonical NaN");
+#endif
+    }
+
+    void test_heap_values()
+    {
+        const std::string text = "test message";
+        compact_any value = text;
+
+        check_false(value.empty(), "empty");
+        check_equal(value.type(), typeindex::type_id<std::string>(), "type");
+        check_equal(any_cast<std::string>(value), text, "value");
+        check_unequal(any_cast<std::string>(&value), &text, "address");
+
+        value = 7L;
+        check_equal(value.type(), typeindex::type_id<long>(), "type of long");
+        check_equal(any_cast<long>(value), 7L, "long");
+        check_null(any_cast<int>(&value), "long is not an int");
+
+        value = std::vector<int>(3, 1);
+        check_equal(any_cast<std::vector<int>&>(value).size(), 3u, "vector");
+
+        value.clear();
+        check_true(value.empty(), "empty after clear");
+    }
+
+    void test_bad_cast()
+    {
+        const compact_any i = 1, d = 1.0, s = std::string("text");
+
+        check_null(any_cast<float>(&i), "int as float");
+        check_null(any_cast<double>(&i), "int as double");
+        check_null(any_cast<bool>(&i), "int as bool");
+        check_null(any_cast<int>(&d), "double as int");
+        check_null(any_cast<std::string>(&d), "double as std::string");
+        check_null(any_cast<double>(&s), "std::string as double");
+        check_null(any_cast<int>(&s), "std::string as int");
+
+        TEST_CHECK_THROW(
+            any_cast<float>(i),
+            bad_any_cast,
+            "any_cast to incorrect scalar type");
+
+        TEST_CHECK_THROW(
+            any_cast<const char *>(s),
+            bad_any_cast,
+            "any_cast to incorrect type");
+    }
+
+    void test_copy_move_swap()
+    {
+        compact_any original = std::string("text"), scalar = 3.5;
+
+        compact_any copy = original;
+        check_equal(any_cast<std::string>(copy), "text", "copy");
+        check_unequal(any_cast<std::string>(&copy), any_cast<std::string>(&original), "copies hold different objects");
+
+        const std::string * address = any_cast<std::string>(&original);
+        compact_any moved(boost::move(original));
+        check_true(original.empty(), "moved away value is empty");
+        check_equal(any_cast<std::string>(&moved), address, "moved value is not copied");
+
+        moved.swap(scalar);
+        check_equal(any_cast<double>(moved), 3.5, "swapped scalar");
+        check_equal(any_cast<std::string>(&scalar), address, "swapped heap value");
+
+        compact_any assigned;
+        assigned = boost::move(scalar);
+        check_true(scalar.empty(), "moved away value is empty after assignment");
+        check_equal(any_cast<std::string>(&assigned), address, "move assigned value is not copied");
+
+        assigned = moved;
+        check_equal(any_cast<double>(assigned), 3.5, "copy assigned scalar");
+    }
+
+    void test_modification_through_cast()
+    {
+        compact_any i = 1, f = 1.0f, d = 1.0, b = false;
+
+        ++any_cast<int&>(i);
+        *any_cast<float>(&f) += 1.0f;
+        any_cast<double&>(d) = -3.0;
+        any_cast<bool&>(b) = true;
+
+        check_equal(i.type(), typeindex::type_id<int>(), "type of int after modification");
+        check_equal(any_cast<int>(i), 2, "int after modification");
+        check_equal(f.type(), typeindex::type_id<float>(), "type of float after modification");
+        check_equal(any_cast<float>(f), 2.0f, "float after modification");
+        check_equal(any_cast<double>(d), -3.0, "double after modification");
+        check_equal(b.type(), typeindex::type_id<bool>(), "type of bool after modification");
+        check_equal(any_cast<bool>(b), true, "bool after modification");
+    }
+}
+
+#endif
@@ -0,0 +1,227 @@
+//  Unit test for boost::anys::concurrent_any_map.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_SMART_PTR) \
+    || defined(BOOST_NO_CXX11_HDR_MUTEX) || defined(BOOST_NO_CXX11_HDR_THREAD) \
+    || defined(BOOST_NO_CXX11_HDR_ATOMIC) || defined(BOOST_NO_CXX11_LAMBDAS)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/concurrent_any_map.hpp>
+#include <atomic>
+#include <thread>
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_empty_map();
+    void test_insert_and_find();
+    void test_insert_or_assign();
+    void test_snapshot_outlives_assignment();
+    void test_string_view_lookup();
+    void test_erase_and_clear();
+    void test_many_keys();
+    void test_concurrent_readers_and_writers();
+
+    const test_case test_cases[] =
+    {
+        { "empty map",                            test_empty_map                      },
+        { "insert and find",                      test_insert_and_find                },
+        { "insert_or_assign",                     test_insert_or_assign               },
+        { "snapshot outlives assignment",         test_snapshot_outlives_assignment   },
+        { "lookup by string_view",                test_string_view_lookup             },
+        { "erase and clear",                      test_erase_and_clear                },
+        { "many keys",                            test_many_keys                      },
+        { "concurrent readers and writers",       test_concurrent_readers_and_writers }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_empty_map()
+    {
+        const concurrent_any_map map(5);
+
+        check_equal(map.shard_count(), 8u, "shard count");
+        check_true(map.empty(), "empty");
+        check_equal(map.size(), 0u, "size");
+        check_false(map.contains("key"), "contains");
+        check_true(!map.find("key"), "find");
+    }
+
+    void test_insert_and_find()
+    {
+        concurrent_any_map map;
+
+        check_true(map.insert("int", 42), "insert int");
+        check_true(map.insert("string", std::string("text")), "insert string");
+        check_false(map.insert("int", 7), "insert existing key");
+        check_equal(map.size(), 2u, "size");
+
+        const concurrent_any_map::snapshot value = map.find("int");
+        check_true(!!value, "find int");
+        check_equal(any_cast<int>(*value), 42, "value of existing key is kept");
+        check_equal(any_cast<std::string>(*map.find("string")), "text", "string value");
+        check_true(map.contains("string"), "contains");
+    }
+
+    void test_insert_or_assign()
+    {
+        concurrent_any_map map;
+
+        check_true(map.insert_or_assign("key", 1), "insert");
+        check_false(map.insert_or_assign("key", std::string("two")), "assign");
+        check_equal(any_cast<std::string>(*map.find("key")), "two", "assigned value");
+
+        any value = 3.0;
+        check_false(map.insert_or_assign("key", value), "assign any");
+        check_equal(any_cast<double>(*map.find("key")), 3.0, "assigned any");
+        check_equal(map.size(), 1u, "size");
+    }
+
+    void test_snapshot_outlives_assignment()
+    {
+        concurrent_any_map map;
+        map.insert_or_assign("key", std::string("old"));
+
+        const concurrent_any_map::snapshot old_value = map.find("key");
+        map.insert_or_assign("key", std::string("new"));
+        check_equal(any_cast<std::string>(*old_value), "old", "snapshot after assignment");
+        check_equal(any_cast<std::string>(*map.find("key")), "new", "new value");
+
+        map.erase("key");
+        check_equal(any_cast<std::string>(*old_value), "old", "snapshot after erase");
+        check_equal(old_value.use_count(), 1l, "snapshot is the last owner");
+    }
+
+    void test_string_view_lookup()
+    {
+        concurrent_any_map map;
+        map.insert(std::string("alpha"), 1);
+
+        const char text[] = "alphabet";
+        check_true(!!map.find(string_view(text, 5)), "prefix of a longer string");
+        check_false(map.contains(string_view(text, 4)), "shorter prefix");
+        check_false(map.contains(string_view(text)), "whole string");
+
+        // Embedded zeros are part of the key
+        map.insert(string_view("a\0b", 3), 2);
+        check_false(map.contains("a"), "key up to the zero");
+        check_equal(any_cast<int>(*map.find(string_view("a\0b", 3))), 2, "key with zero");
+    }
+
+    void test_erase_and_clear()
+    {
+        concurrent_any_map map;
+        map.insert("a", 1);
+        map.insert("b", 2);
+
+        check_true(map.erase("a"), "erase existing key");
+        check_false(map.erase("a"), "erase missing key");
+        check_false(map.contains("a"), "erased key");
+        check_equal(map.size(), 1u, "size after erase");
+
+        map.clear();
+        check_true(map.empty(), "empty after clear");
+        check_true(map.insert("b", 3), "insert after clear");
+    }
+
+    void test_many_keys()
+    {
+        concurrent_any_map map(4);
+        for (int i = 0; i < 2000; ++i)
+            map.insert("key" + std::to_string(i), i);
+
+        check_equal(map.size(), 2000u, "size");
+        bool all_found = true;
+        for (int i = 0; i < 2000; ++i)
+        {
+            const concurrent_any_map::snapshot value = map.find("key" + std::to_string(i));
+            all_found = all_found && value && any_cast<int>(*value) == i;
+        }
+        check_true(all_found, "all keys are found after rehashing");
+    }
+
+    void test_concurrent_readers_and_writers()
+    {
+        const int keys = 64, writes = 5000;
+        concurrent_any_map map;
+        for (int k = 0; k < keys; ++k)
+            map.insert("key" + std::to_string(k), std::vector<int>(4, 0));
+
+        std::atomic<bool> inconsistent(false);
+        std::atomic<int> writers_left(2);
+        std::vector<std::thread> threads;
+        for (int w = 0; w < 2; ++w)
+        {
+            threads.push_back(std::thread([&, w]() {
+                for (int i = 1; i <= writes; ++i)
+                {
+                    const int k = (i * 7 + w) % keys;
+                    map.insert_or_assign("key" + std::to_string(k), std::vector<int>(4, i));
+                }
+                --writers_left;
+            }));
+        }
+        for (int r = 0; r < 4; ++r)
+        {
+            threads.push_back(std::thread([&, r]() {
+                int k = r;
+                while (writers_left.load())
+                {
+                    const concurrent_any_map::snapshot value = map.find("key" + std::to_string(k));
+                    const std::vector<int> & v = any_cast<const std::vector<int>&>(*value);
+                    if (v.size() != 4 || v[0] != v[3])
+                        inconsistent = true;
+                    k = (k + 1) % keys;
+                }
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+
+        check_false(inconsistent.load(), "readers see whole values");
+        check_equal(map.size(), static_cast<std::size_t>(keys), "size");
+    }
+}
+
+#endif
@@ -0,0 +1,336 @@
+//  Unit test for boost::anys::hybrid_any.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) \
+    || defined(BOOST_NO_CXX11_CONSTEXPR)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/hybrid_any.hpp>
+
+void * operator new(std::size_t size)
+{
+    any_tests::allocations::instance().allocation();
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+BOOST_NOINLINE void operator delete(void * p) BOOST_NOEXCEPT
+{
+    if (p)
+        any_tests::allocations::instance().deallocation();
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) BOOST_NOEXCEPT
+{
+    operator delete(p);
+}
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_default_ctor();
+    void test_hot_values();
+    void test_hot_values_inline();
+    void test_fallback_values();
+    void test_from_any();
+    void test_bad_cast();
+    void test_copy_move_swap();
+    void test_throwing_copy();
+    void test_visit();
+    void test_to_any();
+
+    const test_case test_cases[] =
+    {
+        { "default construction",            test_default_ctor       },
+        { "values of hot types",             test_hot_values         },
+        { "hot types do not allocate",       test_hot_values_inline  },
+        { "values of other types",           test_fallback_values    },
+        { "construction from boost::any",    test_from_any           },
+        { "failed casts",                    test_bad_cast           },
+        { "copy, move and swap",             test_copy_move_swap     },
+        { "copy constructor that throws",    test_throwing_copy      },
+        { "visitation",                      test_visit              },
+        { "conversion to boost::any",        test_to_any             }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    struct point
+    {
+        int x, y;
+    };
+
+    struct throwing_copy
+    {
+        throwing_copy() {}
+        throwing_copy(const throwing_copy &)
+        {
+            throw std::bad_alloc();
+        }
+
+        ~throwing_copy() {}
+    };
+
+    typedef boost::hybrid_any<int, double, bool, const char *, point> hot_any;
+
+    // Counts the calls for each kind of value
+    struct counting_visitor
+    {
+        counting_visitor()
+          : ints(0), points(0), others(0)
+        {
+        }
+
+        void operator()(int & value) { ++ints; value += 1; }
+        void operator()(const int &) { ++ints; }
+        void operator()(const point &) { ++points; }
+        template<typename ValueType>
+        void operator()(const ValueType &) { ++others; }
+
+        int ints, points, others;
+    };
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_default_ctor()
+    {
+        const hot_any value;
+
+        check_true(value.empty(), "empty");
+        check_equal(value.which(), 0u, "which");
+        check_null(any_cast<int>(&value), "any_cast<int>");
+        check_null(any_cast<std::string>(&value), "any_cast<std::string>");
+        check_equal(value.type(), typeindex::type_id<void>(), "type");
+    }
+
+    void test_hot_values()
+    {
+        const point origin = { 1, 2 };
+        const hot_any i = 42, d = 2.5, b = true, s = "text", p = origin;
+
+        check_false(i.empty(), "empty int");
+        check_equal(i.which(), 1u, "which of int");
+        check_equal(s.which(), 4u, "which of const char *");
+        check_equal(p.which(), 5u, "which of point");
+        check_equal(i.type(), typeindex::type_id<int>(), "type of int");
+        check_equal(d.type(), typeindex::type_id<double>(), "type of double");
+        check_equal(b.type(), typeindex::type_id<bool>(), "type of bool");
+        check_equal(p.type(), typeindex::type_id<point>(), "type of point");
+
+        check_equal(any_cast<int>(i), 42, "int");
+        check_equal(any_cast<double>(d), 2.5, "double");
+        check_equal(any_cast<bool>(b), true, "bool");
+        check_equal(std::string(any_cast<const char *>(s)), "text", "const char *");
+        check_equal(any_cast<const point &>(p).y, 2, "point");
+        check_equal(any_cast<int>(hot_any(-1)), -1, "cast of a temporary");
+
+        hot_any value = 1;
+        ++any_cast<int&>(value);
+        check_equal(any_cast<int>(value), 2, "modification through any_cast");
+    }
+
+    void test_hot_values_inline()
+    {
+        const point origin = { 0, 0 };
+        const unsigned long before = allocations::instance().allocated();
+        {
+            hot_any values[] = { 1, 2.0, false, "text", origin, hot_any() };
+            hot_any copy = values[1];
+            copy = values[0];
+            values[5] = static_cast<hot_any&&>(copy);
+            values[4].swap(values[3]);
+        }
+        const unsigned long after = allocations::instance().allocated();
+        check_equal(after, before, "no allocations");
+    }
+
+    void test_fallback_values()
+    {
+        const std::string text = "test message";
+        hot_any value = text;
+
+        check_false(value.empty(), "empty");
+        check_equal(value.which(), static_cast<unsigned>(hot_any::fallback_index), "which");
+        check_equal(value.type(), typeindex::type_id<std::string>(), "type");
+        check_equal(any_cast<std::string>(value), text, "value");
+        check_unequal(any_cast<std::string>(&value), &text, "address");
+
+        value = 7L;
+        check_equal(value.type(), typeindex::type_id<long>(), "type of long");
+        check_equal(any_cast<long>(value), 7L, "long");
+        check_null(any_cast<int>(&value), "long is not an int");
+
+        value = std::vector<int>(3, 1);
+        check_equal(any_cast<std::vector<int>&>(value).size(), 3u, "vector");
+
+        value = 5;
+        check_equal(value.which(), 1u, "hot type after a fallback one");
+
+        value.clear();
+        check_true(value.empty(), "empty after clear");
+    }
+
+    void test_from_any()
+    {
+        const boost::any hot = 3, cold = std::string("text"), nothing;
+
+        const hot_any i = hot;
+        check_equal(i.which(), 1u, "hot type is unwrapped");
+        check_equal(any_cast<int>(i), 3, "unwrapped value");
+
+        const hot_any s = cold;
+        check_equal(s.which(), static_cast<unsigned>(hot_any::fallback_index), "other type is not unwrapped");
+        check_equal(any_cast<std::string>(s), "text", "value of other type");
+
+        const hot_any e = nothing;
+        check_true(e.empty(), "empty any");
+
+        boost::any source = 2.5;
+        const hot_any moved = static_cast<boost::any&&>(source);
+        check_equal(any_cast<double>(moved), 2.5, "moved hot value");
+    }
+
+    void test_bad_cast()
+    {
+        const hot_any i = 1, d = 1.0, s = std::string("text");
+
+        check_null(any_cast<double>(&i), "int as double");
+        check_null(any_cast<bool>(&i), "int as bool");
+        check_null(any_cast<long>(&i), "int as long");
+        check_null(any_cast<int>(&d), "double as int");
+        check_null(any_cast<std::string>(&d), "double as std::string");
+        check_null(any_cast<int>(&s), "std::string as int");
+        check_null(any_cast<long>(&s), "std::string as long");
+
+        TEST_CHECK_THROW(
+            any_cast<bool>(i),
+            bad_any_cast,
+            "any_cast to incorrect hot type");
+
+        TEST_CHECK_THROW(
+            any_cast<std::vector<int> >(s),
+            bad_any_cast,
+            "any_cast to incorrect type");
+    }
+
+    void test_copy_move_swap()
+    {
+        hot_any original = std::string("text"), scalar = 3.5;
+
+        hot_any copy = original;
+        check_equal(any_cast<std::string>(copy), "text", "copy");
+        check_unequal(any_cast<std::string>(&copy), any_cast<std::string>(&original), "copies hold different objects");
+
+        const std::string * const address = any_cast<std::string>(&original);
+        hot_any moved(static_cast<hot_any&&>(original));
+        check_true(original.empty(), "moved away value is empty");
+        check_equal(any_cast<std::string>(&moved), address, "moved value is not copied");
+
+        moved.swap(scalar);
+        check_equal(any_cast<double>(moved), 3.5, "swapped hot value");
+        check_equal(any_cast<std::string>(scalar), "text", "swapped other value");
+
+        hot_any assigned;
+        assigned = static_cast<hot_any&&>(scalar);
+        check_true(scalar.empty(), "moved away value is empty after assignment");
+        check_equal(any_cast<std::string>(assigned), "text", "move assigned value");
+
+        assigned = moved;
+        check_equal(any_cast<double>(assigned), 3.5, "copy assigned hot value");
+
+        swap(assigned, copy);
+        check_equal(any_cast<std::string>(assigned), "text", "free swap");
+        check_equal(any_cast<double>(copy), 3.5, "free swap of hot value");
+    }
+
+    void test_throwing_copy()
+    {
+        typedef hybrid_any<int, throwing_copy> throwing_any;
+
+        throwing_any value = 1;
+
+        const throwing_copy original;
+        TEST_CHECK_THROW(
+            value = original,
+            std::bad_alloc,
+            "throwing copy of a hot type");
+        check_equal(any_cast<int>(value), 1, "value is kept");
+
+        TEST_CHECK_THROW(
+            hot_any(static_cast<const throwing_copy &>(original)),
+            std::bad_alloc,
+            "throwing copy of other type");
+    }
+
+    void test_visit()
+    {
+        const point origin = { 0, 0 };
+        hot_any values[] = { 1, 2.0, origin, std::string("text"), hot_any() };
+
+        counting_visitor visitor;
+        for (std::size_t i = 0; i < sizeof(values) / sizeof(*values); ++i)
+            values[i].visit(visitor);
+
+        check_equal(visitor.ints, 1, "ints");
+        check_equal(visitor.points, 1, "points");
+        check_equal(visitor.others, 2, "double and boost::any");
+        check_equal(any_cast<int>(values[0]), 2, "modification through visitation");
+
+        const hot_any constant = 1;
+        constant.visit(visitor);
+        check_equal(visitor.ints, 2, "const visitation");
+    }
+
+    void test_to_any()
+    {
+        const hot_any i = 4, s = std::string("text"), e;
+
+        check_equal(boost::any_cast<int>(i.to_any()), 4, "hot value");
+        check_equal(boost::any_cast<std::string>(s.to_any()), "text", "other value");
+        check_true(e.to_any().empty(), "empty");
+    }
+}
+
+#endif
@@ -0,0 +1,244 @@
+//  Unit test for boost::anys::interned_any.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_HDR_ATOMIC) \
+    || defined(BOOST_NO_CXX11_HDR_MUTEX) || defined(BOOST_NO_CXX11_HDR_THREAD) \
+    || defined(BOOST_NO_CXX11_LAMBDAS)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/interned_any.hpp>
+#include <boost/move/move.hpp>
+#include <atomic>
+#include <thread>
+
+// The allocation counter of test.hpp is not thread safe
+static std::atomic<unsigned long> heap_allocations(0);
+
+void * operator new(std::size_t size)
+{
+    ++heap_allocations;
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+BOOST_NOINLINE void operator delete(void * p) BOOST_NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) BOOST_NOEXCEPT
+{
+    operator delete(p);
+}
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    boost::interned_any::table_size(); // creates the table
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_default_ctor();
+    void test_equal_values_share_a_holder();
+    void test_types_are_distinct();
+    void test_copies_do_not_allocate();
+    void test_holder_is_released();
+    void test_deduplication();
+    void test_any_cast();
+    void test_concurrent_interning();
+
+    const test_case test_cases[] =
+    {
+        { "default construction",                 test_default_ctor                 },
+        { "equal values share a holder",          test_equal_values_share_a_holder  },
+        { "types are distinct",                   test_types_are_distinct           },
+        { "copies do not allocate",               test_copies_do_not_allocate       },
+        { "holder is released",                   test_holder_is_released           },
+        { "deduplication",                        test_deduplication                },
+        { "any_cast",                             test_any_cast                     },
+        { "concurrent interning",                 test_concurrent_interning         }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_default_ctor()
+    {
+        const interned_any value;
+
+        check_true(value.empty(), "empty");
+        check_equal(value.use_count(), 0u, "use_count");
+        check_true(value.type() == typeindex::type_id<void>(), "type");
+        check_true(value == interned_any(), "empty values are equal");
+    }
+
+    void test_equal_values_share_a_holder()
+    {
+        const std::size_t before = interned_any::table_size();
+        const interned_any a(std::string("shared"));
+        const interned_any b(std::string("shared"));
+        const interned_any c(std::string("other"));
+
+        check_true(a == b, "equal values");
+        check_true(a != c, "different values");
+        check_equal(a.use_count(), 2u, "use_count");
+        check_equal(any_cast<std::string>(a), "shared", "value");
+        check_equal(any_cast<std::string>(&a), any_cast<std::string>(&b), "same address");
+        check_equal(interned_any::table_size() - before, 2u, "two distinct values");
+        check_equal(hash_value(a), hash_value(b), "hash_value");
+    }
+
+    void test_types_are_distinct()
+    {
+        const interned_any i(1), l(1l);
+        const interned_any pair(std::make_pair(1, std::string("one")));
+        const interned_any same_pair(std::make_pair(1, std::string("one")));
+
+        check_true(i != l, "int and long");
+        check_true(pair == same_pair, "pairs");
+        check_equal(any_cast<std::pair<int, std::string> >(pair).second, "one", "pair value");
+    }
+
+    void test_copies_do_not_allocate()
+    {
+        const interned_any original(std::string("a fairly long string that does not fit into SSO"));
+        std::vector<interned_any> copies;
+        copies.reserve(1000);
+
+        const unsigned long before = heap_allocations;
+        for (int i = 0; i < 1000; ++i)
+            copies.push_back(original);
+        const unsigned long allocated = heap_allocations - before;
+
+        check_equal(allocated, 0ul, "copies only touch the reference count");
+        check_equal(original.use_count(), 1001u, "use_count");
+    }
+
+    void test_holder_is_released()
+    {
+        const std::size_t before = interned_any::table_size();
+        {
+            interned_any a(std::string("released"));
+            interned_any b(a);
+            interned_any c(boost::move(a));
+            check_true(a.empty(), "moved away value");
+            check_equal(interned_any::table_size() - before, 1u, "holder while referenced");
+            b.clear();
+        }
+        check_equal(interned_any::table_size(), before, "holder removed with the last reference");
+    }
+
+    void test_deduplication()
+    {
+        std::vector<std::string> names;
+        for (int i = 0; i < 100; ++i)
+            names.push_back("a long value that is stored many times #" + std::to_string(i));
+
+        const std::size_t before_size = interned_any::table_size();
+        std::vector<interned_any> values;
+        values.reserve(100000);
+        for (int i = 0; i < 100; ++i)
+            values.push_back(interned_any(names[static_cast<std::size_t>(i)]));
+
+        const unsigned long before = heap_allocations;
+        for (int i = 100; i < 100000; ++i)
+            values.push_back(interned_any(names[static_cast<std::size_t>(i % 100)]));
+        const unsigned long allocated = heap_allocations - before;
+
+        check_equal(interned_any::table_size() - before_size, 100u, "one holder per distinct value");
+        check_equal(allocated, 0ul, "interning a known value does not allocate");
+        check_true(values[7] == values[99907], "equal values compare equal");
+    }
+
+    void test_any_cast()
+    {
+        const interned_any value(42);
+
+        check_equal(any_cast<int>(value), 42, "any_cast");
+        check_equal(*any_cast<int>(&value), 42, "any_cast to a pointer");
+        check_null(any_cast<long>(&value), "wrong type");
+        TEST_CHECK_THROW(any_cast<double>(value), bad_any_cast, "any_cast to a wrong type");
+        check_equal(boost::any_cast<int>(value.to_any()), 42, "to_any");
+    }
+
+    void test_concurrent_interning()
+    {
+        const std::size_t before = interned_any::table_size();
+        const int threads_count = 4, values_count = 50, rounds = 2000;
+        std::vector<std::vector<interned_any> > results(threads_count);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threads_count; ++t)
+        {
+            threads.push_back(std::thread([&results, t]() {
+                std::vector<interned_any> & out = results[static_cast<std::size_t>(t)];
+                for (int i = 0; i < rounds; ++i)
+                {
+                    // Values are released and interned again concurrently
+                    const interned_any value(std::to_string((i + t) % values_count));
+                    if (i < values_count)
+                        out.push_back(value);
+                }
+            }));
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+
+        check_equal(interned_any::table_size() - before, static_cast<std::size_t>(values_count), "one holder per value");
+        bool shared = true;
+        for (int t = 1; t < threads_count; ++t)
+        {
+            for (int i = 0; i < values_count; ++i)
+            {
+                const std::size_t j = static_cast<std::size_t>((i + t) % values_count);
+                shared = shared && results[static_cast<std::size_t>(t)][static_cast<std::size_t>(i)] == results[0][j];
+            }
+        }
+        check_true(shared, "threads share the holders");
+
+        results.clear();
+        check_equal(interned_any::table_size(), before, "all holders are released");
+    }
+}
+
+#endif
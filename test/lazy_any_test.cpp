@@ -0,0 +1,276 @@
+//  Unit test for boost::anys::lazy_any.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_CXX11_DECLTYPE) \
+    || defined(BOOST_NO_CXX11_HDR_ATOMIC) || defined(BOOST_NO_CXX11_HDR_MUTEX) \
+    || defined(BOOST_NO_CXX11_HDR_THREAD) || defined(BOOST_NO_CXX11_LAMBDAS)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/lazy_any.hpp>
+#include <boost/move/move.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_default_ctor();
+    void test_type_without_building();
+    void test_built_once();
+    void test_bad_cast_does_not_build();
+    void test_copy();
+    void test_move();
+    void test_throwing_factory();
+    void test_concurrent_casts();
+    void test_copy_while_building();
+
+    const test_case test_cases[] =
+    {
+        { "default construction",              test_default_ctor             },
+        { "type() does not build the value",   test_type_without_building    },
+        { "value is built once",               test_built_once               },
+        { "failed cast does not build",        test_bad_cast_does_not_build  },
+        { "copy before and after building",    test_copy                     },
+        { "move construction and assignment",  test_move                     },
+        { "factory that throws",               test_throwing_factory         },
+        { "concurrent first casts",            test_concurrent_casts         },
+        { "copy while the value is built",     test_copy_while_building      }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    struct counting_factory
+    {
+        int * calls;
+
+        std::string operator()() const
+        {
+            ++*calls;
+            return "built";
+        }
+    };
+
+    // Changes its state while it builds the value
+    struct stateful_factory
+    {
+        int builds;
+
+        std::string operator()()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            ++builds;
+            return std::string(static_cast<std::size_t>(builds), '!');
+        }
+    };
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_default_ctor()
+    {
+        const lazy_any value;
+
+        check_true(value.empty(), "empty");
+        check_false(value.materialized(), "materialized");
+        check_null(any_cast<int>(&value), "any_cast<int>");
+        check_equal(value.type(), typeindex::type_id<void>(), "type");
+    }
+
+    void test_type_without_building()
+    {
+        int calls = 0;
+        const counting_factory factory = { &calls };
+        const lazy_any value(factory);
+
+        check_false(value.empty(), "empty");
+        check_equal(value.type(), typeindex::type_id<std::string>(), "type");
+        check_false(value.materialized(), "materialized");
+        check_equal(calls, 0, "factory calls");
+    }
+
+    void test_built_once()
+    {
+        int calls = 0;
+        const counting_factory factory = { &calls };
+        lazy_any value = make_lazy_any(factory);
+
+        check_equal(any_cast<std::string>(value), "built", "value");
+        check_true(value.materialized(), "materialized");
+        check_equal(*any_cast<std::string>(&value), "built", "value through a pointer");
+        any_cast<std::string&>(value) += "!";
+        check_equal(any_cast<const std::string&>(value), "built!", "value after modification");
+        check_equal(calls, 1, "factory calls");
+    }
+
+    void test_bad_cast_does_not_build()
+    {
+        int calls = 0;
+        const counting_factory factory = { &calls };
+        lazy_any value(factory);
+
+        check_null(any_cast<int>(&value), "any_cast<int>");
+        TEST_CHECK_THROW(
+            any_cast<const char *>(value),
+            bad_any_cast,
+            "any_cast to incorrect type");
+        check_false(value.materialized(), "materialized");
+        check_equal(calls, 0, "factory calls");
+    }
+
+    void test_copy()
+    {
+        int calls = 0;
+        const counting_factory factory = { &calls };
+        lazy_any original(factory);
+
+        lazy_any lazy_copy(original);
+        check_false(lazy_copy.materialized(), "copy of an unbuilt value is not built");
+        check_equal(calls, 0, "factory calls after the first copy");
+
+        any_cast<std::string&>(original) = "changed";
+        lazy_any built_copy;
+        built_copy = original;
+        check_true(built_copy.materialized(), "copy of a built value is built");
+        check_equal(any_cast<std::string>(built_copy), "changed", "copied value");
+        check_unequal(any_cast<std::string>(&built_copy), any_cast<std::string>(&original), "copies hold different objects");
+        check_equal(calls, 1, "factory calls after the second copy");
+
+        check_equal(any_cast<std::string>(lazy_copy), "built", "value of the first copy");
+        check_equal(calls, 2, "factory calls after building the first copy");
+    }
+
+    void test_move()
+    {
+        lazy_any original([]() { return std::vector<int>(3, 7); });
+        const std::vector<int> * address = any_cast<std::vector<int> >(&original);
+
+        lazy_any moved(boost::move(original));
+        check_true(original.empty(), "moved away value is empty");
+        check_equal(any_cast<std::vector<int> >(&moved), address, "value was not rebuilt");
+
+        lazy_any assigned;
+        assigned = boost::move(moved);
+        check_true(moved.empty(), "moved away value is empty after assignment");
+        check_equal(any_cast<std::vector<int> >(&assigned), address, "value was not rebuilt by assignment");
+        check_equal(any_cast<std::vector<int> >(boost::move(assigned)).size(), 3u, "any_cast of rvalue");
+    }
+
+    void test_throwing_factory()
+    {
+        int calls = 0;
+        lazy_any value([&calls]() -> int {
+            if (!calls++)
+                throw std::runtime_error("first call fails");
+            return 42;
+        });
+
+        TEST_CHECK_THROW(
+            any_cast<int>(value),
+            std::runtime_error,
+            "exception from the factory");
+        check_false(value.materialized(), "materialized after a failure");
+        check_equal(any_cast<int>(value), 42, "value after a retry");
+        check_equal(calls, 2, "factory calls");
+    }
+
+    void test_concurrent_casts()
+    {
+        std::atomic<int> calls(0);
+        const lazy_any value([&calls]() {
+            ++calls;
+            return std::string(1000, 'x');
+        });
+
+        std::atomic<bool> start(false);
+        std::vector<const std::string *> seen(8);
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < seen.size(); ++i)
+        {
+            threads.push_back(std::thread([&, i]() {
+                while (!start.load())
+                    std::this_thread::yield();
+                seen[i] = any_cast<std::string>(&value);
+            }));
+        }
+        start = true;
+        for (std::size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+
+        check_equal(calls.load(), 1, "factory calls");
+        for (std::size_t i = 0; i < seen.size(); ++i)
+        {
+            check_equal(seen[i], seen[0], "all threads see the same object");
+        }
+        check_equal(seen[0]->size(), 1000u, "value");
+    }
+
+    void test_copy_while_building()
+    {
+        const stateful_factory factory = { 0 };
+        const lazy_any value(factory);
+
+        std::atomic<bool> started(false);
+        std::thread builder([&]() {
+            started = true;
+            any_cast<std::string>(&value);
+        });
+        while (!started.load())
+            std::this_thread::yield();
+
+        // Either a copy of the unused factory or of the built value
+        std::vector<lazy_any> copies;
+        do
+        {
+            copies.push_back(value);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        } while (!copies.back().materialized() && copies.size() < 1000);
+        builder.join();
+
+        for (std::size_t i = 0; i < copies.size(); ++i)
+        {
+            check_equal(any_cast<std::string>(copies[i]), "!", "value of a copy");
+        }
+    }
+}
+
+#endif
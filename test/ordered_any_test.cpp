@@ -0,0 +1,246 @@
+//  Unit test for boost::anys::ordered_any and boost::anys::any_less.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <string>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/ordered_any.hpp>
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_default_ctor();
+    void test_same_type();
+    void test_different_types();
+    void test_empty_first();
+    void test_copy_and_move();
+    void test_sort();
+    void test_set();
+    void test_binary_search();
+    void test_any_cast();
+
+    const test_case test_cases[] =
+    {
+        { "default construction",                 test_default_ctor     },
+        { "values of the same type",              test_same_type        },
+        { "values of different types",            test_different_types  },
+        { "empty values come first",              test_empty_first      },
+        { "copies and moves keep the order",      test_copy_and_move    },
+        { "std::sort",                            test_sort             },
+        { "std::set",                             test_set              },
+        { "binary search",                        test_binary_search    },
+        { "any_cast",                             test_any_cast         }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    // Only has operator<
+    struct version
+    {
+        int major, minor;
+
+        friend bool operator<(const version & lhs, const version & rhs)
+        {
+            return lhs.major < rhs.major || (lhs.major == rhs.major && lhs.minor < rhs.minor);
+        }
+    };
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_default_ctor()
+    {
+        const ordered_any value;
+
+        check_true(value.empty(), "empty");
+        check_true(value.get().empty(), "empty any");
+        check_equal(any_compare(value, ordered_any()), 0, "equal to another empty value");
+    }
+
+    void test_same_type()
+    {
+        const ordered_any one = 1, two = 2, other_one = 1;
+
+        check_true(any_compare(one, two) < 0, "1 < 2");
+        check_true(any_compare(two, one) > 0, "2 > 1");
+        check_equal(any_compare(one, other_one), 0, "1 == 1");
+        check_true(one < two && two > one && one <= other_one && one >= other_one, "operators");
+        check_true(one == other_one && one != two, "equality");
+
+        const ordered_any a = std::string("a"), b = std::string("b");
+        check_true(any_less()(a, b) && !any_less()(b, a), "strings");
+
+        const version v1 = { 1, 2 }, v2 = { 1, 10 };
+        check_true(ordered_any(v1) < ordered_any(v2), "type with only operator<");
+        check_true(ordered_any(v1) == ordered_any(v1), "equivalent values of such a type");
+    }
+
+    void test_different_types()
+    {
+        const ordered_any number = 1, text = std::string("1"), real = 1.0;
+
+        check_unequal(any_compare(number, text), 0, "int and std::string");
+        check_equal(any_compare(number, text), -any_compare(text, number), "antisymmetric");
+        check_true(number != real, "int and double are not equal");
+
+        // The order of the types does not depend on the values
+        const ordered_any big = 1000, long_text = std::string("zzz");
+        check_equal(any_compare(number, text) < 0, any_compare(big, long_text) < 0, "order of the types");
+        check_equal(any_compare(number, long_text) < 0, any_compare(big, text) < 0, "order of the types");
+
+        // Transitive across three types
+        const bool nt = number < text, tr = text < real, nr = number < real;
+        check_true(!(nt && tr) || nr, "transitive");
+    }
+
+    void test_empty_first()
+    {
+        const ordered_any empty, number = 0, text = std::string();
+
+        check_true(empty < number && empty < text, "empty is the smallest");
+        check_true(!(number < empty), "not after");
+    }
+
+    void test_copy_and_move()
+    {
+        ordered_any one = 1;
+        const ordered_any two = 2;
+
+        ordered_any copy = one;
+        check_true(copy == one && copy < two, "copy");
+
+        ordered_any moved = static_cast<ordered_any&&>(copy);
+        check_true(moved == one && moved < two, "moved");
+        check_true(copy.empty() && copy < one, "moved from is empty");
+
+        copy = std::string("text");
+        moved.swap(copy);
+        check_equal(any_cast<std::string>(moved), "text", "swap");
+        check_true(copy == one, "swapped back");
+
+        one.clear();
+        check_true(one.empty() && one == ordered_any(), "clear");
+    }
+
+    void test_sort()
+    {
+        std::vector<ordered_any> values;
+        for (int i = 0; i < 100; ++i)
+        {
+            values.push_back((i * 37) % 50);
+            values.push_back(std::string(1, static_cast<char>('a' + (i * 7) % 26)));
+            values.push_back(static_cast<double>((i * 13) % 20) / 2);
+        }
+        values.push_back(ordered_any());
+
+        std::sort(values.begin(), values.end(), any_less());
+
+        check_true(values.front().empty(), "empty first");
+        std::size_t type_changes = 0;
+        bool sorted = true;
+        for (std::size_t i = 2; i < values.size(); ++i)
+        {
+            if (boost::typeindex::type_index(values[i].type()) != boost::typeindex::type_index(values[i - 1].type()))
+                ++type_changes;
+            sorted = sorted && !(values[i] < values[i - 1]);
+        }
+        check_equal(type_changes, 2u, "values of a type are together");
+        check_true(sorted, "sorted");
+    }
+
+    void test_set()
+    {
+        std::set<ordered_any> keys;
+        keys.insert(1);
+        keys.insert(std::string("one"));
+        keys.insert(1);
+        keys.insert(1.0);
+        keys.insert(std::string("one"));
+
+        check_equal(keys.size(), 3u, "duplicates are not inserted");
+        check_equal(keys.count(1), 1u, "int");
+        check_equal(keys.count(std::string("one")), 1u, "std::string");
+        check_equal(keys.count(2), 0u, "missing int");
+        check_equal(keys.count(1.5), 0u, "missing double");
+    }
+
+    void test_binary_search()
+    {
+        std::vector<ordered_any> values;
+        for (int i = 0; i < 20; ++i)
+        {
+            values.push_back(i * 2);
+            values.push_back(std::string(1, static_cast<char>('a' + i)));
+        }
+        std::sort(values.begin(), values.end());
+
+        check_true(std::binary_search(values.begin(), values.end(), ordered_any(10)), "even int");
+        check_false(std::binary_search(values.begin(), values.end(), ordered_any(11)), "odd int");
+        check_true(std::binary_search(values.begin(), values.end(), ordered_any(std::string("c")), any_less()), "string");
+
+        const std::vector<ordered_any>::const_iterator it
+            = std::lower_bound(values.begin(), values.end(), ordered_any(7));
+        check_equal(any_cast<int>(*it), 8, "lower_bound");
+    }
+
+    void test_any_cast()
+    {
+        ordered_any value = 42;
+        const ordered_any & constant = value;
+
+        check_equal(any_cast<int>(value), 42, "by value");
+        check_equal(*any_cast<int>(&constant), 42, "const pointer");
+        any_cast<int&>(value) = 7;
+        check_equal(any_cast<const int&>(constant), 7, "reference");
+        check_null(any_cast<double>(&value), "wrong type");
+        check_null(any_cast<int>(static_cast<ordered_any *>(0)), "null");
+        check_equal(any_cast<int>(value.get()), 7, "held any");
+
+        TEST_CHECK_THROW(
+            any_cast<std::string>(value),
+            bad_any_cast,
+            "any_cast to a wrong type");
+    }
+}
+
+#endif
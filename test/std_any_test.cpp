@@ -0,0 +1,246 @@
+//  Unit test for boost::anys::to_std_any and boost::anys::from_std_any.
+//
+//  See http://www.boost.org for most recent version, including documentation.
+//
+//  Copyright Antony Polukhin, 2013-2021.
+//
+//  Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt).
+
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/config.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_NO_CXX17_HDR_ANY) || defined(BOOST_NO_CXX17_HDR_VARIANT) \
+    || defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+int main()
+{
+    return EXIT_SUCCESS;
+}
+
+#else
+
+#include <boost/any/std_any.hpp>
+
+namespace any_tests
+{
+    typedef test<const char *, void (*)()> test_case;
+    typedef const test_case * test_case_iterator;
+
+    extern const test_case_iterator begin, end;
+}
+
+int main()
+{
+    using namespace any_tests;
+    tester<test_case_iterator> test_suite(begin, end);
+    return test_suite() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace any_tests // test suite
+{
+    void test_empty();
+    void test_to_std_any();
+    void test_from_std_any();
+    void test_buffers_are_kept();
+    void test_no_copies();
+    void test_unlisted_type();
+    void test_round_trip();
+    void test_static_storage();
+
+    const test_case test_cases[] =
+    {
+        { "empty any",                            test_empty            },
+        { "boost::any to std::any",               test_to_std_any       },
+        { "std::any to boost::any",               test_from_std_any     },
+        { "buffers are moved",                    test_buffers_are_kept },
+        { "values are never copied",              test_no_copies        },
+        { "type not in the list",                 test_unlisted_type    },
+        { "round trip",                           test_round_trip       },
+        { "static storage is copied",             test_static_storage   }
+    };
+
+    const test_case_iterator begin = test_cases;
+    const test_case_iterator end =
+        test_cases + (sizeof test_cases / sizeof *test_cases);
+
+    // Counts its copies and moves. Too large to be stored in std::any
+    // itself, where moving the std::any would move it as well.
+    struct counted
+    {
+        counted() BOOST_NOEXCEPT
+          : value(0)
+        {
+        }
+
+        counted(const counted & other) BOOST_NOEXCEPT
+          : value(other.value)
+        {
+            ++copies;
+        }
+
+        counted(counted&& other) BOOST_NOEXCEPT
+          : value(other.value)
+        {
+            ++moves;
+        }
+
+        counted & operator=(const counted & other) BOOST_NOEXCEPT
+        {
+            value = other.value;
+            ++copies;
+            return *this;
+        }
+
+        int value;
+        int padding[8];
+
+        static unsigned long copies, moves;
+    };
+
+    unsigned long counted::copies = 0;
+    unsigned long counted::moves = 0;
+}
+
+namespace any_tests // test definitions
+{
+    using namespace boost;
+
+    void test_empty()
+    {
+        any empty;
+        const std::any converted = to_std_any<int>(static_cast<any&&>(empty));
+        check_false(converted.has_value(), "to_std_any of an empty any");
+
+        std::any std_empty;
+        const any back = from_std_any<int>(std::move(std_empty));
+        check_true(back.empty(), "from_std_any of an empty std::any");
+    }
+
+    void test_to_std_any()
+    {
+        any value = std::string("text");
+        const std::any converted = to_std_any<int, std::string>(static_cast<any&&>(value));
+
+        check_true(value.empty(), "source is emptied");
+        check_non_null(std::any_cast<std::string>(&converted), "std::any holds the type");
+        check_equal(*std::any_cast<std::string>(&converted), "text", "value");
+
+        any number = 42;
+        check_equal(std::any_cast<int>(to_std_any<std::string, int>(static_cast<any&&>(number))), 42, "int");
+    }
+
+    void test_from_std_any()
+    {
+        std::any value = std::string("text");
+        const any converted = from_std_any<int, std::string>(std::move(value));
+
+        check_false(value.has_value(), "source is emptied");
+        check_equal(any_cast<std::string>(converted), "text", "value");
+
+        std::any number = 42;
+        check_equal(any_cast<int>(from_std_any<std::string, int>(std::move(number))), 42, "second listed type");
+    }
+
+    void test_buffers_are_kept()
+    {
+        any text = std::string(1000, 'x');
+        const char * const text_buffer = any_cast<std::string&>(text).data();
+        std::any std_text = to_std_any<std::string>(static_cast<any&&>(text));
+        check_equal(static_cast<const void *>(std::any_cast<std::string&>(std_text).data()),
+            static_cast<const void *>(text_buffer), "std::string to std::any");
+
+        const any back_text = from_std_any<std::string>(std::move(std_text));
+        check_equal(static_cast<const void *>(any_cast<const std::string&>(back_text).data()),
+            static_cast<const void *>(text_buffer), "std::string to boost::any");
+
+        any numbers = std::vector<int>(1000, 1);
+        const int * const numbers_buffer = any_cast<std::vector<int>&>(numbers).data();
+        std::any std_numbers = to_std_any<std::string, std::vector<int> >(static_cast<any&&>(numbers));
+        check_equal(std::any_cast<std::vector<int>&>(std_numbers).data(), numbers_buffer, "std::vector to std::any");
+
+        const any back_numbers = from_std_any<std::string, std::vector<int> >(std::move(std_numbers));
+        check_equal(any_cast<const std::vector<int>&>(back_numbers).data(), numbers_buffer, "std::vector to boost::any");
+    }
+
+    void test_no_copies()
+    {
+        any value = counted();
+        const unsigned long copies = counted::copies, moves = counted::moves;
+
+        std::any converted = to_std_any<counted>(static_cast<any&&>(value));
+        const unsigned long to_copies = counted::copies - copies, to_moves = counted::moves - moves;
+        check_equal(to_copies, 0ul, "to_std_any: copies");
+        check_equal(to_moves, 1ul, "to_std_any: moves");
+
+        const any back = from_std_any<counted>(std::move(converted));
+        const unsigned long from_copies = counted::copies - copies, from_moves = counted::moves - moves;
+        check_equal(from_copies, 0ul, "from_std_any: copies");
+        check_equal(from_moves, 2ul, "from_std_any: moves");
+        check_non_null(any_cast<counted>(&back), "type");
+    }
+
+    void test_unlisted_type()
+    {
+        std::any value = 1.5;
+        TEST_CHECK_THROW(
+            (from_std_any<int, std::string>(std::move(value))),
+            bad_any_cast,
+            "from_std_any of a type that is not listed");
+        check_true(value.has_value(), "source is kept");
+        check_equal(std::any_cast<double>(value), 1.5, "value is kept");
+
+        std::any none = 1;
+        TEST_CHECK_THROW(
+            from_std_any<>(std::move(none)),
+            bad_any_cast,
+            "from_std_any with no types");
+
+        any boost_value = 1.5;
+        TEST_CHECK_THROW(
+            (to_std_any<int, std::string>(static_cast<any&&>(boost_value))),
+            bad_any_cast,
+            "to_std_any of a type that is not listed");
+        check_equal(any_cast<double>(boost_value), 1.5, "boost::any is kept");
+    }
+
+    void test_round_trip()
+    {
+        any value = std::vector<std::string>(3, "item");
+        const any back = from_std_any<std::vector<std::string> >(to_std_any<std::vector<std::string> >(static_cast<any&&>(value)));
+        check_equal(any_cast<const std::vector<std::string>&>(back).size(), 3u, "size");
+        check_equal(any_cast<const std::vector<std::string>&>(back)[2], "item", "element");
+    }
+
+    void test_static_storage()
+    {
+        static any::static_storage<std::string> storage(std::string(100, 'x'));
+
+        any first(storage);
+        const std::any converted = to_std_any<std::string>(static_cast<any&&>(first));
+        check_true(first.empty(), "source is emptied");
+        check_equal(std::any_cast<const std::string&>(converted), std::string(100, 'x'), "first conversion");
+
+        any second(storage);
+        const std::any again = to_std_any<std::string>(static_cast<any&&>(second));
+        check_equal(std::any_cast<const std::string&>(again), std::string(100, 'x'), "second conversion");
+
+        const any shared(storage);
+        check_equal(any_cast<const std::string&>(shared), std::string(100, 'x'), "static value is kept");
+
+        static any::static_storage<counted> counted_storage((counted()));
+        any value(counted_storage);
+        const unsigned long copies = counted::copies, moves = counted::moves;
+        const std::any copied = to_std_any<counted>(static_cast<any&&>(value));
+        check_equal(counted::copies - copies, 1ul, "copies");
+        check_equal(counted::moves - moves, 0ul, "moves");
+    }
+}
+
+#endif